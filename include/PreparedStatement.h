@@ -25,6 +25,7 @@
 #include "ParameterMetaData.h"
 
 #include "Statement.h"
+#include "Exception.h"
 
 namespace sql
 {
@@ -45,6 +46,7 @@ public:
   virtual ResultSet* executeQuery()=0;
   virtual ResultSet* executeQuery(const SQLString& sql)=0;
   virtual void clearParameters()=0;
+  using Statement::addBatch;
   virtual void setNull(int32_t parameterIndex,int32_t sqlType)=0;
   virtual void setNull(int32_t parameterIndex,int32_t sqlType,const SQLString& typeName)=0;
 
@@ -67,6 +69,18 @@ public:
   virtual void setBlob(int32_t parameterIndex, std::istream* inputStream)=0;
   virtual void setDateTime(int32_t parameterIndex, const SQLString& dt)=0;
 
+  /* Setting values of the parameter for all rows of the batch at once. Arrays are not copied, and have to stay valid
+     until executeBatch(). All parameters have to be set this way. NULL values are marked in nulls array, if it is not
+     NULL, or by nullptr values for strings */
+  virtual void setIntArray(int32_t parameterIndex, const int32_t* values, std::size_t rowCount, const bool* nulls)=0;
+  virtual void setInt64Array(int32_t parameterIndex, const int64_t* values, std::size_t rowCount, const bool* nulls)=0;
+  virtual void setDoubleArray(int32_t parameterIndex, const double* values, std::size_t rowCount, const bool* nulls)=0;
+  virtual void setStringArray(int32_t parameterIndex, const char* const* values, const std::size_t* lengths, std::size_t rowCount)=0;
+
+  /* Declared last, so that older methods keep their vtable slots, and not pure virtual, so that existing
+     subclasses still build */
+  virtual void addBatch() { throw SQLFeatureNotImplementedException("addBatch() is not implemented"); }
+
 #ifdef MAKES_SENSE_TO_ADD_TO_EASE_SETTING_NULL_AND_COPY_JDBC_BEHAVIOR
   virtual void setBoolean(int32_t parameterIndex, bool *value)=0;
   virtual void setByte(int32_t parameterIndex, int8_t* bit)=0;
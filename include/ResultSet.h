@@ -22,6 +22,7 @@
 #define _RESULTSET_H_
 
 #include <istream>
+#include <vector>
 
 #include "SQLString.h"
 #include "Warning.h"
@@ -32,6 +33,52 @@ namespace sql
 class ResultSetMetaData;
 class Statement;
 
+/**
+  * Column-wise container for the block of rows, filled by ResultSet::fetchColumns().
+  * Integer columns (including BIT and YEAR) go to the "longs" vector, unsigned BIGINT values stored bit-wise,
+  * FLOAT and DOUBLE columns go to "doubles", all other columns are stored in the "data" arena in their text form -
+  * value of the row i takes bytes [offsets[i], offsets[i+1]). Bit i of "nulls" is set if value in row i is NULL.
+  * The object can be reused for consecutive calls, that preserves allocated memory.
+  */
+class ColumnBatch
+{
+public:
+  enum ColumnKind {
+    INT64= 0,
+    DOUBLE,
+    STRING
+  };
+
+  struct Column
+  {
+    ColumnKind kind;
+    bool isUnsigned;
+    std::vector<int64_t> longs;
+    std::vector<double> doubles;
+    std::vector<std::size_t> offsets;
+    std::vector<char> data;
+    std::vector<uint8_t> nulls;
+
+    Column() : kind(STRING), isUnsigned(false) {}
+
+    bool isNull(std::size_t row) const
+    {
+      return (nulls[row >> 3] & (1 << (row & 7))) != 0;
+    }
+
+    const char* getString(std::size_t row, std::size_t& len) const
+    {
+      len= offsets[row + 1] - offsets[row];
+      return data.data() + offsets[row];
+    }
+  };
+
+  std::vector<Column> columns;
+  std::size_t rows;
+
+  ColumnBatch() : rows(0) {}
+};
+
 class MARIADB_EXPORTED ResultSet {
 
   ResultSet(const ResultSet &);
@@ -91,6 +138,12 @@ public:
   virtual bool isNull(const SQLString& columnLabel)=0;
   virtual SQLString getString(int32_t columnIndex)=0;
   virtual SQLString getString(const SQLString& columnLabel)=0;
+  /* Borrowed pointer to the column value, valid until the cursor is moved. Returns NULL for SQL NULL value */
+  virtual const char* getStringView(int32_t columnIndex, std::size_t& length)=0;
+  virtual const char* getStringView(const SQLString& columnLabel, std::size_t& length)=0;
+  /* Appends the column value to the buffer. Returns the number of bytes appended */
+  virtual std::size_t getString(int32_t columnIndex, SQLString& buffer)=0;
+  virtual std::size_t getString(const SQLString& columnLabel, SQLString& buffer)=0;
   virtual int32_t getInt(int32_t columnIndex)=0;
   virtual int32_t getInt(const SQLString& columnLabel)=0;
   virtual uint32_t getUInt(int32_t columnIndex)=0;
@@ -192,6 +245,8 @@ public:
   virtual void refreshRow()=0;
 
   virtual std::size_t rowsCount()=0;
+  /* Reads up to maxRows next rows into the batch. The cursor stays on the last row read. Returns the number of rows read */
+  virtual std::size_t fetchColumns(ColumnBatch& batch, std::size_t maxRows)=0;
 
 #ifdef RS_UPDATE_FUNCTIONALITY_IMPLEMENTED
 
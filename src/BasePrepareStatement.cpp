@@ -24,6 +24,7 @@
 
 #include "MariaDbStatement.h"
 #include "MariaDbConnection.h"
+#include "ExceptionFactory.h"
 
 namespace sql
 {
@@ -641,7 +642,14 @@ namespace mariadb
    */
   void BasePrepareStatement::setNull(int32_t parameterIndex,int32_t sqlType)
   {
-    setParameter(parameterIndex,new NullParameter());
+    ParameterSlot* slot= getParameterSlot(parameterIndex);
+
+    if (slot != nullptr) {
+      slot->setNull(ColumnType::_NULL);
+    }
+    else {
+      setParameter(parameterIndex,new NullParameter());
+    }
   }
 
   /**
@@ -657,7 +665,14 @@ namespace mariadb
    */
   void BasePrepareStatement::setNull(int32_t parameterIndex,const ColumnType& mariadbType)
   {
-    setParameter(parameterIndex,new NullParameter(mariadbType));
+    ParameterSlot* slot= getParameterSlot(parameterIndex);
+
+    if (slot != nullptr) {
+      slot->setNull(mariadbType);
+    }
+    else {
+      setParameter(parameterIndex,new NullParameter(mariadbType));
+    }
   }
 
   /**
@@ -685,7 +700,14 @@ namespace mariadb
    */
   void BasePrepareStatement::setNull(int32_t parameterIndex,int32_t sqlType,const SQLString& typeName)
   {
-    setParameter(parameterIndex,new NullParameter());
+    ParameterSlot* slot= getParameterSlot(parameterIndex);
+
+    if (slot != nullptr) {
+      slot->setNull(ColumnType::_NULL);
+    }
+    else {
+      setParameter(parameterIndex,new NullParameter());
+    }
   }
 
 #ifdef JDBC_SPECIFIC_TYPES_IMPLEMENTED
@@ -1272,7 +1294,14 @@ namespace mariadb
    */
   void BasePrepareStatement::setBoolean(int32_t parameterIndex, bool value)
   {
-    setParameter(parameterIndex,new BooleanParameter(value));
+    ParameterSlot* slot= getParameterSlot(parameterIndex);
+
+    if (slot != nullptr) {
+      slot->setBoolean(value);
+    }
+    else {
+      setParameter(parameterIndex,new BooleanParameter(value));
+    }
   }
 
   /**
@@ -1287,7 +1316,14 @@ namespace mariadb
    */
   void BasePrepareStatement::setByte(int32_t parameterIndex, int8_t bit)
   {
-    setParameter(parameterIndex,new ByteParameter(bit));
+    ParameterSlot* slot= getParameterSlot(parameterIndex);
+
+    if (slot != nullptr) {
+      slot->setByte(bit);
+    }
+    else {
+      setParameter(parameterIndex,new ByteParameter(bit));
+    }
   }
 
   /**
@@ -1302,7 +1338,14 @@ namespace mariadb
    */
   void BasePrepareStatement::setShort(int32_t parameterIndex,const int16_t value)
   {
-    setParameter(parameterIndex,new ShortParameter(value));
+    ParameterSlot* slot= getParameterSlot(parameterIndex);
+
+    if (slot != nullptr) {
+      slot->setShort(value);
+    }
+    else {
+      setParameter(parameterIndex,new ShortParameter(value));
+    }
   }
 
   /**
@@ -1321,7 +1364,14 @@ namespace mariadb
       return;
     }*/
 
-    setParameter(parameterIndex,new StringParameter(str, noBackslashEscapes));
+    ParameterSlot* slot= getParameterSlot(parameterIndex);
+
+    if (slot != nullptr) {
+      slot->setString(str, noBackslashEscapes);
+    }
+    else {
+      setParameter(parameterIndex,new StringParameter(str, noBackslashEscapes));
+    }
   }
 
   /**
@@ -1348,7 +1398,14 @@ namespace mariadb
 
   void BasePrepareStatement::setInt(int32_t column, int32_t value)
   {
-    setParameter(column,new IntParameter(value));
+    ParameterSlot* slot= getParameterSlot(column);
+
+    if (slot != nullptr) {
+      slot->setInt(value);
+    }
+    else {
+      setParameter(column,new IntParameter(value));
+    }
   }
 
   /**
@@ -1362,17 +1419,38 @@ namespace mariadb
    *     PreparedStatement</code>
    */
   void BasePrepareStatement::setLong(int32_t parameterIndex, int64_t value) {
-    setParameter(parameterIndex, new LongParameter(value));
+    ParameterSlot* slot= getParameterSlot(parameterIndex);
+
+    if (slot != nullptr) {
+      slot->setLong(value);
+    }
+    else {
+      setParameter(parameterIndex, new LongParameter(value));
+    }
   }
 
 
   void BasePrepareStatement::setUInt64(int32_t parameterIndex, uint64_t value) {
-    setParameter(parameterIndex, new ULongParameter(value));
+    ParameterSlot* slot= getParameterSlot(parameterIndex);
+
+    if (slot != nullptr) {
+      slot->setULong(value);
+    }
+    else {
+      setParameter(parameterIndex, new ULongParameter(value));
+    }
   }
 
 
   void BasePrepareStatement::setUInt(int32_t parameterIndex, uint32_t value) {
-    setParameter(parameterIndex, new ULongParameter(value));
+    ParameterSlot* slot= getParameterSlot(parameterIndex);
+
+    if (slot != nullptr) {
+      slot->setULong(value);
+    }
+    else {
+      setParameter(parameterIndex, new ULongParameter(value));
+    }
   }
 
 
@@ -1385,6 +1463,33 @@ namespace mariadb
     setParameter(parameterIndex, new StringParameter(str, noBackslashEscapes));
   }
 
+  /**
+   * Sets values of the parameter for all rows of the batch. Supported by server side prepared statements only.
+   */
+  void BasePrepareStatement::setIntArray(int32_t /*parameterIndex*/, const int32_t* /*values*/, std::size_t /*rowCount*/, const bool* /*nulls*/)
+  {
+    throw exceptionFactory->notSupported("Array parameters are supported by server side prepared statements only");
+  }
+
+
+  void BasePrepareStatement::setInt64Array(int32_t /*parameterIndex*/, const int64_t* /*values*/, std::size_t /*rowCount*/, const bool* /*nulls*/)
+  {
+    throw exceptionFactory->notSupported("Array parameters are supported by server side prepared statements only");
+  }
+
+
+  void BasePrepareStatement::setDoubleArray(int32_t /*parameterIndex*/, const double* /*values*/, std::size_t /*rowCount*/, const bool* /*nulls*/)
+  {
+    throw exceptionFactory->notSupported("Array parameters are supported by server side prepared statements only");
+  }
+
+
+  void BasePrepareStatement::setStringArray(int32_t /*parameterIndex*/, const char* const* /*values*/, const std::size_t* /*lengths*/,
+    std::size_t /*rowCount*/)
+  {
+    throw exceptionFactory->notSupported("Array parameters are supported by server side prepared statements only");
+  }
+
   /**
    * Sets the designated parameter to the given Java <code>float</code> value. The driver converts
    * this to an SQL <code>REAL</code> value when it sends it to the database.
@@ -1397,7 +1502,14 @@ namespace mariadb
    */
   void BasePrepareStatement::setFloat(int32_t parameterIndex, float value)
   {
-    setParameter(parameterIndex,new FloatParameter(value));
+    ParameterSlot* slot= getParameterSlot(parameterIndex);
+
+    if (slot != nullptr) {
+      slot->setFloat(value);
+    }
+    else {
+      setParameter(parameterIndex,new FloatParameter(value));
+    }
   }
 
   /**
@@ -1412,7 +1524,14 @@ namespace mariadb
    */
   void BasePrepareStatement::setDouble(int32_t parameterIndex, double value)
   {
-    setParameter(parameterIndex,new DoubleParameter(value));
+    ParameterSlot* slot= getParameterSlot(parameterIndex);
+
+    if (slot != nullptr) {
+      slot->setDouble(value);
+    }
+    else {
+      setParameter(parameterIndex,new DoubleParameter(value));
+    }
   }
 
 
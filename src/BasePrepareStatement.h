@@ -27,6 +27,7 @@
 
 #include "ColumnType.h"
 #include "parameters/ParameterHolder.h"
+#include "parameters/ParameterSlot.h"
 
 #include "MariaDbStatement.h"
 
@@ -95,6 +96,11 @@ public:
   */
   virtual ParameterMetaData* getParameterMetaData()=0;
   virtual void setParameter(int32_t parameterIndex, ParameterHolder* holder)=0;
+  /**
+   * Returns slot, where the value of the parameter may be stored without allocation of the holder, or nullptr if
+   * the statement does not keep values in slots, or the index is not valid.
+   */
+  virtual ParameterSlot* getParameterSlot(int32_t /*parameterIndex*/) { return nullptr; }
 
 #ifdef MAYBE_IN_BETA
   void setBlob(int32_t parameterIndex, Blob* blob);
@@ -164,6 +170,10 @@ public:
   void setDouble(int32_t parameterIndex, double value);
   void setDateTime(int32_t parameterIndex, const SQLString& dt);
   void setBigInt(int32_t column, const SQLString& value);
+  void setIntArray(int32_t parameterIndex, const int32_t* values, std::size_t rowCount, const bool* nulls);
+  void setInt64Array(int32_t parameterIndex, const int64_t* values, std::size_t rowCount, const bool* nulls);
+  void setDoubleArray(int32_t parameterIndex, const double* values, std::size_t rowCount, const bool* nulls);
+  void setStringArray(int32_t parameterIndex, const char* const* values, const std::size_t* lengths, std::size_t rowCount);
 
   /* Forwarding to stmt to implement Statement's part of interface */
   int32_t executeUpdate();
@@ -20,6 +20,7 @@
 
 #include "ClientSidePreparedStatement.h"
 #include "logger/LoggerFactory.h"
+#include "cache/ClientPrepareResultCache.h"
 //#include "BasePrepareStatement.h"
 
 namespace sql
@@ -49,10 +50,10 @@ namespace mariadb
       sqlQuery(sql)
   {
     if (options->rewriteBatchedStatements) {
-      prepareResult= ClientPrepareResult::rewritableParts(sqlQuery, protocol.noBackslashEscapes());
+      prepareResult= ClientPrepareResultCache::getInstance().rewritableParts(sqlQuery, protocol.noBackslashEscapes());
     }
     else {
-      prepareResult= ClientPrepareResult::parameterParts(sqlQuery, protocol.noBackslashEscapes());
+      prepareResult= ClientPrepareResultCache::getInstance().parameterParts(sqlQuery, protocol.noBackslashEscapes());
     }
     parameters= new ParameterHolder[prepareResult.getParamCount()];
   }
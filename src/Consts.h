@@ -270,6 +270,7 @@ namespace mariadb
   class MariaDbResultSetMetaData;
   class CallableParameterMetaData;
   class ColumnDefinition;
+  class ColumnNameMap;
   class Credential;
   class ParameterHolder;
   class RowProtocol;
@@ -340,6 +341,7 @@ namespace mariadb
     typedef std::shared_ptr<sql::mariadb::MariaDbParameterMetaData> MariaDbParameterMetaData;
     typedef std::shared_ptr<sql::mariadb::CallableParameterMetaData> CallableParameterMetaData;
     typedef std::shared_ptr<sql::mariadb::ColumnDefinition> ColumnDefinition;
+    typedef std::shared_ptr<sql::mariadb::ColumnNameMap> ColumnNameMap;
     typedef std::shared_ptr<sql::mariadb::ParameterHolder> ParameterHolder;
     typedef std::shared_ptr<sql::mariadb::SelectResultSet> SelectResultSet;
     typedef std::shared_ptr<sql::mariadb::ExceptionFactory> ExceptionFactory;
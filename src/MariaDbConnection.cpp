@@ -30,6 +30,9 @@
 #include "logger/LoggerFactory.h"
 #include "pool/Pools.h"
 #include "util/Utils.h"
+#include "util/ServerPrepareStatementCache.h"
+#include "util/SqlClassification.h"
+#include "cache/ClientPrepareResultCache.h"
 #include "jdbccompat.h"
 #include "ExceptionFactory.h"
 
@@ -38,18 +41,6 @@ namespace sql
 namespace mariadb
 {
   Shared::Logger MariaDbConnection::logger= LoggerFactory::getLogger(typeid(MariaDbConnection));
-  /**
-    * Pattern to check the correctness of callable statement query string Legal queries, as
-    * documented in JDK have the form: {[?=]call[(arg1,..,,argn)]}
-    */
-  std::regex MariaDbConnection::CALLABLE_STATEMENT_PATTERN(
-    "^(\\s*\\{)?\\s*((\\?\\s*=)?(\\s*\\/\\*([^\\*]|\\*[^\\/])*\\*\\/)*\\s*"
-    "call(\\s*\\/\\*([^\\*]|\\*[^\\/])*\\*\\/)*\\s*((((`[^`]+`)|([^`\\}]+))\\.)?"
-    "((`[^`]+`)|([^`\\}\\(]+)))\\s*(\\(.*\\))?(\\s*\\/\\*([^\\*]|\\*[^\\/])*\\*\\/)*"
-    "\\s*(#.*)?)\\s*(\\}\\s*)?$", std::regex_constants::ECMAScript | std::regex_constants::icase);
-  /** Check that query can be executed with PREPARE. */
-  std::regex MariaDbConnection::PREPARABLE_STATEMENT_PATTERN(
-    "^(\\s*\\/\\*([^\\*]|\\*[^\\/])*\\*\\/)*\\s*(SELECT|UPDATE|INSERT|DELETE|REPLACE|DO|CALL)", std::regex_constants::ECMAScript | std::regex_constants::icase);
   /**
     * Creates a new connection with a given protocol and query factory.
     *
@@ -57,13 +48,17 @@ namespace mariadb
     */
   MariaDbConnection::MariaDbConnection(Shared::Protocol& _protocol) :
     protocol(_protocol),
-    lock(_protocol->getLock()),
     options(protocol->getOptions()),
+    exceptionFactory(ExceptionFactory::of(this->getServerThreadId(), options)),
+    lock(_protocol->getLock()),
+    pooledConnection(nullptr),
+    nullCatalogMeansCurrent(options->nullCatalogMeansCurrent),
     _canUseServerTimeout(protocol->versionGreaterOrEqual(10, 1, 2)),
     sessionStateAware(protocol->sessionStateAware()),
-    nullCatalogMeansCurrent(options->nullCatalogMeansCurrent),
+    stateFlag(0),
+    defaultTransactionIsolation(0),
     savepointCount(0),
-    exceptionFactory(ExceptionFactory::of(this->getServerThreadId(), options))
+    returnedToPool(false)
   {
     if (options->cacheCallableStmts)
     {
@@ -71,6 +66,23 @@ namespace mariadb
     }
   }
 
+
+  MariaDbConnection::~MariaDbConnection()
+  {
+    // Pooled connection handle that application did not close. The connection still has to go back to the pool
+    if (pooledConnection != nullptr)
+    {
+      try
+      {
+        close();
+      }
+      catch (std::exception&)
+      {
+        // eat
+      }
+    }
+  }
+
   /**
     * Create new connection Object.
     *
@@ -83,7 +95,9 @@ namespace mariadb
   {
     if (urlParser.getOptions()->pool)
     {
-      //return Pools::retrievePool(urlParser)->getConnection();
+      // Pool takes ownership of the parser, same as protocol would do
+      std::shared_ptr<UrlParser> shUrlParser(&urlParser);
+      return Pools::retrievePool(shUrlParser)->getConnection();
     }
     Shared::Protocol protocol(Utils::retrieveProxy(urlParser, globalInfo));
 
@@ -162,7 +176,7 @@ namespace mariadb
 
   void MariaDbConnection::checkConnection()
   {
-    if (protocol->isExplicitClosed()) {
+    if (returnedToPool || protocol->isExplicitClosed()) {
       throw *exceptionFactory->create("createStatement() is called on closed connection", "08000");
     }
     if (protocol->isClosed() && protocol->getProxy())
@@ -406,9 +420,16 @@ namespace mariadb
   {
     if (!sql.empty())
     {
-      SQLString sqlQuery= Utils::nativeSql(sql, protocol.get());
+      SqlClassification classification(sql, protocol->noBackslashEscapes());
+      SQLString sqlQuery(sql);
+
+      // Escape sequences are rare, and only then the query has to be rewritten and classified again
+      if (classification.hasEscapeSequence()) {
+        sqlQuery= Utils::nativeSql(sql, protocol.get());
+        classification= SqlClassification(sqlQuery, protocol->noBackslashEscapes());
+      }
 
-      if (options->useServerPrepStmts && std::regex_search(StringImp::get(sqlQuery), PREPARABLE_STATEMENT_PATTERN))
+      if (options->useServerPrepStmts && classification.isPreparable())
       {
         checkConnection();
         try {
@@ -469,23 +490,27 @@ namespace mariadb
   CallableStatement* MariaDbConnection::prepareCall(const SQLString& sql, int32_t resultSetType, int32_t resultSetConcurrency)
   {
     checkConnection();
-    std::smatch matcher;
+    SqlClassification::CallableParts parts;
 
-    if (!std::regex_search(StringImp::get(sql), matcher, CALLABLE_STATEMENT_PATTERN))
+    if (!SqlClassification::parseCallable(sql, protocol->noBackslashEscapes(), parts))
     {
       throw SQLSyntaxErrorException(
         "invalid callable syntax. must be like {[?=]call <procedure/function name>[(?,?, ...)]}\n but was : "
         +sql);
     }
 
-    SQLString query= Utils::nativeSql(matcher[2].str(), protocol.get());
+    SQLString query(parts.query);
+
+    if (SqlClassification(query, protocol->noBackslashEscapes()).hasEscapeSequence()) {
+      query= Utils::nativeSql(query, protocol.get());
+    }
 
-    bool isFunction= !matcher[3].str().empty();
+    bool isFunction= parts.isFunction;
 
-    SQLString databaseAndProcedure(matcher[8].str());
-    SQLString database(matcher[10].str());
-    SQLString procedureName(matcher[13].str());
-    SQLString arguments(matcher[16].str());
+    SQLString& databaseAndProcedure= parts.databaseAndProcedure;
+    SQLString& database= parts.database;
+    SQLString& procedureName= parts.procedureName;
+    SQLString& arguments= parts.arguments;
 
     if (database.empty() && sessionStateAware)
     {
@@ -702,8 +727,23 @@ namespace mariadb
   {
     if (pooledConnection)
     {
-      rollback();
-      pooledConnection->fireConnectionClosed();
+      MariaDbPooledConnection* item= pooledConnection;
+      pooledConnection= nullptr;
+      returnedToPool= true;
+      // Connection goes back to the pool in the state it was after connect, but the socket stays open
+      try
+      {
+        reset();
+      }
+      catch (SQLException&)
+      {
+        item->fireConnectionErrorOccured(SQLException("Error resetting connection"));
+      }
+      item->fireConnectionClosed();
+      return;
+    }
+    if (returnedToPool)
+    {
       return;
     }
     protocol->closeExplicit();
@@ -716,7 +756,7 @@ namespace mariadb
     */
   bool MariaDbConnection::isClosed()
   {
-    return protocol->isClosed();
+    return returnedToPool || protocol->isClosed();
   }
 
   /**
@@ -1050,9 +1090,143 @@ namespace mariadb
   }
   
 
+  /**
+    * Returns the value of the connection's statistic. Supported are counters of the prepared statements cache:
+    * "prepStmtCacheHits", "prepStmtCacheMisses", "prepStmtCacheEvictions" and "prepStmtCacheEntries" - the current
+    * number of cached statements. If the cache is not enabled, they are all 0. "clientPrepareCacheHits",
+    * "clientPrepareCacheMisses", "clientPrepareCacheEvictions" and "clientPrepareCacheEntries" are the same counters
+    * of the process-wide cache of parsed queries, shared by all connections.
+    * Connections from the pool report the pool's gauges "poolActiveConnections", "poolIdleConnections",
+    * "poolTotalConnections" and "poolConnectionRequests" - threads waiting for a connection, counters
+    * "poolConnectionsCreated", "poolConnectionsFailed", "poolValidationsFailed" and "poolConnectionTimeouts", and
+    * histograms "poolCheckoutWait" (microseconds) and "poolConnectionLifetime" (milliseconds), with one of
+    * suffixes "Count", "Mean", "Max", "P50", "P90", "P99" or "P999", e.g. "poolCheckoutWaitP99". For other
+    * connections they are all 0.
+    *
+    * @param n name of the value
+    * @return value as string
+    */
   SQLString MariaDbConnection::getClientOption(const SQLString& n) {
+    if (n.startsWith("prepStmtCache")) {
+      ServerPrepareStatementCache* cache= protocol->prepareStatementCache();
+      uint64_t value= 0;
+
+      if (n.compare("prepStmtCacheHits") == 0) {
+        value= cache != nullptr ? cache->getHitCount() : 0;
+      }
+      else if (n.compare("prepStmtCacheMisses") == 0) {
+        value= cache != nullptr ? cache->getMissCount() : 0;
+      }
+      else if (n.compare("prepStmtCacheEvictions") == 0) {
+        value= cache != nullptr ? cache->getEvictionCount() : 0;
+      }
+      else if (n.compare("prepStmtCacheEntries") == 0) {
+        value= cache != nullptr ? cache->size() : 0;
+      }
+      else {
+        throw SQLFeatureNotSupportedException("getClientOption is not supported for " + n);
+      }
+      return std::to_string(value);
+    }
+    else if (n.startsWith("clientPrepareCache")) {
+      ClientPrepareResultCache& cache= ClientPrepareResultCache::getInstance();
+      uint64_t value= 0;
+
+      if (n.compare("clientPrepareCacheHits") == 0) {
+        value= cache.getHitCount();
+      }
+      else if (n.compare("clientPrepareCacheMisses") == 0) {
+        value= cache.getMissCount();
+      }
+      else if (n.compare("clientPrepareCacheEvictions") == 0) {
+        value= cache.getEvictionCount();
+      }
+      else if (n.compare("clientPrepareCacheEntries") == 0) {
+        value= cache.size();
+      }
+      else {
+        throw SQLFeatureNotSupportedException("getClientOption is not supported for " + n);
+      }
+      return std::to_string(value);
+    }
+    else if (n.startsWith("pool")) {
+      return std::to_string(getPoolStatistic(n));
+    }
     throw SQLFeatureNotSupportedException("getClientOption is not supported");
   }
+
+  /**
+    * Returns the pool statistic for getClientOption.
+    *
+    * @param n name of the value
+    * @return value, or 0 if the connection is not from a pool
+    */
+  uint64_t MariaDbConnection::getPoolStatistic(const SQLString& n)
+  {
+    static const struct {
+      const char* suffix;
+      double percentile;
+    } percentiles[]= { { "P50", 50.0 }, { "P90", 90.0 }, { "P99", 99.0 }, { "P999", 99.9 } };
+
+    Shared::Pool pool(pooledConnection != nullptr ? pooledConnection->getPool() : Shared::Pool());
+
+    if (n.compare("poolActiveConnections") == 0) {
+      return pool ? pool->getActiveConnections() : 0;
+    }
+    else if (n.compare("poolIdleConnections") == 0) {
+      return pool ? pool->getIdleConnections() : 0;
+    }
+    else if (n.compare("poolTotalConnections") == 0) {
+      return pool ? pool->getTotalConnections() : 0;
+    }
+    else if (n.compare("poolConnectionRequests") == 0) {
+      return pool ? pool->getConnectionRequests() : 0;
+    }
+    else if (n.compare("poolConnectionsCreated") == 0) {
+      return pool ? pool->getConnectionsCreated() : 0;
+    }
+    else if (n.compare("poolConnectionsFailed") == 0) {
+      return pool ? pool->getConnectionsFailed() : 0;
+    }
+    else if (n.compare("poolValidationsFailed") == 0) {
+      return pool ? pool->getValidationsFailed() : 0;
+    }
+    else if (n.compare("poolConnectionTimeouts") == 0) {
+      return pool ? pool->getConnectionTimeouts() : 0;
+    }
+
+    const Histogram* histogram= nullptr;
+    SQLString suffix;
+
+    if (n.startsWith("poolCheckoutWait")) {
+      histogram= pool ? &pool->getCheckoutWaitTime() : nullptr;
+      suffix= n.substr(sizeof("poolCheckoutWait") - 1);
+    }
+    else if (n.startsWith("poolConnectionLifetime")) {
+      histogram= pool ? &pool->getConnectionLifetime() : nullptr;
+      suffix= n.substr(sizeof("poolConnectionLifetime") - 1);
+    }
+    else {
+      throw SQLFeatureNotSupportedException("getClientOption is not supported for " + n);
+    }
+
+    if (suffix.compare("Count") == 0) {
+      return histogram ? histogram->getCount() : 0;
+    }
+    else if (suffix.compare("Mean") == 0) {
+      return histogram ? histogram->getMean() : 0;
+    }
+    else if (suffix.compare("Max") == 0) {
+      return histogram ? histogram->getMax() : 0;
+    }
+    for (auto& it : percentiles) {
+      if (suffix.compare(it.suffix) == 0) {
+        return histogram ? histogram->getValueAtPercentile(it.percentile) : 0;
+      }
+    }
+    throw SQLFeatureNotSupportedException("getClientOption is not supported for " + n);
+  }
+
   /**
     * Constructs an object that implements the <code>Clob</code> interface. The object returned
     * initially contains no data. The <code>setAsciiStream</code>, <code>setCharacterStream</code>
@@ -1662,6 +1836,9 @@ namespace mariadb
     * <p>BUT : - session variable state are reset only if option useResetConnection is set and - if
     * using the option "useServerPrepStmts", PREPARE statement are still prepared
     *
+    * <p>Active transaction is rolled back. COM_RESET_CONNECTION does it by itself, otherwise that is
+    * done before anything else, as changing autocommit would commit the transaction.
+    *
     * @throws SQLException if resetting operation failed
     */
   void MariaDbConnection::reset()
@@ -1672,6 +1849,13 @@ namespace mariadb
         ||(!protocol->isServerMariaDb()&&protocol->versionGreaterOrEqual(5, 7, 3)));
     if (useComReset) {
       protocol->reset();
+      // Server sets session autocommit to the global value, that is not necessarily the one we need
+      if (protocol->getAutocommit() != options->autocommit) {
+        stateFlag|= ConnectionState::STATE_AUTOCOMMIT;
+      }
+    }
+    else {
+      rollback();
     }
     if (stateFlag !=0) {
       try {
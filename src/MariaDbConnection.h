@@ -60,18 +60,6 @@ class MariaDbConnection  : public Connection
 {
     static std::shared_ptr<sql::mariadb::Logger> logger ; /*LoggerFactory.getLogger(MariaDbConnection.class)*/
 
-    static std::regex CALLABLE_STATEMENT_PATTERN ; /*Pattern.compile(
-"^(\\s*\\{)?\\s*((\\?\\s*=)?(\\s*\\/\\*([^\\*]|\\*[^\\/])*\\*\\/)*\\s*"
-+"call(\\s*\\/\\*([^\\*]|\\*[^\\/])*\\*\\/)*\\s*((((`[^`]+`)|([^`\\}]+))\\.)?"
-+"((`[^`]+`)|([^`\\}\\(]+)))\\s*(\\(.*\\))?(\\s*\\/\\*([^\\*]|\\*[^\\/])*\\*\\/)*"
-+"\\s*(#.*)?)\\s*(\\}\\s*)?$",
-Pattern.CASE_INSENSITIVE |Pattern.DOTALL)*/
-
-    static std::regex PREPARABLE_STATEMENT_PATTERN ; /*Pattern.compile(
-"^(\\s*\\/\\*([^\\*]|\\*[^\\/])*\\*\\/)*\\s*(SELECT|UPDATE|INSERT|DELETE|REPLACE|DO|CALL)",
-Pattern.CASE_INSENSITIVE)*/
-
-
     Shared::Protocol protocol;
     Shared::Options options;
 
@@ -81,7 +69,8 @@ Pattern.CASE_INSENSITIVE)*/
 
 public:
   Shared::mutex lock; /* TODO: Public? Really? */
-  std::unique_ptr<MariaDbPooledConnection> pooledConnection;
+  /* Pool connection this handle gives back on close. Not owned */
+  MariaDbPooledConnection* pooledConnection;
 //protected:
   bool nullCatalogMeansCurrent;
 private:
@@ -93,13 +82,15 @@ private:
   int32_t defaultTransactionIsolation ; /*0*/
   int32_t savepointCount; /*0*/
   bool warningsCleared;
+  /* Pooled connection handle has been closed, and the connection it used belongs to the pool again */
+  bool returnedToPool;
 
 public:
   MariaDbConnection(Shared::Protocol& protocol);
   static MariaDbConnection* newConnection(UrlParser& urlParser, GlobalStateInfo* globalInfo);
   static SQLString quoteIdentifier(const SQLString& string);
   static SQLString unquoteIdentifier(SQLString& string);
-  ~MariaDbConnection() {}
+  ~MariaDbConnection();
 //protected:
   Protocol* getProtocol();
 
@@ -110,6 +101,7 @@ public:
 
 private:
   void checkConnection();
+  uint64_t getPoolStatistic(const SQLString& n);
 
 public:
   ClientSidePreparedStatement* clientPrepareStatement(const SQLString& sql);
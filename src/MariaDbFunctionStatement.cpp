@@ -682,6 +682,12 @@ namespace mariadb
   }
 
 
+  void MariaDbFunctionStatement::addBatch()
+  {
+    stmt->addBatch();
+  }
+
+
   void MariaDbFunctionStatement::addBatch(const SQLString& sql)
   {
     stmt->addBatch(sql);
@@ -795,6 +801,27 @@ namespace mariadb
   }
 
 
+  void MariaDbFunctionStatement::setIntArray(int32_t parameterIndex, const int32_t* values, std::size_t rowCount, const bool* nulls) {
+    stmt->setIntArray(parameterIndex, values, rowCount, nulls);
+  }
+
+
+  void MariaDbFunctionStatement::setInt64Array(int32_t parameterIndex, const int64_t* values, std::size_t rowCount, const bool* nulls) {
+    stmt->setInt64Array(parameterIndex, values, rowCount, nulls);
+  }
+
+
+  void MariaDbFunctionStatement::setDoubleArray(int32_t parameterIndex, const double* values, std::size_t rowCount, const bool* nulls) {
+    stmt->setDoubleArray(parameterIndex, values, rowCount, nulls);
+  }
+
+
+  void MariaDbFunctionStatement::setStringArray(int32_t parameterIndex, const char* const* values, const std::size_t* lengths,
+    std::size_t rowCount) {
+    stmt->setStringArray(parameterIndex, values, lengths, rowCount);
+  }
+
+
   void MariaDbFunctionStatement::setNull(const SQLString& parameterName, int32_t sqlType) {
     stmt->setNull(nameToIndex(parameterName), sqlType);
   }
@@ -119,6 +119,7 @@ public:
   int32_t getResultSetType();
   void closeOnCompletion();
   bool isCloseOnCompletion();
+  void addBatch();
   void addBatch(const SQLString& sql);
   void clearBatch();
   void close();
@@ -167,6 +168,10 @@ public:
   void setDouble(int32_t parameterIndex, double value);
   void setDateTime(int32_t parameterIndex, const SQLString& dt);
   void setBigInt(int32_t column, const SQLString& value);
+  void setIntArray(int32_t parameterIndex, const int32_t* values, std::size_t rowCount, const bool* nulls);
+  void setInt64Array(int32_t parameterIndex, const int64_t* values, std::size_t rowCount, const bool* nulls);
+  void setDoubleArray(int32_t parameterIndex, const double* values, std::size_t rowCount, const bool* nulls);
+  void setStringArray(int32_t parameterIndex, const char* const* values, const std::size_t* lengths, std::size_t rowCount);
 
   void setNull(const SQLString& parameterName, int32_t sqlType);
   void setNull(const SQLString& parameterName, int32_t sqlType, const SQLString& typeName);
@@ -21,6 +21,7 @@
 #include <chrono>
 
 #include "MariaDbPooledConnection.h"
+#include "pool/Pool.h"
 
 namespace sql
 {
@@ -30,15 +31,30 @@ namespace mariadb
   /**
     * Constructor.
     *
-    * @param connection connection to retrieve connection options
+    * @param protocol physical connection protocol
+    * @param pool the pool, connection belongs to
     */
-  MariaDbPooledConnection::MariaDbPooledConnection(MariaDbConnection* connection)
-    : connection(connection)
+  MariaDbPooledConnection::MariaDbPooledConnection(Shared::Protocol& _protocol, const std::weak_ptr<Pool>& _pool)
+    : protocol(_protocol)
+    , pool(_pool)
+    , createdAt(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count())
+    , broken(false)
+    , defaultTransactionIsolation(0)
   {
-    connection->pooledConnection.reset(this);
     lastUsedToNow();
   }
 
+
+  MariaDbPooledConnection::~MariaDbPooledConnection()
+  {
+    try {
+      close();
+    }
+    catch (std::exception&) {
+      // eat
+    }
+  }
+
   /**
     * Creates and returns a <code>Connection</code> object that is a handle for the physical
     * connection that this <code>PooledConnection</code> object represents. The connection pool
@@ -51,9 +67,18 @@ namespace mariadb
     */
   MariaDbConnection* MariaDbPooledConnection::getConnection()
   {
+    MariaDbConnection* connection= new MariaDbConnection(protocol);
+    connection->setDefaultTransactionIsolation(defaultTransactionIsolation);
+    connection->pooledConnection= this;
     return connection;
   }
 
+
+  Shared::Protocol& MariaDbPooledConnection::getProtocol()
+  {
+    return protocol;
+  }
+
   /**
     * Closes the physical connection that this <code>PooledConnection</code> object represents. An
     * application never calls this method directly; it is called by the connection pool module, or
@@ -64,20 +89,21 @@ namespace mariadb
     */
   void MariaDbPooledConnection::close()
   {
-    connection->pooledConnection.reset();
-    connection->close();
+    if (!protocol->isClosed()) {
+      protocol->closeExplicit();
+    }
   }
 
   /**
-    * Abort connection.
+    * Abort connection. The connection is closed synchronously, the executor is not used.
     *
     * @param executor executor
     * @throws SQLException if a database access error occurs
     */
-  void MariaDbPooledConnection::abort(sql::Executor* executor)
+  void MariaDbPooledConnection::abort(sql::Executor* /*executor*/)
   {
-    connection->pooledConnection.reset();
-    connection->abort(executor);
+    broken.store(true);
+    close();
   }
 
   /**
@@ -170,6 +196,15 @@ namespace mariadb
   /** Fire Connection close to listening listeners. */
   void MariaDbPooledConnection::fireConnectionClosed()
   {
+    Shared::Pool owner(pool.lock());
+
+    if (owner) {
+      owner->releaseConnection(this);
+    }
+    else {
+      // The pool is gone already - nobody else will need this connection
+      delete this;
+    }
     /*ConnectionEvent* event= new ConnectionEvent(this);
     for (ConnectionEventListener* listener : connectionEventListeners) {
       listener->connectionClosed(event);
@@ -183,6 +218,7 @@ namespace mariadb
     */
   void MariaDbPooledConnection::fireConnectionErrorOccured(SQLException ex)
   {
+    broken.store(true);
     /*ConnectionEvent* event= new ConnectionEvent(this, ex);
     for (ConnectionEventListener* listener : connectionEventListeners) {
       listener->connectionErrorOccurred(event);
@@ -212,8 +248,47 @@ namespace mariadb
   /** Set last poolConnection use to now. */
   void MariaDbPooledConnection::lastUsedToNow()
   {
-    auto now= std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now().time_since_epoch());
+    auto now= std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch());
     lastUsed.store(now.count());
   }
+
+
+  /**
+    * Time the connection has been established.
+    *
+    * @return creation time (nano)
+    */
+  int64_t MariaDbPooledConnection::getCreationTime() const
+  {
+    return createdAt;
+  }
+
+  /**
+    * The pool, connection belongs to.
+    *
+    * @return pool, or empty pointer if it does not exist anymore
+    */
+  std::shared_ptr<Pool> MariaDbPooledConnection::getPool() const
+  {
+    return pool.lock();
+  }
+
+
+  bool MariaDbPooledConnection::isBroken() const
+  {
+    return broken.load() || protocol->isClosed();
+  }
+
+
+  int32_t MariaDbPooledConnection::getDefaultTransactionIsolation() const
+  {
+    return defaultTransactionIsolation;
+  }
+
+
+  void MariaDbPooledConnection::setDefaultTransactionIsolation(int32_t _defaultTransactionIsolation)
+  {
+    defaultTransactionIsolation= _defaultTransactionIsolation;
+  }
 }
 }
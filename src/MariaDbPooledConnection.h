@@ -22,6 +22,8 @@
 #define _MARIADBPOOLEDCONNECTION_H_
 
 #include <atomic>
+#include <memory>
+#include <vector>
 #include "Consts.h"
 
 #include "MariaDbConnection.h"
@@ -33,17 +35,32 @@ namespace mariadb
 {
 class ConnectionEventListener;
 class StatementEventListener;
+class Pool;
+class MariaDbConnection;
 
+/**
+  * Physical connection of a pool. Applications get MariaDbConnection handles over its protocol, and the handle
+  * gives the connection back to the pool on close.
+  */
 class MariaDbPooledConnection //  : public PooledConnection {
 {
-  MariaDbConnection* connection;
+  Shared::Protocol protocol;
+  std::weak_ptr<Pool> pool;
   std::vector<ConnectionEventListener*>connectionEventListeners;
   std::vector<StatementEventListener*>statementEventListeners;
   std::atomic<std::int64_t> lastUsed;
+  const int64_t createdAt;
+  /* Set, if connection error occurred while the connection was in use, and it cannot be given to anybody else */
+  std::atomic<bool> broken;
+  int32_t defaultTransactionIsolation;
+
+  MariaDbPooledConnection(const MariaDbPooledConnection&)= delete;
 
 public:
-  MariaDbPooledConnection(MariaDbConnection* connection);
+  MariaDbPooledConnection(Shared::Protocol& protocol, const std::weak_ptr<Pool>& pool);
+  ~MariaDbPooledConnection();
   MariaDbConnection* getConnection();
+  Shared::Protocol& getProtocol();
   void close();
   void abort(sql::Executor* executor);
   void addConnectionEventListener(ConnectionEventListener& listener);
@@ -57,6 +74,11 @@ public:
   bool noStmtEventListeners();
   int64_t getLastUsed();
   void lastUsedToNow();
+  int64_t getCreationTime() const;
+  std::shared_ptr<Pool> getPool() const;
+  bool isBroken() const;
+  int32_t getDefaultTransactionIsolation() const;
+  void setDefaultTransactionIsolation(int32_t defaultTransactionIsolation);
   };
 }
 }
@@ -975,6 +975,27 @@ namespace mariadb
   }
 
 
+  void MariaDbProcedureStatement::setIntArray(int32_t parameterIndex, const int32_t* values, std::size_t rowCount, const bool* nulls) {
+    stmt->setIntArray(parameterIndex, values, rowCount, nulls);
+  }
+
+
+  void MariaDbProcedureStatement::setInt64Array(int32_t parameterIndex, const int64_t* values, std::size_t rowCount, const bool* nulls) {
+    stmt->setInt64Array(parameterIndex, values, rowCount, nulls);
+  }
+
+
+  void MariaDbProcedureStatement::setDoubleArray(int32_t parameterIndex, const double* values, std::size_t rowCount, const bool* nulls) {
+    stmt->setDoubleArray(parameterIndex, values, rowCount, nulls);
+  }
+
+
+  void MariaDbProcedureStatement::setStringArray(int32_t parameterIndex, const char* const* values, const std::size_t* lengths,
+    std::size_t rowCount) {
+    stmt->setStringArray(parameterIndex, values, lengths, rowCount);
+  }
+
+
   void MariaDbProcedureStatement::setString(const SQLString& parameterName, const SQLString& stringValue)
   {
     stmt->setString(nameToIndex(parameterName), stringValue);
@@ -1107,6 +1128,9 @@ namespace mariadb
   void MariaDbProcedureStatement::closeOnCompletion() { stmt->closeOnCompletion(); }
   bool MariaDbProcedureStatement::isCloseOnCompletion() { return stmt->isCloseOnCompletion(); }
 
+  void MariaDbProcedureStatement::addBatch() {
+    stmt->addBatch();
+  }
   void MariaDbProcedureStatement::addBatch(const SQLString& sql) {
     stmt->addBatch(sql);
   }
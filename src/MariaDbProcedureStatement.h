@@ -251,6 +251,10 @@ public:
   void setDouble(int32_t parameterIndex, double value);
   void setDateTime(int32_t parameterIndex, const SQLString& dt);
   void setBigInt(int32_t parameterIndex, const SQLString& value);
+  void setIntArray(int32_t parameterIndex, const int32_t* values, std::size_t rowCount, const bool* nulls);
+  void setInt64Array(int32_t parameterIndex, const int64_t* values, std::size_t rowCount, const bool* nulls);
+  void setDoubleArray(int32_t parameterIndex, const double* values, std::size_t rowCount, const bool* nulls);
+  void setStringArray(int32_t parameterIndex, const char* const* values, const std::size_t* lengths, std::size_t rowCount);
 
   /* Forwarding to stmt to implement Statement's part of interface */
   int32_t executeUpdate(const SQLString& sql);
@@ -296,6 +300,7 @@ public:
   int32_t getResultSetType();
   void closeOnCompletion();
   bool isCloseOnCompletion();
+  void addBatch();
   void addBatch(const SQLString& sql);
   void clearBatch();
   void close();
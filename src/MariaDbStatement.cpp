@@ -68,16 +68,18 @@ namespace mariadb
       resultSetConcurrency(_resultSetConcurrency),
       options(protocol->getOptions()),
       canUseServerTimeout(_connection->canUseServerTimeout()),
-      fetchSize(options->defaultFetchSize),
+      exceptionFactory(factory),
       closed(false),
-      mustCloseOnCompletion(false),
-      warningsCleared(true),
+      queryTimeout(0),
       maxRows(0),
-      maxFieldSize(0),
-      exceptionFactory(factory),
+      fetchSize(options->defaultFetchSize),
+      executing(false),
+      warningsCleared(true),
+      mustCloseOnCompletion(false),
       isTimedout(false),
-      queryTimeout(0),
-      executing(false)
+      timeoutIsBatch(false),
+      timeoutTimer(std::bind(&MariaDbStatement::timeoutTask, this)),
+      maxFieldSize(0)
   {
   }
 
@@ -106,33 +108,44 @@ namespace mariadb
 
   MariaDbStatement::~MariaDbStatement()
   {
+    // Timer's own destructor would be too late - the thread, its task may start, has to be joined first
+    stopTimeoutTask();
   }
 
   // Part of query prolog - setup timeout timer
   void MariaDbStatement::setTimerTask(bool isBatch)
   {
-#ifdef MAYBE_IN_BETA
-    assert(!timerTaskFuture);
-    if (!timeoutScheduler)
-    {
-      timeoutScheduler= SchedulerServiceProviderHolder::getTimeoutScheduler();
+    // Previous execution may have left the timer armed, or the kill thread not joined
+    stopTimeoutTask();
+    isTimedout= false;
+    timeoutIsBatch= isBatch;
+    TimerWheel::getInstance().arm(timeoutTimer,
+      static_cast<uint32_t>(std::min<int64_t>(static_cast<int64_t>(queryTimeout)*1000, UINT32_MAX)));
+  }
+
+  /**
+   * Runs in the timer wheel thread, when the query timeout expires. Single query is killed, batch is stopped
+   * before the next query is sent. The kill needs new connection to the server, and is handed over to a separate
+   * thread, so that the wheel's thread only sets flags.
+   */
+  void MariaDbStatement::timeoutTask()
+  {
+    Protocol* timedOut= protocol;
+
+    isTimedout= true;
+    if (timedOut == nullptr) {
+      return;
+    }
+    timedOut->interrupt();
+    if (!timeoutIsBatch) {
+      cancelThread= std::thread([timedOut]() {
+        try {
+          timedOut->cancelCurrentQuery();
+        }
+        catch (std::exception&) {
+        }
+      });
     }
-    timerTaskFuture =
-      timeoutScheduler.schedule(
-          ()->{
-          try {
-          isTimedout= true;
-          if (!isBatch){
-          protocol->cancelCurrentQuery();
-          }
-          protocol->interrupt();
-          }catch (std::exception& e){
-
-          }
-          },
-          queryTimeout,
-          TimeUnit::SECONDS);
-#endif
   }
 
   /**
@@ -152,6 +165,7 @@ namespace mariadb
       throw *exceptionFactory->raiseStatementError(connection, this)->create("execute() is called on closed statement");
     }
     protocol->prolog(maxRows, protocol->getProxy(), connection, this);
+    isTimedout= false;
     if (queryTimeout != 0 &&(!canUseServerTimeout ||isBatch)){
       setTimerTask(isBatch);
     }
@@ -160,23 +174,12 @@ namespace mariadb
 
   void MariaDbStatement::stopTimeoutTask()
   {
-#ifdef MAYBE_IN_BETA
-    if (timerTaskFuture){
-      if (!timerTaskFuture.cancel(true)){
-
-
-        try {
-          timerTaskFuture.get();
-        }catch (InterruptedException& e){
-
-          Thread.currentThread().interrupt();
-        }catch (InterruptedException& e){
-
-        }
-      }
-      timerTaskFuture= NULL;
+    // Returns only when the timer task is not running
+    timeoutTimer.disarm();
+    // The kill has to be over, before anything else is sent - otherwise it could kill the next query
+    if (cancelThread.joinable()) {
+      cancelThread.join();
     }
-#endif
   }
 
   /**
@@ -213,17 +216,16 @@ namespace mariadb
     return *sqlException;
   }
 
+  // isTimedout is reset by the next execution prologue, since exception epilogue is called after this
   void MariaDbStatement::executeEpilogue()
   {
     stopTimeoutTask();
-    isTimedout= false;
     setExecutingFlag(false);
   }
 
   void MariaDbStatement::executeBatchEpilogue(){
     setExecutingFlag(false);
     stopTimeoutTask();
-    isTimedout= false;
     clearBatch();
   }
 
@@ -246,6 +248,7 @@ namespace mariadb
 
   BatchUpdateException MariaDbStatement::executeBatchExceptionEpilogue(SQLException& initialSqle, std::size_t size)
   {
+    stopTimeoutTask();
     SQLException sqle(handleFailoverAndTimeout(initialSqle));
     std::unique_ptr<sql::Ints> ret;
 
@@ -279,7 +282,6 @@ namespace mariadb
     std::unique_lock<std::mutex> localScopeLock(*lock);
 
     try {
-      std::vector<Shared::ParameterHolder> dummy;
       executeQueryPrologue(false);
       results.reset(
         new Results(
@@ -292,8 +294,7 @@ namespace mariadb
             resultSetConcurrency,
             autoGeneratedKeys,
             protocol->getAutoIncrementIncrement(),
-            sql,
-            dummy));
+            sql));
 
       protocol->executeQuery(protocol->isMasterConnection(), results, getTimeoutSql(Utils::nativeSql(sql,protocol)));
 
@@ -421,7 +422,6 @@ namespace mariadb
   {
     std::lock_guard<std::mutex> localScopeLock(*lock);
     try {
-      std::vector<Shared::ParameterHolder> dummy;
       executeQueryPrologue(false);
       results.reset(new Results(
             this,
@@ -433,8 +433,7 @@ namespace mariadb
             resultSetConcurrency,
             Statement::NO_GENERATED_KEYS,
             protocol->getAutoIncrementIncrement(),
-            sql,
-            dummy));
+            sql));
 
       protocol->executeQuery(
           protocol->isMasterConnection(),
@@ -1330,7 +1329,6 @@ namespace mariadb
    */
   void MariaDbStatement::internalBatchExecution(std::size_t size)
   {
-    std::vector<Shared::ParameterHolder> dummy;
     executeQueryPrologue(true);
     results.reset(new Results(
           this,
@@ -1342,8 +1340,7 @@ namespace mariadb
           resultSetConcurrency,
           Statement::RETURN_GENERATED_KEYS,
           protocol->getAutoIncrementIncrement(),
-          NULL,
-          dummy));
+          NULL));
     protocol->executeBatchStmt(protocol->isMasterConnection(),results,batchQueries);
     results->commandEnd();
   }
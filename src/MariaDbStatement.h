@@ -24,6 +24,8 @@
 #include <regex>
 #include <map>
 #include <mutex>
+#include <atomic>
+#include <thread>
 
 //#include "MariaDbConnection.h"
 
@@ -31,6 +33,7 @@
 #include "Statement.h"
 #include "Consts.h"
 #include "Charset.h"
+#include "util/TimerWheel.h"
 
 namespace sql
 {
@@ -67,16 +70,16 @@ protected:
   volatile bool executing;
 
 private:
-#ifdef MAYBE_IN_BETA
-  ScheduledExecutorService timeoutScheduler;
-#endif
   bool warningsCleared;
   bool mustCloseOnCompletion ; /*false*/
   std::vector<SQLString> batchQueries;
-#ifdef MAYBE_IN_BETA
-  Future<?>timerTaskFuture;
-#endif
-  bool isTimedout;
+  /* Set by the timeout timer task */
+  std::atomic<bool> isTimedout;
+  bool timeoutIsBatch;
+  /* Query timeout timer, armed for executions, that can't use server's max_statement_time */
+  TimerWheel::Timer timeoutTimer;
+  /* Kills the timed out query. Connecting to the server may take long, and cannot be done in the timer's thread */
+  std::thread cancelThread;
   uint32_t maxFieldSize;
 
 public:
@@ -90,6 +93,7 @@ public:
 protected:
   void executeQueryPrologue(bool isBatch);
 private:
+  void timeoutTask();
   void stopTimeoutTask();
   SQLException handleFailoverAndTimeout(SQLException& sqle);
 public://protected:
@@ -42,6 +42,7 @@
 #include "parameters/ShortParameter.h"
 #include "parameters/StreamParameter.h"
 #include "parameters/StringParameter.h"
+#include "parameters/SmallStringParameter.h"
 #include "parameters/TimeParameter.h"
 #include "parameters/TimestampParameter.h"
 //#include "parameters/ZonedDateTimeParameter.h"
@@ -42,6 +42,7 @@ namespace capi
 
 class ServerPrepareResult;
 class ClientPrepareResult;
+struct ParameterArray;
 class FailoverProxy;
 class Results;
 class Charset;
@@ -87,6 +88,7 @@ public:
   virtual const SQLString& getUsername() const=0;
   virtual bool ping()=0;
   virtual bool isValid(int32_t timeout)=0;
+  virtual bool isClosedByServer()=0;
   virtual void executeQuery(const SQLString& sql)=0;
   virtual void executeQuery(bool mustExecuteOnMaster, Shared::Results& results, const SQLString& sql)= 0;
   virtual void executeQuery(bool mustExecuteOnMaster, Shared::Results& results, const SQLString& sql, const Charset* charset)= 0;
@@ -102,6 +104,8 @@ public:
     std::vector<Shared::ParameterHolder>& parameters)= 0;
   virtual bool executeBatchServer(bool mustExecuteOnMaster, ServerPrepareResult* serverPrepareResult, Shared::Results& results, const SQLString& sql,
                                   std::vector<std::vector<Shared::ParameterHolder>>& parameterList, bool hasLongData)= 0;
+  virtual bool executeBulkArrays(ServerPrepareResult* serverPrepareResult, Shared::Results& results,
+                                 const std::vector<ParameterArray>& parameterArrays, std::size_t rowCount)= 0;
   virtual void moveToNextResult(Results* results, ServerPrepareResult* spr= nullptr)=0;
   virtual void getResult(Results* results, ServerPrepareResult *pr=nullptr)=0;
   virtual void cancelCurrentQuery()=0;
@@ -129,6 +133,7 @@ public:
   virtual void setHostFailedWithoutProxy()=0;
   virtual void releasePrepareStatement(ServerPrepareResult* serverPrepareResult)=0;
   virtual bool forceReleasePrepareStatement(capi::MYSQL_STMT* statementId)=0;
+  virtual void deferReleasePrepareStatement(capi::MYSQL_STMT* statementId)=0;
   virtual void forceReleaseWaitingPrepareStatement()=0;
   virtual ServerPrepareStatementCache* prepareStatementCache()=0;
   virtual TimeZone* getTimeZone()=0;
@@ -69,7 +69,6 @@ namespace mariadb
    *     of <code>Statement.RETURN_GENERATED_KEYS</code> or <code>Statement.NO_GENERATED_KEYS</code>
    * @param autoIncrement Connection auto-increment value
    * @param sql sql command
-   * @param parameters parameters
    */
   Results::Results(
       Statement* _statement,
@@ -81,10 +80,8 @@ namespace mariadb
       int32_t resultSetConcurrency,
       int32_t autoGeneratedKeys,
       int32_t autoIncrement,
-      const SQLString& _sql,
-      std::vector<Shared::ParameterHolder>& _parameters)
-    : parameters(_parameters)
-    , serverPrepResult(nullptr)
+      const SQLString& _sql)
+    : serverPrepResult(nullptr)
     , fetchSize(fetchSize)
     , batch(batch)
     , maxFieldSize(_statement->getMaxFieldSize())
@@ -399,10 +396,6 @@ namespace mariadb
     return sql;
   }
 
-  std::vector<Shared::ParameterHolder>& Results::getParameters(){
-    return parameters;
-  }
-
   /**
    * Send a resultSet that contain auto generated keys. 2 differences :
    *
@@ -52,7 +52,6 @@ class Results  {
   int32_t autoIncrement;
   bool rewritten;
   SQLString sql;
-  std::vector<Shared::ParameterHolder> parameters;
 
 public:
   Results();
@@ -66,8 +65,7 @@ public:
     int32_t resultSetConcurrency,
     int32_t autoGeneratedKeys,
     int32_t autoIncrement,
-    const SQLString& sql,
-    std::vector<Shared::ParameterHolder>& parameters);
+    const SQLString& sql);
   ~Results() {}
 
   void addStats(int64_t updateCount,int64_t insertId,bool moreResultAvailable);
@@ -96,7 +94,6 @@ public:
   void removeFetchSize();
   int32_t getResultSetScrollType();
   const SQLString& getSql();
-  std::vector<Shared::ParameterHolder>& getParameters();
   ResultSet* getGeneratedKeys(Protocol* protocol);
   void close();
   int32_t getMaxFieldSize();
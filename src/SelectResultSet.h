@@ -119,7 +119,7 @@ public:
   virtual void fetchRemaining()=0;
 
 protected:
-  virtual std::vector<sql::bytes>& getCurrentRowData()=0;
+  virtual sql::bytes* getCurrentRowData()=0;
   virtual void updateRowData(std::vector<sql::bytes>& rawData)=0;
   virtual void deleteCurrentRowData()=0;
   virtual void addRowData(std::vector<sql::bytes>& rawData)=0;
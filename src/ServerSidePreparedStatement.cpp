@@ -27,6 +27,9 @@
 #include "Results.h"
 #include "MariaDbParameterMetaData.h"
 #include "MariaDbResultSetMetaData.h"
+#include "Parameters.h"
+#include "util/ClientPrepareResult.h"
+#include "cache/ClientPrepareResultCache.h"
 
 namespace sql
 {
@@ -71,7 +74,8 @@ namespace sql
     : BasePrepareStatement(_connection, resultSetScrollType, resultSetConcurrency, autoGeneratedKeys, factory),
       connection(_connection),
       mustExecuteOnMaster(_mustExecuteOnMaster),
-      serverPrepareResult(nullptr)
+      serverPrepareResult(nullptr),
+      batchSize(0)
   {
   }
 
@@ -88,6 +92,7 @@ namespace sql
       this->autoGeneratedKeys, this->mustExecuteOnMaster, this->exceptionFactory);
     clone->metadata= metadata;
     clone->parameterMetaData= this->parameterMetaData;
+    clone->sql= sql;
 
     try {
       clone->prepare(sql);
@@ -118,6 +123,8 @@ namespace sql
   void ServerSidePreparedStatement::setMetaFromResult()
   {
     parameterCount= static_cast<int32_t>(serverPrepareResult->getParameters().size());
+    currentParameters.resize(parameterCount);
+    batchColumns.resize(parameterCount);
     metadata.reset(new MariaDbResultSetMetaData(serverPrepareResult->getColumns(), connection->getProtocol()->getUrlParser().getOptions(), false));
     // TODO: these transfer of the vector can be optimized for sure
     parameterMetaData.reset(new MariaDbParameterMetaData(serverPrepareResult->getParameters()));
@@ -125,16 +132,8 @@ namespace sql
 
   void ServerSidePreparedStatement::setParameter(int32_t parameterIndex, ParameterHolder* holder)
   {
-    // TODO: does it really has to be map? can be, actually
     if (parameterIndex > 0 && parameterIndex < serverPrepareResult->getParamCount() + 1) {
-      auto it= currentParameterHolder.find(parameterIndex - 1);
-      if (it == currentParameterHolder.end()) {
-        Shared::ParameterHolder paramHolder(holder);
-        currentParameterHolder.emplace(parameterIndex - 1, paramHolder);
-      }
-      else {
-        it->second.reset(holder);
-      }
+      currentParameters[parameterIndex - 1].set(holder);
     }
     else {
       SQLString error("Could not set parameter at position ");
@@ -165,17 +164,26 @@ namespace sql
     }
   }
 
+  ParameterSlot* ServerSidePreparedStatement::getParameterSlot(int32_t parameterIndex)
+  {
+    if (parameterIndex > 0 && parameterIndex <= parameterCount) {
+      return &currentParameters[parameterIndex - 1];
+    }
+    return nullptr;
+  }
+
+  /**
+   * Appends current values to the columns of the batch. Values kept in slots are copied, other holders are shared
+   * with the statement, since they are not changed after creation.
+   */
   void ServerSidePreparedStatement::addBatch()
   {
     validParameters();
 
-    queryParameters.push_back({});
-
-    std::vector<Shared::ParameterHolder>& newSet= queryParameters.back();
-    newSet.reserve(currentParameterHolder.size());
-
-    std::for_each(currentParameterHolder.cbegin(), currentParameterHolder.cend(), /*std::back_inserter(queryParameters),*/
-      [&newSet](const std::map<int32_t, Shared::ParameterHolder>::value_type& mapEntry) {newSet.push_back(mapEntry.second); });
+    for (int32_t i= 0; i < parameterCount; ++i) {
+      batchColumns[i].push_back(currentParameters[i]);
+    }
+    ++batchSize;
   }
 
   void ServerSidePreparedStatement::addBatch(const SQLString& sql)
@@ -183,9 +191,231 @@ namespace sql
     throw *exceptionFactory->raiseStatementError(connection, stmt.get())->create("Cannot do addBatch(SQLString) on preparedStatement");
   }
 
+  /**
+    * Sets values of the parameter for all rows of the batch.
+    *
+    * @param parameterIndex the first parameter is 1, the second is 2, ...
+    * @param values array of values. Not copied, has to stay valid until executeBatch()
+    * @param rowCount number of rows in the batch
+    * @param nulls optional array of NULL flags
+    */
+  void ServerSidePreparedStatement::setIntArray(int32_t parameterIndex, const int32_t* values, std::size_t rowCount,
+    const bool* nulls)
+  {
+    setParameterArray(parameterIndex, ColumnType::INTEGER, values, sizeof(int32_t), nulls, nullptr, rowCount);
+  }
+
+
+  void ServerSidePreparedStatement::setInt64Array(int32_t parameterIndex, const int64_t* values, std::size_t rowCount,
+    const bool* nulls)
+  {
+    setParameterArray(parameterIndex, ColumnType::BIGINT, values, sizeof(int64_t), nulls, nullptr, rowCount);
+  }
+
+
+  void ServerSidePreparedStatement::setDoubleArray(int32_t parameterIndex, const double* values, std::size_t rowCount,
+    const bool* nulls)
+  {
+    setParameterArray(parameterIndex, ColumnType::DOUBLE, values, sizeof(double), nulls, nullptr, rowCount);
+  }
+
+  /**
+    * Sets string values of the parameter for all rows of the batch.
+    *
+    * @param parameterIndex the first parameter is 1, the second is 2, ...
+    * @param values array of pointers to strings, nullptr means NULL value. Not copied, has to stay valid until
+    *     executeBatch()
+    * @param lengths lengths of strings
+    * @param rowCount number of rows in the batch
+    */
+  void ServerSidePreparedStatement::setStringArray(int32_t parameterIndex, const char* const* values,
+    const std::size_t* lengths, std::size_t rowCount)
+  {
+    setParameterArray(parameterIndex, ColumnType::STRING, values, 0, nullptr, lengths, rowCount);
+  }
+
+
+  void ServerSidePreparedStatement::setParameterArray(int32_t parameterIndex, const ColumnType& columnType,
+    const void* values, std::size_t valueSize, const bool* nulls, const std::size_t* lengths, std::size_t rowCount)
+  {
+    if (parameterIndex < 1 || parameterIndex > parameterCount) {
+      throw SQLException("Could not set parameter at position " + SQLString(std::to_string(parameterIndex)), "07009");
+    }
+    if (values == nullptr || (&columnType == &ColumnType::STRING && lengths == nullptr)) {
+      throw SQLException("Array of values of parameter " + SQLString(std::to_string(parameterIndex)) + " is NULL", "HY009");
+    }
+    parameterArrays.resize(parameterCount);
+
+    // Neither the array being replaced, nor arrays already executed count - after execution the statement may be
+    // re-bound with arrays of other length
+    for (int32_t i= 0; i < parameterCount; ++i) {
+      const ParameterArray& bound= parameterArrays[i];
+      if (i != parameterIndex - 1 && bound.values != nullptr && !bound.executed && bound.rowCount != rowCount) {
+        throw SQLException("Arrays of values of all parameters have to have the same length", "HY090");
+      }
+    }
+
+    ParameterArray& parameterArray= parameterArrays[parameterIndex - 1];
+    parameterArray.columnType= &columnType;
+    parameterArray.values= values;
+    parameterArray.nulls= nulls;
+    parameterArray.lengths= lengths;
+    parameterArray.valueSize= valueSize;
+    parameterArray.rowCount= rowCount;
+    parameterArray.executed= false;
+  }
+
+  /**
+    * Checks that values of all parameters have been set with array setters.
+    *
+    * @return number of rows in the batch
+    */
+  std::size_t ServerSidePreparedStatement::validParameterArrays()
+  {
+    for (int32_t i= 0; i < parameterCount; i++)
+    {
+      if (parameterArrays[i].values == nullptr)
+      {
+        logger->error("Array of values of parameter at position " + std::to_string(i + 1) + " is not set");
+        throw *exceptionFactory->raiseStatementError(connection, stmt.get())->create("Array of values of parameter at position "
+          + std::to_string(i + 1) + " is not set", "07004");
+      }
+      if (parameterArrays[i].rowCount != parameterArrays.front().rowCount)
+      {
+        throw *exceptionFactory->raiseStatementError(connection, stmt.get())->create(
+          "Arrays of values of all parameters have to have the same length", "HY090");
+      }
+    }
+    return parameterArrays.front().rowCount;
+  }
+
+  /**
+    * Executes the batch of parameters values set with array setters. Bulk execution takes values from
+    * application's arrays, otherwise they are converted to rows of parameters, like addBatch() would do. Converted
+    * rows are not kept in the batch - arrays stay bound until they are replaced or clearBatch() is called, and the
+    * next execution converts them again.
+    */
+  void ServerSidePreparedStatement::executeArrayBatch()
+  {
+    const std::size_t rowCount= validParameterArrays();
+    bool executed= false;
+
+    for (auto& parameterArray : parameterArrays) {
+      parameterArray.executed= true;
+    }
+
+    if (batchSize == 0) {
+      std::lock_guard<std::mutex> localScopeLock(*connection->getProtocol()->getLock());
+      try {
+        executeQueryPrologue(serverPrepareResult);
+
+        if (stmt->getQueryTimeout() != 0) {
+          stmt->setTimerTask(true);
+        }
+        stmt->setInternalResults(
+          new Results(
+            stmt.get(),
+            0,
+            true,
+            rowCount,
+            true,
+            stmt->getResultSetType(),
+            stmt->getResultSetConcurrency(),
+            autoGeneratedKeys,
+            connection->getProtocol()->getAutoIncrementIncrement(),
+            NULL));
+
+        executed= connection->getProtocol()->executeBulkArrays(serverPrepareResult, stmt->getInternalResults(),
+          parameterArrays, rowCount);
+        if (executed) {
+          stmt->getInternalResults()->commandEnd();
+        }
+      }
+      catch (SQLException& initialSqlEx) {
+        throw stmt->executeBatchExceptionEpilogue(initialSqlEx, static_cast<int32_t>(rowCount));
+      }
+    }
+
+    if (executed) {
+      stmt->executeBatchEpilogue();
+      return;
+    }
+    const std::size_t batchRowCount= batchSize;
+    appendArrayRows(rowCount);
+    try {
+      executeBatchInternal();
+    }
+    catch (...) {
+      truncateBatch(batchRowCount);
+      throw;
+    }
+    truncateBatch(batchRowCount);
+  }
+
+  /** Converts values set with array setters to values of parameters, and appends them to the batch columns */
+  void ServerSidePreparedStatement::appendArrayRows(std::size_t rowCount)
+  {
+    for (int32_t i= 0; i < parameterCount; ++i) {
+      const ParameterArray& parameterArray= parameterArrays[i];
+      std::vector<ParameterSlot>& column= batchColumns[i];
+      column.resize(batchSize + rowCount);
+
+      for (std::size_t row= 0; row < rowCount; ++row) {
+        ParameterSlot& slot= column[batchSize + row];
+
+        if (parameterArray.isNull(row)) {
+          slot.setNull(*parameterArray.columnType);
+        }
+        else if (parameterArray.columnType == &ColumnType::INTEGER) {
+          slot.setInt(static_cast<const int32_t*>(parameterArray.values)[row]);
+        }
+        else if (parameterArray.columnType == &ColumnType::BIGINT) {
+          slot.setLong(static_cast<const int64_t*>(parameterArray.values)[row]);
+        }
+        else if (parameterArray.columnType == &ColumnType::DOUBLE) {
+          slot.setDouble(static_cast<const double*>(parameterArray.values)[row]);
+        }
+        else {
+          slot.setString(static_cast<const char* const*>(parameterArray.values)[row], parameterArray.lengths[row],
+            noBackslashEscapes);
+        }
+      }
+    }
+    batchSize+= rowCount;
+  }
+
+  /** Removes rows of the batch after first rowCount rows */
+  void ServerSidePreparedStatement::truncateBatch(std::size_t rowCount)
+  {
+    for (auto& column : batchColumns) {
+      column.resize(rowCount);
+    }
+    batchSize= rowCount;
+  }
+
+  /**
+    * Returns rows of the batch in the form protocol takes them. Holders are not copied - rows point to the values
+    * in the batch columns, and are valid until the batch is changed.
+    */
+  std::vector<std::vector<Shared::ParameterHolder>>& ServerSidePreparedStatement::getBatchRows()
+  {
+    batchRowViews.resize(batchSize);
+
+    for (std::size_t row= 0; row < batchSize; ++row) {
+      std::vector<Shared::ParameterHolder>& rowView= batchRowViews[row];
+      rowView.resize(parameterCount);
+
+      for (int32_t i= 0; i < parameterCount; ++i) {
+        rowView[i]= batchColumns[i][row].view();
+      }
+    }
+    return batchRowViews;
+  }
+
   void ServerSidePreparedStatement::clearBatch()
   {
-    queryParameters.clear();
+    truncateBatch(0);
+    parameterArrays.clear();
     hasLongData= false;
   }
 
@@ -206,27 +436,35 @@ namespace sql
   sql::Ints* ServerSidePreparedStatement::executeBatch()
   {
     stmt->checkClose();
-    int32_t queryParameterSize= static_cast<int32_t>(queryParameters.size());
-    if (queryParameterSize == 0) {
+    if (!parameterArrays.empty()) {
+      executeArrayBatch();
+      return stmt->getInternalResults()->getCmdInformation()->getUpdateCounts();
+    }
+    if (batchSize == 0) {
       return new sql::Ints();
     }
-    executeBatchInternal(queryParameterSize);
+    executeBatchInternal();
     return stmt->getInternalResults()->getCmdInformation()->getUpdateCounts();
   }
 
   sql::Longs* ServerSidePreparedStatement::executeLargeBatch()
   {
     stmt->checkClose();
-    int32_t queryParameterSize= static_cast<int32_t>(queryParameters.size());
-    if (queryParameterSize == 0) {
+    if (!parameterArrays.empty()) {
+      executeArrayBatch();
+      return stmt->getInternalResults()->getCmdInformation()->getLargeUpdateCounts();
+    }
+    if (batchSize == 0) {
       return new sql::Longs();
     }
-    executeBatchInternal(queryParameterSize);
+    executeBatchInternal();
     return stmt->getInternalResults()->getCmdInformation()->getLargeUpdateCounts();
   }
 
-  void ServerSidePreparedStatement::executeBatchInternal(int32_t queryParameterSize)
+  void ServerSidePreparedStatement::executeBatchInternal()
   {
+    std::vector<std::vector<Shared::ParameterHolder>>& parameterList= getBatchRows();
+    const int32_t queryParameterSize= static_cast<int32_t>(parameterList.size());
     std::lock_guard<std::mutex> localScopeLock(*connection->getProtocol()->getLock());
     stmt->setExecutingFlag();
 
@@ -236,7 +474,6 @@ namespace sql
       if (stmt->getQueryTimeout() !=0) {
         stmt->setTimerTask(true);
       }
-      std::vector<Shared::ParameterHolder> dummy;
       stmt->setInternalResults(
         new Results(
           stmt.get(),
@@ -248,23 +485,24 @@ namespace sql
           stmt->getResultSetConcurrency(),
           autoGeneratedKeys,
           connection->getProtocol()->getAutoIncrementIncrement(),
-          NULL,
-          dummy));
+          NULL));
 
 
-      if ((connection->getProtocol()->getOptions()->useBatchMultiSend || connection->getProtocol()->getOptions()->useBulkStmts)
+      if (executeBatchRewritten(parameterList)
+        || ((connection->getProtocol()->getOptions()->useBatchMultiSend || connection->getProtocol()->getOptions()->useBulkStmts)
        && (connection->getProtocol()->executeBatchServer(
                                                         mustExecuteOnMaster,
                                                         serverPrepareResult,
                                                         stmt->getInternalResults(),
                                                         sql,
-                                                        queryParameters,
-                                                        hasLongData)))
+                                                        parameterList,
+                                                        hasLongData))))
       {
         if (!metadata) {
           setMetaFromResult();
         }
         stmt->getInternalResults()->commandEnd();
+        stmt->executeBatchEpilogue();
         return;
       }
 
@@ -275,7 +513,7 @@ namespace sql
         for (int32_t counter= 0; counter < queryParameterSize; counter++)
         {
           // TODO: verify if paramsets are guaranteed to exist at this point for all queryParameterSize
-          std::vector<Shared::ParameterHolder>& parameterHolder= queryParameters[counter];
+          std::vector<Shared::ParameterHolder>& parameterHolder= parameterList[counter];
           try {
             connection->getProtocol()->stopIfInterrupted();
             serverPrepareResult->resetParameterTypeHeader();
@@ -300,7 +538,7 @@ namespace sql
       }
       else {
         for (int32_t counter= 0; counter < queryParameterSize; counter++) {
-          std::vector<Shared::ParameterHolder>& parameterHolder= queryParameters[counter];
+          std::vector<Shared::ParameterHolder>& parameterHolder= parameterList[counter];
           try {
             serverPrepareResult->resetParameterTypeHeader();
             connection->getProtocol()->executePreparedQuery(
@@ -330,6 +568,41 @@ namespace sql
     stmt->executeBatchEpilogue();
   }
 
+  /**
+    * With rewriteBatchedStatements option the batch is sent as text queries - INSERT rewritten to have values of
+    * many rows, or queries separated by semicolons, if bulk execution is not enabled. The query is parsed once
+    * for all connections, and taken from ClientPrepareResultCache.
+    * Must have "lock" locked before invoking.
+    *
+    * @param parameterList rows of parameters
+    * @return true if the batch has been executed
+    */
+  bool ServerSidePreparedStatement::executeBatchRewritten(std::vector<std::vector<Shared::ParameterHolder>>& parameterList)
+  {
+    Protocol* protocol= connection->getProtocol();
+
+    if (!protocol->getOptions()->rewriteBatchedStatements || hasLongData) {
+      return false;
+    }
+    if (!rewritePrepareResult) {
+      rewritePrepareResult= ClientPrepareResultCache::getInstance().rewritableParts(sql, noBackslashEscapes);
+    }
+    if (rewritePrepareResult->getParamCount() != static_cast<size_t>(parameterCount)) {
+      return false;
+    }
+
+    bool multiValues= rewritePrepareResult->isQueryMultiValuesRewritable()
+      && autoGeneratedKeys == Statement::NO_GENERATED_KEYS;
+
+    // Bulk execution of multiple queries is left to executeBatchServer, that uses already prepared statement
+    if (!multiValues
+      && (!rewritePrepareResult->isQueryMultipleRewritable() || protocol->getOptions()->useBulkStmts)) {
+      return false;
+    }
+    return protocol->executeBatchClient(mustExecuteOnMaster, stmt->getInternalResults(), rewritePrepareResult.get(),
+      parameterList, hasLongData);
+  }
+
   // must have "lock" locked before invoking
   void ServerSidePreparedStatement::executeQueryPrologue(ServerPrepareResult* serverPrepareResult)
   {
@@ -352,7 +625,9 @@ namespace sql
 
   void ServerSidePreparedStatement::clearParameters()
   {
-    currentParameterHolder.clear();
+    for (auto& slot : currentParameters) {
+      slot.reset();
+    }
   }
 
 
@@ -360,7 +635,7 @@ namespace sql
   {
     for (int32_t i= 0; i < parameterCount; i++)
     {
-      if (currentParameterHolder.find(i) == currentParameterHolder.end())
+      if (currentParameters[i].empty())
       {
         logger->error("Parameter at position " + std::to_string(i + 1) + " is not set" );
         throw *exceptionFactory->raiseStatementError(connection, stmt.get())->create("Parameter at position "+ std::to_string(i+1) + " is not set", "07004");
@@ -380,10 +655,6 @@ namespace sql
         stmt->setTimerTask(false);
       }
 
-      std::vector<Shared::ParameterHolder> parameterHolders;
-      std::for_each(currentParameterHolder.cbegin(), currentParameterHolder.cend(), /*std::back_inserter(queryParameters),*/
-        [&parameterHolders](const std::map<int32_t, Shared::ParameterHolder>::value_type& mapEntry) {parameterHolders.push_back(mapEntry.second); });
-
       stmt->setInternalResults(
         new Results(
           this,
@@ -395,12 +666,15 @@ namespace sql
           stmt->getResultSetConcurrency(),
           autoGeneratedKeys,
           connection->getProtocol()->getAutoIncrementIncrement(),
-          sql,
-          parameterHolders));
+          sql));
 
+      currentParameterViews.resize(parameterCount);
+      for (int32_t i= 0; i < parameterCount; ++i) {
+        currentParameterViews[i]= currentParameters[i].view();
+      }
       serverPrepareResult->resetParameterTypeHeader();
       connection->getProtocol()->executePreparedQuery(
-        mustExecuteOnMaster, serverPrepareResult, stmt->getInternalResults(), parameterHolders);
+        mustExecuteOnMaster, serverPrepareResult, stmt->getInternalResults(), currentParameterViews);
 
       stmt->getInternalResults()->commandEnd();
       stmt->executeEpilogue();
@@ -433,6 +707,8 @@ namespace sql
       }
       catch (SQLException&) {
       }
+      // Released statement can be deallocated, or given to other statement by the cache
+      serverPrepareResult= nullptr;
     }
     if (connection == nullptr
      || connection->pooledConnection == nullptr
@@ -456,17 +732,16 @@ namespace sql
     */
   SQLString ServerSidePreparedStatement::toString()
   {
-    SQLString sb("sql : '"+serverPrepareResult->getSql()+"'");
+    SQLString sb("sql : '"+sql+"'");
     if (parameterCount > 0) {
       sb.append(", parameters : [");
       for (int32_t i= 0; i < parameterCount; i++)
       {
-        const auto cit= currentParameterHolder.find(i);
-        if (cit == currentParameterHolder.cend() || cit->second == NULL) {
+        if (currentParameters[i].empty()) {
           sb.append("NULL");
         }
         else {
-          sb.append(cit->second->toString());
+          sb.append(currentParameters[i].get()->toString());
         }
         if (i !=parameterCount -1) {
           sb.append(",");
@@ -484,7 +759,7 @@ namespace sql
     */
   int64_t ServerSidePreparedStatement::getServerThreadId()
   {
-    return serverPrepareResult->getUnProxiedProtocol()->getServerThreadId();
+    return serverPrepareResult != nullptr ? serverPrepareResult->getUnProxiedProtocol()->getServerThreadId() : -1;
   }
 }
 }
@@ -24,6 +24,8 @@
 #include "Consts.h"
 
 #include "parameters/ParameterHolder.h"
+#include "parameters/ParameterArray.h"
+#include "parameters/ParameterSlot.h"
 #include "BasePrepareStatement.h"
 
 namespace sql
@@ -52,8 +54,18 @@ private:
   Shared::MariaDbResultSetMetaData metadata;
   Shared::MariaDbParameterMetaData parameterMetaData;
 
-  std::map<int32_t,Shared::ParameterHolder> currentParameterHolder;
-  std::vector<std::vector<Shared::ParameterHolder>> queryParameters;
+  /* Parameters values by their position. Not set parameters are empty */
+  std::vector<ParameterSlot> currentParameters;
+  /* Values of rows added with addBatch(), by parameter position - one column of values for each parameter */
+  std::vector<std::vector<ParameterSlot>> batchColumns;
+  std::size_t batchSize;
+  /* Pointers to holders in the slots above, in the form protocol takes them. Refreshed before each execution */
+  std::vector<Shared::ParameterHolder> currentParameterViews;
+  std::vector<std::vector<Shared::ParameterHolder>> batchRowViews;
+  /* Values of all rows of the batch by parameter position, set with array setters */
+  std::vector<ParameterArray> parameterArrays;
+  /* Query parsed for rewriting of batches, taken from ClientPrepareResultCache on first use */
+  Shared::ClientPrepareResult rewritePrepareResult;
 
   bool mustExecuteOnMaster;
   //Unique::BasePrepareStatement bpstmt;
@@ -81,6 +93,7 @@ private:
 
 public:
   void setParameter(int32_t parameterIndex,/*const*/ ParameterHolder* holder);
+  ParameterSlot* getParameterSlot(int32_t parameterIndex);
   void addBatch();
   void addBatch(const SQLString& sql);
   void clearBatch();
@@ -89,8 +102,21 @@ public:
   sql::Ints* executeBatch();
   sql::Longs* executeLargeBatch();
 
+  void setIntArray(int32_t parameterIndex, const int32_t* values, std::size_t rowCount, const bool* nulls);
+  void setInt64Array(int32_t parameterIndex, const int64_t* values, std::size_t rowCount, const bool* nulls);
+  void setDoubleArray(int32_t parameterIndex, const double* values, std::size_t rowCount, const bool* nulls);
+  void setStringArray(int32_t parameterIndex, const char* const* values, const std::size_t* lengths, std::size_t rowCount);
+
 private:
-  void executeBatchInternal(int32_t queryParameterSize);
+  void setParameterArray(int32_t parameterIndex, const ColumnType& columnType, const void* values, std::size_t valueSize,
+    const bool* nulls, const std::size_t* lengths, std::size_t rowCount);
+  std::size_t validParameterArrays();
+  void executeArrayBatch();
+  void appendArrayRows(std::size_t rowCount);
+  void truncateBatch(std::size_t rowCount);
+  std::vector<std::vector<Shared::ParameterHolder>>& getBatchRows();
+  void executeBatchInternal();
+  bool executeBatchRewritten(std::vector<std::vector<Shared::ParameterHolder>>& parameterList);
   void executeQueryPrologue(ServerPrepareResult* serverPrepareResult);
 
 public:
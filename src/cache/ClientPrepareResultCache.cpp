@@ -0,0 +1,169 @@
+/************************************************************************************
+   Copyright (C) 2020 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include "ClientPrepareResultCache.h"
+
+#include "util/ClientPrepareResult.h"
+
+namespace sql
+{
+namespace mariadb
+{
+
+  ClientPrepareResultCache::ClientPrepareResultCache(std::size_t size)
+    : maxSize(size)
+    , hits(0)
+    , misses(0)
+    , evictions(0)
+  {
+  }
+
+
+  ClientPrepareResultCache& ClientPrepareResultCache::getInstance()
+  {
+    static ClientPrepareResultCache instance(DEFAULT_SIZE);
+    return instance;
+  }
+
+  /**
+    * Returns the query split by parameter placeholders, parsing it only if it is not in the cache yet.
+    *
+    * @param sql query
+    * @param noBackslashEscapes escape mode
+    * @return shared parse result
+    */
+  Shared::ClientPrepareResult ClientPrepareResultCache::parameterParts(const SQLString& sql, bool noBackslashEscapes)
+  {
+    return get(sql, noBackslashEscapes, false);
+  }
+
+  /**
+    * Returns the query split in parts for multi-values rewrite, parsing it only if it is not in the cache yet.
+    *
+    * @param sql query
+    * @param noBackslashEscapes escape mode
+    * @return shared parse result
+    */
+  Shared::ClientPrepareResult ClientPrepareResultCache::rewritableParts(const SQLString& sql, bool noBackslashEscapes)
+  {
+    return get(sql, noBackslashEscapes, true);
+  }
+
+
+  Shared::ClientPrepareResult ClientPrepareResultCache::get(const SQLString& sql, bool noBackslashEscapes, bool rewritable)
+  {
+    if (sql.length() > MAX_SQL_LENGTH) {
+      return Shared::ClientPrepareResult(rewritable ? ClientPrepareResult::rewritableParts(sql, noBackslashEscapes)
+        : ClientPrepareResult::parameterParts(sql, noBackslashEscapes));
+    }
+
+    // Both flags are part of the key, since they change the result of the parsing
+    std::string key;
+    key.reserve(sql.length() + 1);
+    key.push_back(static_cast<char>('0' + (noBackslashEscapes ? 1 : 0) + (rewritable ? 2 : 0)));
+    key.append(sql.c_str(), sql.length());
+
+    {
+      std::lock_guard<std::mutex> localScopeLock(lock);
+      auto it= cache.find(key);
+
+      if (it != cache.end()) {
+        ++hits;
+        lru.splice(lru.begin(), lru, it->second);
+        return it->second->second;
+      }
+      ++misses;
+    }
+
+    // Parsing is done without holding the lock
+    Shared::ClientPrepareResult result(rewritable ? ClientPrepareResult::rewritableParts(sql, noBackslashEscapes)
+      : ClientPrepareResult::parameterParts(sql, noBackslashEscapes));
+
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    auto it= cache.find(key);
+
+    // Other thread could have parsed the same query in the meantime
+    if (it != cache.end()) {
+      return it->second->second;
+    }
+    if (maxSize > 0) {
+      lru.emplace_front(key, result);
+      cache.emplace(std::move(key), lru.begin());
+      removeEldestEntries();
+    }
+    return result;
+  }
+
+  /* Has to be called with the lock held */
+  void ClientPrepareResultCache::removeEldestEntries()
+  {
+    while (cache.size() > maxSize) {
+      cache.erase(lru.back().first);
+      lru.pop_back();
+      ++evictions;
+    }
+  }
+
+
+  void ClientPrepareResultCache::setMaxSize(std::size_t size)
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    maxSize= size;
+    removeEldestEntries();
+  }
+
+
+  void ClientPrepareResultCache::clear()
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    cache.clear();
+    lru.clear();
+  }
+
+
+  std::size_t ClientPrepareResultCache::size()
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    return cache.size();
+  }
+
+
+  uint64_t ClientPrepareResultCache::getHitCount()
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    return hits;
+  }
+
+
+  uint64_t ClientPrepareResultCache::getMissCount()
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    return misses;
+  }
+
+
+  uint64_t ClientPrepareResultCache::getEvictionCount()
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    return evictions;
+  }
+}
+}
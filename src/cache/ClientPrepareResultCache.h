@@ -0,0 +1,75 @@
+/************************************************************************************
+   Copyright (C) 2020 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#ifndef _CLIENTPREPARERESULTCACHE_H_
+#define _CLIENTPREPARERESULTCACHE_H_
+
+#include <list>
+#include <unordered_map>
+#include <mutex>
+
+#include "Consts.h"
+
+namespace sql
+{
+namespace mariadb
+{
+
+/**
+  * Process-wide LRU cache of parsed queries. Results of ClientPrepareResult::parameterParts and rewritableParts are
+  * immutable, and are shared by all connections and statements preparing the same query in the same
+  * NO_BACKSLASH_ESCAPES mode. Entries exceeding the cache size are evicted, and are freed once no statement uses them.
+  */
+class ClientPrepareResultCache final {
+  typedef std::list<std::pair<std::string, Shared::ClientPrepareResult>> LruList;
+
+  std::mutex lock;
+  std::size_t maxSize;
+  /* Entries in the order of use, the most recently used first */
+  LruList lru;
+  std::unordered_map<std::string, LruList::iterator> cache;
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+
+  ClientPrepareResultCache(std::size_t size);
+  Shared::ClientPrepareResult get(const SQLString& sql, bool noBackslashEscapes, bool rewritable);
+  void removeEldestEntries();
+
+public:
+  /* Queries longer than that are parsed every time, and are not cached */
+  static const std::size_t MAX_SQL_LENGTH= 8192;
+  static const std::size_t DEFAULT_SIZE= 2048;
+
+  static ClientPrepareResultCache& getInstance();
+
+  Shared::ClientPrepareResult parameterParts(const SQLString& sql, bool noBackslashEscapes);
+  Shared::ClientPrepareResult rewritableParts(const SQLString& sql, bool noBackslashEscapes);
+  void setMaxSize(std::size_t size);
+  void clear();
+  std::size_t size();
+  uint64_t getHitCount();
+  uint64_t getMissCount();
+  uint64_t getEvictionCount();
+};
+}
+}
+#endif
@@ -98,12 +98,12 @@ namespace mariadb
     size_t pos= 0;
 
     for (auto& updCnt : updateCounts) {
-      ret[pos++]= updCnt;
+      (*ret)[pos++]= static_cast<int32_t>(updCnt);
     }
 
 
     while (pos < ret->size()) {
-      ret[pos++]= Statement::EXECUTE_FAILED;
+      (*ret)[pos++]= Statement::EXECUTE_FAILED;
     }
 
     return ret;
@@ -115,7 +115,7 @@ namespace mariadb
     size_t pos= 0;
 
     for (auto& updCnt : updateCounts) {
-      ret[pos++]= static_cast<int32_t>(updCnt);
+      (*ret)[pos++]= static_cast<int32_t>(updCnt);
     }
     return ret;
   }
@@ -155,7 +155,7 @@ namespace mariadb
     {
       size_t pos= updateCounts.size();
       while (pos < ret->size()) {
-        ret[pos++]= Statement::EXECUTE_FAILED;
+        (*ret)[pos++]= Statement::EXECUTE_FAILED;
       }
     }
 
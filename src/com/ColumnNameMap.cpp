@@ -18,6 +18,8 @@
 *************************************************************************************/
 
 
+#include <cctype>
+
 #include "ColumnNameMap.h"
 
 #include "ColumnDefinition.h"
@@ -28,9 +30,85 @@ namespace sql
 namespace mariadb
 {
 
-  ColumnNameMap::ColumnNameMap(std::vector<Shared::ColumnDefinition>& columnInformations)
-    : columnInfo(columnInformations)
-  {}
+  static inline char foldCase(char c)
+  {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+
+  /**
+    * Constructor. Indexes all column aliases and "table alias.column alias" pairs, and then all original
+    * column names and "original table.original column" pairs. For duplicate keys the first column wins, thus
+    * aliases take precedence over original names.
+    *
+    * @param columnInformations columns to index
+    */
+  ColumnNameMap::ColumnNameMap(const std::vector<Shared::ColumnDefinition>& columnInformations)
+    : mask(1)
+  {
+    std::size_t slotCount= 2;
+    // Up to 4 keys per column, keeping load factor under 1/2
+    while (slotCount < columnInformations.size() * 8) {
+      slotCount<<= 1;
+    }
+    slots.assign(slotCount, -1);
+    mask= slotCount - 1;
+    entries.reserve(columnInformations.size() * 2);
+
+    int32_t counter= 0;
+    for (auto& ci : columnInformations) {
+      add(ci->getTable(), ci->getName(), counter++);
+    }
+    counter= 0;
+    for (auto& ci : columnInformations) {
+      add(ci->getOriginalTable(), ci->getOriginalName(), counter++);
+    }
+  }
+
+
+  std::size_t ColumnNameMap::hashName(const char* name, std::size_t len)
+  {
+    // FNV-1a over case folded bytes
+    uint32_t hash= 2166136261U;
+    for (std::size_t i= 0; i < len; ++i) {
+      hash^= static_cast<unsigned char>(foldCase(name[i]));
+      hash*= 16777619U;
+    }
+    return hash;
+  }
+
+
+  void ColumnNameMap::add(const SQLString& table, const SQLString& name, int32_t index)
+  {
+    if (name.empty()) {
+      return;
+    }
+    std::string key(name.c_str(), name.length());
+    add(key, index);
+
+    if (!table.empty()) {
+      key.assign(table.c_str(), table.length());
+      key.append(1, '.').append(name.c_str(), name.length());
+      add(key, index);
+    }
+  }
+
+
+  void ColumnNameMap::add(std::string& key, int32_t index)
+  {
+    for (auto& c : key) {
+      c= foldCase(c);
+    }
+
+    std::size_t slot= hashName(key.data(), key.length()) & mask;
+    while (slots[slot] >= 0) {
+      if (entries[slots[slot]].name == key) {
+        return;
+      }
+      slot= (slot + 1) & mask;
+    }
+    slots[slot]= static_cast<int32_t>(entries.size());
+    entries.push_back({ key, index });
+  }
 
   /**
     * Get column index by name.
@@ -39,87 +117,29 @@ namespace mariadb
     * @return index.
     * @throws SQLException if no column info exists, or column is unknown
     */
-  int32_t ColumnNameMap::getIndex(const SQLString& name)
+  int32_t ColumnNameMap::getIndex(const SQLString& name) const
   {
     if (name.empty() == true) {
       throw SQLException("Column name cannot be empty");
     }
-    SQLString lowerName(name);
-
-    lowerName.toLowerCase();
-
-    if (aliasMap.empty())
-    {
-      int32_t counter= 0;
-
-      for (auto& ci : columnInfo)
-      {
-        SQLString columnAlias(ci->getName());
-        if (!columnAlias.empty())
-        {
-          columnAlias.toLowerCase();
-
-          if (aliasMap.find(columnAlias) == aliasMap.end())
-          {
-            aliasMap.emplace(columnAlias, counter);
-          }
-
-          SQLString keyName(ci->getTable());
-
-          if (!keyName.empty())
-          {
-            keyName.toLowerCase().append('.').append(columnAlias);
-            if (aliasMap.find(keyName) != aliasMap.end())
-            {
-              aliasMap.emplace(keyName, counter);
-            }
-          }
-        }
-        ++counter;
-      }
-    }
+    const char* str= name.c_str();
+    std::size_t len= name.length();
 
-    const auto& cit= aliasMap.find(lowerName);
-    if (cit != aliasMap.end()) {
-      return cit->second;
-    }
+    for (std::size_t slot= hashName(str, len) & mask; slots[slot] >= 0; slot= (slot + 1) & mask) {
+      const Entry& entry= entries[slots[slot]];
 
-    if (originalMap.empty())
-    {
-      int32_t counter= 0;
-      for (auto& ci : columnInfo)
-      {
-        SQLString columnRealName(ci->getOriginalName());
-
-        if (columnRealName.empty()) {
-          columnRealName= columnRealName.toLowerCase();
-
-          if (originalMap.find(columnRealName) == originalMap.end())
-          {
-            originalMap.emplace(columnRealName, counter);
-          }
-
-          SQLString keyName(ci->getOriginalTable());
-          if (!keyName.empty())
-          {
-            keyName.toLowerCase().append('.').append(columnRealName);
-            if (originalMap.find(keyName) == originalMap.end())
-            {
-              originalMap.emplace(keyName, counter);
-            }
-          }
+      if (entry.name.length() == len) {
+        std::size_t i= 0;
+        while (i < len && entry.name[i] == foldCase(str[i])) {
+          ++i;
+        }
+        if (i == len) {
+          return entry.index;
         }
-        ++counter;
       }
     }
-
-    const auto& otherCit= originalMap.find(lowerName);
-
-    if (otherCit == originalMap.end()) {
-      //throw ExceptionMapper::get("No such column: "+name, "42S22", 1054, NULL, false);
-      throw IllegalArgumentException("No such column: " + name, "42S22", 1054);
-    }
-    return cit->second;
+    //throw ExceptionMapper::get("No such column: "+name, "42S22", 1054, NULL, false);
+    throw IllegalArgumentException("No such column: " + name, "42S22", 1054);
   }
 
 }
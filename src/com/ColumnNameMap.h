@@ -29,15 +29,31 @@ namespace mariadb
 {
 class ColumnDefinition;
 
+/**
+  * Case-insensitive column label index. Built once for a set of column definitions, and can be shared by all
+  * result sets having those columns(e.g. all result sets of the same server side prepared statement).
+  * Keys are stored lowercased in a flat open addressing table, so lookups do not allocate.
+  */
 class ColumnNameMap
 {
-  std::vector<Shared::ColumnDefinition> columnInfo;
-  std::map<SQLString,int32_t>originalMap;
-  std::map<SQLString,int32_t>aliasMap;
+  struct Entry
+  {
+    std::string name;
+    int32_t index;
+  };
+
+  std::vector<Entry> entries;
+  /* Indexes in entries, -1 marks empty slot. Size is always power of 2 */
+  std::vector<int32_t> slots;
+  std::size_t mask;
+
+  static std::size_t hashName(const char* name, std::size_t len);
+  void add(const SQLString& table, const SQLString& name, int32_t index);
+  void add(std::string& key, int32_t index);
 
 public:
-  ColumnNameMap(std::vector<Shared::ColumnDefinition>& columnInformations);
-  int32_t getIndex(const SQLString& name);
+  ColumnNameMap(const std::vector<Shared::ColumnDefinition>& columnInformations);
+  int32_t getIndex(const SQLString& name) const;
 };
 
 }
@@ -27,7 +27,6 @@ namespace sql
 namespace mariadb
 {
   Date nullDate("0000-00-00");
-  sql::bytes dummy;
 
   int32_t RowProtocol::BIT_LAST_FIELD_NOT_NULL= 0b000000;
   int32_t RowProtocol::BIT_LAST_FIELD_NULL= 0b000001;
@@ -35,11 +34,6 @@ namespace mariadb
   int32_t RowProtocol::TINYINT1_IS_BIT= 1;
   int32_t RowProtocol::YEAR_IS_DATE_TYPE= 2;
 
-  std::regex RowProtocol::isIntegerRegex("^-?\\d+\\.[0-9]+$", std::regex_constants::ECMAScript);
-  std::regex RowProtocol::dateRegex("^-?\\d{4}-\\d{2}-\\d{2}", std::regex_constants::ECMAScript);
-  std::regex RowProtocol::timeRegex("^(-?)(\\d{2}):(\\d{2}):(\\d{2})(\\.\\d+)?", std::regex_constants::ECMAScript);
-  std::regex RowProtocol::timestampRegex("^-?\\d{4}-\\d{2}-\\d{2} \\d{2}:\\d{2}:\\d{2}\\.?", std::regex_constants::ECMAScript);
-
   int32_t RowProtocol::NULL_LENGTH_= -1;
 
 #ifdef WE_HAVE_JAVA_TYPES_IMPLEMENTED
@@ -69,7 +63,6 @@ namespace mariadb
     : maxFieldSize(maxFieldSize)
     , options(options)
     , buf(nullptr)
-    , fieldBuf(dummy)
     , length(0)
     , lastValueNull(0)
     , index(0)
@@ -78,9 +71,9 @@ namespace mariadb
   }
 
 
-  void RowProtocol::resetRow(std::vector<sql::bytes>& _buf)
+  void RowProtocol::resetRow(sql::bytes* _buf)
   {
-    buf= &_buf;
+    buf= _buf;
   }
 
   uint32_t RowProtocol::getLengthMaxFieldSize()
@@ -128,6 +121,103 @@ namespace mariadb
     return value;
   }
 
+  /**
+    * Get string value as pointer and length. Generic variant, converting the value into the per column
+    * buffer, that stays valid until the next call for the same column.
+    *
+    * @param columnInfo column information
+    * @param len [out] value length
+    * @return pointer to the value, or NULL if the value is NULL
+    */
+  const char* RowProtocol::getInternalStringView(ColumnDefinition* columnInfo, std::size_t& len)
+  {
+    std::unique_ptr<SQLString> str(getInternalString(columnInfo));
+
+    if (!str) {
+      len= 0;
+      return nullptr;
+    }
+    if (convertedValues.size() <= static_cast<std::size_t>(index)) {
+      convertedValues.resize(index + 1);
+    }
+    std::string& holder= convertedValues[index];
+    holder.assign(str->c_str(), str->length());
+    len= holder.length();
+
+    return holder.c_str();
+  }
+
+
+  /**
+    * Appends values of the current row to the columnar batch. Generic variant, going through the
+    * getInternal* methods, row protocol classes override it with direct decoding of their native buffers.
+    *
+    * @param batch batch to fill. Its columns are initialized and have null bitmap space for the row
+    * @param rowIndex index of the row in the batch
+    * @param columnInformation column information
+    */
+  void RowProtocol::appendToBatch(ColumnBatch& batch, std::size_t rowIndex, const std::vector<Shared::ColumnDefinition>& columnInformation)
+  {
+    for (std::size_t i= 0; i < batch.columns.size(); ++i) {
+      setPosition(static_cast<int32_t>(i));
+      appendValueToBatch(batch.columns[i], rowIndex, columnInformation[i].get());
+    }
+  }
+
+  /**
+    * Converts value at the current position and appends it to the batch column.
+    */
+  void RowProtocol::appendValueToBatch(ColumnBatch::Column& column, std::size_t rowIndex, ColumnDefinition* columnInfo)
+  {
+    if (lastValueWasNull()) {
+      appendNullToBatch(column, rowIndex);
+      return;
+    }
+    switch (column.kind) {
+    case ColumnBatch::INT64:
+      column.longs.push_back(column.isUnsigned ? static_cast<int64_t>(getInternalULong(columnInfo)) : getInternalLong(columnInfo));
+      break;
+    case ColumnBatch::DOUBLE:
+      column.doubles.push_back(static_cast<double>(getInternalDouble(columnInfo)));
+      break;
+    default:
+    {
+      std::unique_ptr<SQLString> str(getInternalString(columnInfo));
+      if (!str) {
+        appendNullToBatch(column, rowIndex);
+      }
+      else {
+        appendStringToBatch(column, str->c_str(), str->length());
+      }
+    }
+    }
+  }
+
+
+  void RowProtocol::appendNullToBatch(ColumnBatch::Column& column, std::size_t rowIndex)
+  {
+    column.nulls[rowIndex >> 3]|= static_cast<uint8_t>(1 << (rowIndex & 7));
+
+    switch (column.kind) {
+    case ColumnBatch::INT64:
+      column.longs.push_back(0);
+      break;
+    case ColumnBatch::DOUBLE:
+      column.doubles.push_back(0.0);
+      break;
+    default:
+      column.offsets.push_back(column.data.size());
+    }
+  }
+
+
+  void RowProtocol::appendStringToBatch(ColumnBatch::Column& column, const char* str, std::size_t len)
+  {
+    column.data.insert(column.data.end(), str, str + len);
+    column.offsets.push_back(column.data.size());
+  }
+
+
   int64_t RowProtocol::parseBit()
   {
     if (length == 1) {
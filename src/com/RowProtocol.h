@@ -21,7 +21,6 @@
 #ifndef _ROWPROTOCOL_H_
 #define _ROWPROTOCOL_H_
 
-#include <regex>
 #include <iostream>
 
 #include "Consts.h"
@@ -33,6 +32,7 @@ namespace mariadb
 
 extern Date nullDate;
 
+class ColumnDefinition;
 class DateTimeFormatter;
 class Calendar;
 class TimeZone;
@@ -65,6 +65,14 @@ struct memBuf : std::streambuf
 };
 
 
+/* Value converters of the column, specialized for its type. Selected once, when the row protocol object is created */
+template <class T> struct ColumnConverters
+{
+  int32_t (T::*getInt)(ColumnDefinition*);
+  int64_t (T::*getLong)(ColumnDefinition*);
+  long double (T::*getDouble)(ColumnDefinition*);
+};
+
 class RowProtocol  {
 
 public:
@@ -76,10 +84,6 @@ public:
   static const DateTimeFormatter* TEXT_LOCAL_DATE_TIME;
   static const DateTimeFormatter* TEXT_OFFSET_DATE_TIME;
   static const DateTimeFormatter* TEXT_ZONED_DATE_TIME;
-  static std::regex isIntegerRegex ; /*Pattern.compile("^-?\\d+\\.[0-9]+$")*/
-  static std::regex dateRegex;
-  static std::regex timeRegex;
-  static std::regex timestampRegex;
 
 protected:
   static int32_t NULL_LENGTH_ ; /*-1*/
@@ -88,19 +92,21 @@ protected:
 
 public:
   int32_t lastValueNull;
-  std::vector<sql::bytes>* buf;
-  sql::bytes& fieldBuf;
+  sql::bytes* buf;
+  sql::bytes fieldBuf;
   int32_t pos;
   uint32_t length;
 
 protected:
   int32_t index;
+  /* Storage for the string views of values, that need conversion. One per column */
+  std::vector<std::string> convertedValues;
 
 public:
   RowProtocol(int32_t maxFieldSize, Shared::Options options);
   virtual ~RowProtocol() {}
 
-  void resetRow(std::vector<sql::bytes>& buf);
+  void resetRow(sql::bytes* buf);
   virtual void setPosition(int32_t position)=0;
   uint32_t getLengthMaxFieldSize();
   uint32_t getMaxFieldSize();
@@ -116,12 +122,16 @@ public:
   void rangeCheck(const sql::SQLString& className, int64_t minValue, int64_t maxValue, int64_t value, ColumnDefinition* columnInfo);
 #endif
   virtual int32_t fetchNext()=0;
+  /* Raw value of the column of the row read by fetchNext(), or nullptr for NULL. The value can be stored, and later
+     read via resetRow() */
+  virtual const char* getRawValue(int32_t columnIndex, std::size_t& len)=0;
   virtual void installCursorAtPosition(int32_t rowPtr)=0;
 
   virtual Date getInternalDate(ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr)=0;
   virtual std::unique_ptr<Time>  getInternalTime(ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr)=0;
   virtual std::unique_ptr<Timestamp> getInternalTimestamp(ColumnDefinition* columnInfo, Calendar* userCalendar=nullptr, TimeZone* timeZone=nullptr)=0;
   virtual std::unique_ptr<SQLString> getInternalString(ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr)=0;
+  virtual const char* getInternalStringView(ColumnDefinition* columnInfo, std::size_t& len);
   virtual int32_t getInternalInt(ColumnDefinition* columnInfo)=0;
   virtual int64_t getInternalLong(ColumnDefinition* columnInfo)=0;
   virtual uint64_t getInternalULong(ColumnDefinition* columnInfo)=0;
@@ -137,6 +147,7 @@ public:
 
   virtual bool isBinaryEncoded()=0;
   bool lastValueWasNull();
+  virtual void appendToBatch(ColumnBatch& batch, std::size_t rowIndex, const std::vector<Shared::ColumnDefinition>& columnInformation);
 
 protected:
   SQLString zeroFillingIfNeeded(const SQLString& value, ColumnDefinition* columnInformation);
@@ -146,6 +157,9 @@ protected:
   int64_t getInternalMediumInt(ColumnDefinition* columnInfo);
 
   bool convertStringToBoolean(const char* str, std::size_t len);
+  void appendValueToBatch(ColumnBatch::Column& column, std::size_t rowIndex, ColumnDefinition* columnInfo);
+  static void appendNullToBatch(ColumnBatch::Column& column, std::size_t rowIndex);
+  static void appendStringToBatch(ColumnBatch::Column& column, const char* str, std::size_t len);
 
 public:
   void rangeCheck(const sql::SQLString& className,int64_t minValue, int64_t maxValue, int64_t value, ColumnDefinition* columnInfo);
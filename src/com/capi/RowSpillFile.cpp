@@ -0,0 +1,168 @@
+/************************************************************************************
+   Copyright (C) 2020 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+#include <cstring>
+
+#include "RowSpillFile.h"
+
+namespace sql
+{
+namespace mariadb
+{
+namespace capi
+{
+  static const std::size_t ALIGNMENT= sizeof(int64_t);
+
+  static std::size_t paddedLength(std::size_t len)
+  {
+    // +1 for terminating null
+    return (len + ALIGNMENT) & ~(ALIGNMENT - 1);
+  }
+
+  /**
+    * Constructor. Creates the temporary file, that is deleted automatically when closed.
+    *
+    * @param columnCount number of columns in the row
+    * @throws SQLException if the file could not be created
+    */
+  RowSpillFile::RowSpillFile(int32_t _columnCount)
+    : file(std::tmpfile())
+    , columnCount(_columnCount)
+    , offsets(1, 0)
+    , rowEnd(0)
+    , writing(true)
+    , rowValues(_columnCount)
+    , currentRow(static_cast<std::size_t>(-1))
+  {
+    if (file == nullptr) {
+      throw SQLException("Could not create temporary file for the result set rows", "HY000");
+    }
+  }
+
+
+  RowSpillFile::~RowSpillFile()
+  {
+    std::fclose(file);
+  }
+
+
+  void RowSpillFile::write(const void* buffer, std::size_t len)
+  {
+    if (len > 0 && std::fwrite(buffer, 1, len, file) != len) {
+      throw SQLException("Could not write result set row to the temporary file", "HY000");
+    }
+    rowEnd+= len;
+  }
+
+
+  void RowSpillFile::seek(int64_t offset, int whence)
+  {
+#ifdef _WIN32
+    int rc= _fseeki64(file, offset, whence);
+#else
+    int rc= fseeko(file, static_cast<off_t>(offset), whence);
+#endif
+    if (rc != 0) {
+      throw SQLException("Could not position in the temporary file for the result set rows", "HY000");
+    }
+  }
+
+  /**
+    * Add value of the column to the current row.
+    *
+    * @param value value of the column, or nullptr for NULL
+    * @param len value length
+    * @throws SQLException if the write failed
+    */
+  void RowSpillFile::addValue(const char* value, std::size_t len)
+  {
+    static const char zeros[ALIGNMENT]= { 0 };
+
+    // Switching from reading to writing requires positioning
+    if (!writing) {
+      seek(0, SEEK_END);
+      writing= true;
+    }
+    int64_t header= value != nullptr ? static_cast<int64_t>(len) : -1;
+    write(&header, sizeof(header));
+
+    if (value != nullptr) {
+      write(value, len);
+      write(zeros, paddedLength(len) - len);
+    }
+  }
+
+
+  void RowSpillFile::endRow()
+  {
+    offsets.push_back(rowEnd);
+  }
+
+
+  std::size_t RowSpillFile::rowsCount() const
+  {
+    return offsets.size() - 1;
+  }
+
+  /**
+    * Read the row from the file. Returned values stay valid until the next call.
+    *
+    * @param rowIndex index of the row in the file
+    * @return pointer to the first value of the row
+    * @throws SQLException if the read failed
+    */
+  sql::bytes* RowSpillFile::getRow(std::size_t rowIndex)
+  {
+    if (rowIndex == currentRow) {
+      return rowValues.data();
+    }
+    int64_t start= offsets[rowIndex];
+    std::size_t size= static_cast<std::size_t>(offsets[rowIndex + 1] - start);
+
+    seek(start, SEEK_SET);
+    writing= false;
+
+    rowBuffer.resize(size / ALIGNMENT);
+    if (std::fread(rowBuffer.data(), 1, size, file) != size) {
+      throw SQLException("Could not read result set row from the temporary file", "HY000");
+    }
+
+    char* pos= reinterpret_cast<char*>(rowBuffer.data());
+    for (int32_t i= 0; i < columnCount; ++i) {
+      int64_t len;
+      std::memcpy(&len, pos, sizeof(len));
+      pos+= sizeof(len);
+
+      if (len < 0) {
+        rowValues[i].wrap(nullptr, 0);
+      }
+      else {
+        rowValues[i].wrap(pos, static_cast<std::size_t>(len));
+        pos+= paddedLength(static_cast<std::size_t>(len));
+      }
+    }
+    currentRow= rowIndex;
+
+    return rowValues.data();
+  }
+
+}
+}
+}
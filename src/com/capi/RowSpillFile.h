@@ -0,0 +1,68 @@
+/************************************************************************************
+   Copyright (C) 2020 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+#ifndef _ROWSPILLFILE_H_
+#define _ROWSPILLFILE_H_
+
+#include <cstdio>
+#include <vector>
+
+#include "Consts.h"
+
+namespace sql
+{
+namespace mariadb
+{
+namespace capi
+{
+/* Temporary file for the rows of the result set, that exceed its memory limit. Rows are only appended, and are read
+   back by the row offsets index kept in memory. Values are stored the way the row protocol classes expect to find
+   them in the stored row - null-terminated and 8 bytes aligned. Each value is preceded by its length, -1 for NULL */
+class RowSpillFile
+{
+  std::FILE* file;
+  int32_t columnCount;
+  /* Offset of each row in the file, and the offset of the end of the last row */
+  std::vector<int64_t> offsets;
+  int64_t rowEnd;
+  bool writing;
+
+  /* The row read last. int64_t to have buffer aligned */
+  std::vector<int64_t> rowBuffer;
+  std::vector<sql::bytes> rowValues;
+  std::size_t currentRow;
+
+  void write(const void* buffer, std::size_t len);
+  void seek(int64_t offset, int whence);
+
+public:
+  RowSpillFile(int32_t columnCount);
+  ~RowSpillFile();
+
+  void addValue(const char* value, std::size_t len);
+  void endRow();
+  std::size_t rowsCount() const;
+  sql::bytes* getRow(std::size_t rowIndex);
+};
+
+}
+}
+}
+#endif
@@ -21,6 +21,7 @@
 #include <vector>
 #include <array>
 #include <sstream>
+#include <thread>
 
 #include "SelectResultSetCapi.h"
 #include "Results.h"
@@ -43,6 +44,8 @@ namespace mariadb
 {
 namespace capi
 {
+  const std::size_t RowArena::CHUNK_SIZE;
+
   /**
     * Create Streaming resultSet.
     *
@@ -63,7 +66,7 @@ namespace capi
       options(protocol->getOptions()),
       noBackslashEscapes(protocol->noBackslashEscapes()),
       columnsInformation(spr->getColumns()),
-      columnNameMap(new ColumnNameMap(columnsInformation)),
+      columnNameMap(spr->getColumnNameMap()),
       columnInformationLength(static_cast<int32_t>(columnsInformation.size())),
       fetchSize(results->getFetchSize()),
       dataSize(0),
@@ -77,17 +80,24 @@ namespace capi
       capiStmtHandle(spr->getStatementId()),
       timeZone(nullptr),
       forceAlias(false),
-      lastRowPointer(-1)
+      lastRowPointer(-1),
+      readAhead(false),
+      readAheadSize(0),
+      readAheadRequested(false)
     //      timeZone(protocol->getTimeZone(),
   {
     row.reset(new capi::BinRowProtocolCapi(columnsInformation, columnInformationLength, results->getMaxFieldSize(), options, capiStmtHandle));
 
     if (fetchSize == 0 || callableResult) {
-      data.reserve(10);//= new char[10]; // This has to be array of arrays. Need to decide what to use for its representation
-      if (mysql_stmt_store_result(capiStmtHandle)) {
-        throwStmtError(capiStmtHandle);
+      if (!callableResult && resultSetScrollType != TYPE_FORWARD_ONLY && options->resultSetMemoryLimit > 0) {
+        fetchAllRowsLimited(static_cast<std::size_t>(options->resultSetMemoryLimit)*1024);
+      }
+      else {
+        if (mysql_stmt_store_result(capiStmtHandle)) {
+          throwStmtError(capiStmtHandle);
+        }
+        dataSize= static_cast<std::size_t>(mysql_stmt_num_rows(capiStmtHandle));
       }
-      dataSize= static_cast<std::size_t>(mysql_stmt_num_rows(capiStmtHandle));
       streaming= false;
       resetVariables();
     }
@@ -98,9 +108,14 @@ namespace capi
       protocol->setActiveStreamingResult(shRes);
 
       protocol->removeHasMoreResults();
-      data.reserve(std::max(10, fetchSize)); // Same
-      nextStreamingValue();
+      readAhead= options->useReadAhead;
+      if (readAhead) {
+        // Binds own buffers to the statement, and fetches all streamed rows from now on
+        readAheadRow.reset(new capi::BinRowProtocolCapi(columnsInformation, columnInformationLength, results->getMaxFieldSize(),
+          options, capiStmtHandle));
+      }
       streaming= true;
+      nextStreamingValue();
     }
   }
 
@@ -125,25 +140,36 @@ namespace capi
       capiStmtHandle(NULL),
       timeZone(nullptr),
       forceAlias(false),
-      lastRowPointer(-1)
+      lastRowPointer(-1),
+      readAhead(false),
+      readAheadSize(0),
+      readAheadRequested(false)
   {
     MYSQL_RES* textNativeResults= NULL;
+    bool limitMemory= false;
     if (fetchSize == 0 || callableResult) {
-      data.reserve(10);//= new char[10]; // This has to be array of arrays. Need to decide what to use for its representation
-      textNativeResults= mysql_store_result(capiConnHandle);
-      dataSize= static_cast<size_t>(textNativeResults != NULL ? mysql_num_rows(textNativeResults) : 0);
+      if (resultSetScrollType != TYPE_FORWARD_ONLY && options->resultSetMemoryLimit > 0) {
+        // Rows are read unbuffered, and stored by the result set
+        textNativeResults= mysql_use_result(capiConnHandle);
+        limitMemory= textNativeResults != NULL;
+      }
+      else {
+        textNativeResults= mysql_store_result(capiConnHandle);
+        dataSize= static_cast<size_t>(textNativeResults != NULL ? mysql_num_rows(textNativeResults) : 0);
+      }
       streaming= false;
       resetVariables();
     }
     else {
+      lock= protocol->getLock();
       //TODO: This may be wrong. We get plain ptr and putting it to smart ptr, which will eventually destrct the object w/out object's owner control
       Shared::Results shRes(results);
       protocol->setActiveStreamingResult(shRes);
 
       protocol->removeHasMoreResults();
-      data.reserve(std::max(10, fetchSize)); // Same
       textNativeResults= mysql_use_result(capiConnHandle);
 
+      readAhead= options->useReadAhead;
       streaming= true;
     }
     uint32_t fieldCnt= mysql_field_count(capiConnHandle);
@@ -153,14 +179,24 @@ namespace capi
     for (size_t i= 0; i < fieldCnt; ++i) {
       columnsInformation.emplace_back(new ColumnDefinitionCapi(mysql_fetch_field(textNativeResults)));
     }
-    row.reset(new capi::TextRowProtocolCapi(results->getMaxFieldSize(), options, textNativeResults));
+    if (readAhead) {
+      // Both decoders read the same result, read-ahead one fetches all streamed rows
+      std::shared_ptr<MYSQL_RES> sharedResults(textNativeResults, &mysql_free_result);
+      row.reset(new capi::TextRowProtocolCapi(columnsInformation, results->getMaxFieldSize(), options, sharedResults));
+      readAheadRow.reset(new capi::TextRowProtocolCapi(columnsInformation, results->getMaxFieldSize(), options, sharedResults));
+    }
+    else {
+      row.reset(new capi::TextRowProtocolCapi(columnsInformation, results->getMaxFieldSize(), options, textNativeResults));
+    }
 
-    columnNameMap.reset(new ColumnNameMap(columnsInformation));
     columnInformationLength= static_cast<int32_t>(columnsInformation.size());
 
     if (streaming) {
       nextStreamingValue();
     }
+    else if (limitMemory) {
+      fetchAllRowsLimited(static_cast<std::size_t>(options->resultSetMemoryLimit)*1024);
+    }
   }
 
   /**
@@ -179,12 +215,10 @@ namespace capi
     Protocol* protocol,
     int32_t resultSetScrollType)
     : statement(nullptr),
-      row(new capi::TextRowProtocolCapi(0, this->options, nullptr)),
-      data(std::move(resultSet)),
-      dataSize(data.size()),
+      row(new capi::TextRowProtocolCapi(columnInformation, 0, this->options, nullptr)),
+      dataSize(0),
       isClosedFlag(false),
       columnsInformation(columnInformation),
-      columnNameMap(new ColumnNameMap(columnsInformation)),
       columnInformationLength(static_cast<int32_t>(columnInformation.size())),
       isEof(true),
       fetchSize(0),
@@ -199,7 +233,10 @@ namespace capi
       forceAlias(false),
       lastRowPointer(-1),
       eofDeprecated(false),
-      noBackslashEscapes(false)
+      noBackslashEscapes(false),
+      readAhead(false),
+      readAheadSize(0),
+      readAheadRequested(false)
   {
     if (protocol) {
       this->options= protocol->getOptions();
@@ -208,6 +245,18 @@ namespace capi
     else {
       // this->timeZone= TimeZone.getDefault();
     }
+    data.resize(resultSet.size()*columnInformationLength);
+    for (auto& rowData : resultSet) {
+      storeRow(getRowData(static_cast<int32_t>(dataSize)), rowData);
+      ++dataSize;
+    }
+    resultSet.clear();
+  }
+
+
+  SelectResultSetCapi::~SelectResultSetCapi()
+  {
+    stopReadAhead();
   }
 
   /**
@@ -292,6 +341,8 @@ namespace capi
       std::lock_guard<std::mutex> localScopeLock(*lock);
       try {
         lastRowPointer= -1;
+        // Rows already being read ahead are taken, and the rest is read without the background task
+        readAhead= false;
         while (!isEof) {
           addStreamingValue();
         }
@@ -331,6 +382,18 @@ namespace capi
 
     if (resultSetScrollType == TYPE_FORWARD_ONLY) {
       dataSize= 0;
+      data.clear();
+      arena.clear();
+
+      // Without read-ahead rows are read one by one from the decoder's buffers, and are not copied
+      if (!readAheadRow) {
+        row->resetRow(nullptr);
+        if (readNextValue()) {
+          dataSize= 1;
+        }
+        dataFetchTime++;
+        return;
+      }
     }
 
     addStreamingValue();
@@ -343,15 +406,315 @@ namespace capi
     * @throws SQLException if server return an unexpected error
     */
   void SelectResultSetCapi::addStreamingValue() {
+    bool hasMore;
+
+    // Row, that has been read without copying, is in the decoder's buffers, which the next fetch overwrites
+    if (streaming && data.empty() && dataSize > 0) {
+      dataSize= 0;
+      copyFetchedRow(fetchingRow(), data, arena, dataSize);
+      lastRowPointer= -1;
+    }
+
+    if (readAheadRequested) {
+      hasMore= takeReadAheadRows();
+    }
+    else {
+      std::atomic_bool notCancelled(false);
+      hasMore= fetchRows(data, arena, dataSize, fetchSize, notCancelled);
+    }
 
-    int32_t fetchSizeTmp= fetchSize;
-    while (fetchSizeTmp > 0 && readNextValue()) {
-      fetchSizeTmp--;
+    if (!hasMore) {
+      // The fetcher thread is not needed anymore
+      stopReadAhead();
+      readEof();
+    }
+    else if (readAhead) {
+      startReadAhead();
     }
     dataFetchTime++;
   }
 
 
+  /**
+    * Decoder, that fetches rows from the server. If read-ahead is on, that is the read-ahead decoder, even when rows
+    * are fetched synchronously, since the statement's result is bound to its buffers.
+    */
+  RowProtocol* SelectResultSetCapi::fetchingRow()
+  {
+    return readAheadRow ? readAheadRow.get() : row.get();
+  }
+
+  /**
+    * Fetch rows from the server, and copy their values to the given storage. Values are null-terminated. Does not
+    * access anything but the fetching decoder and the given arguments, thus can run in the read-ahead task.
+    *
+    * @param values storage for row values
+    * @param rowArena arena for the values copies
+    * @param rows [in/out] number of rows in the values storage
+    * @param maxRows maximum number of rows to fetch
+    * @param cancelled flag to stop fetching
+    * @return false if the end of the result set has been reached
+    * @throws SQLException if the fetch failed
+    */
+  bool SelectResultSetCapi::fetchRows(std::vector<sql::bytes>& values, RowArena& rowArena, std::size_t& rows,
+    int32_t maxRows, const std::atomic_bool& cancelled)
+  {
+    RowProtocol* fetcher= fetchingRow();
+
+    for (int32_t i= 0; i < maxRows && !cancelled; ++i) {
+      int32_t rc= fetcher->fetchNext();
+
+      if (rc == MYSQL_NO_DATA) {
+        return false;
+      }
+      else if (rc == 1 && capiStmtHandle != nullptr) {
+        throwStmtError(capiStmtHandle);
+      }
+      copyFetchedRow(fetcher, values, rowArena, rows);
+    }
+    return true;
+  }
+
+  /**
+    * Copy values of the row, last fetched by the decoder, to the given storage. Values are null-terminated.
+    *
+    * @param fetcher decoder, that has fetched the row
+    * @param values storage for row values
+    * @param rowArena arena for the values copies
+    * @param rows [in/out] number of rows in the values storage
+    */
+  void SelectResultSetCapi::copyFetchedRow(RowProtocol* fetcher, std::vector<sql::bytes>& values, RowArena& rowArena,
+    std::size_t& rows)
+  {
+    values.resize((rows + 1)*columnInformationLength);
+    sql::bytes* rowValues= values.data() + rows*columnInformationLength;
+
+    for (int32_t column= 0; column < columnInformationLength; ++column) {
+      std::size_t len;
+      const char* value= fetcher->getRawValue(column, len);
+
+      if (value == nullptr) {
+        rowValues[column].wrap(nullptr, 0);
+        continue;
+      }
+      char* copy= rowArena.alloc(len + 1);
+      std::memcpy(copy, value, len);
+      copy[len]= '\0';
+      rowValues[column].wrap(copy, len);
+    }
+    ++rows;
+  }
+
+  /**
+    * Read all rows of the result, keeping in memory rows up to the memory limit. Remaining rows are stored in the
+    * temporary file.
+    *
+    * @param memoryLimit memory limit in bytes
+    * @throws SQLException if the fetch failed
+    */
+  void SelectResultSetCapi::fetchAllRowsLimited(std::size_t memoryLimit)
+  {
+    const std::atomic_bool notCancelled(false);
+    bool hasMore= true;
+
+    // Rows are fetched in small portions to check the memory use in between
+    while (hasMore && arena.allocated + data.capacity()*sizeof(sql::bytes) < memoryLimit) {
+      hasMore= fetchRows(data, arena, dataSize, 64, notCancelled);
+    }
+
+    if (hasMore) {
+      spill.reset(new RowSpillFile(columnInformationLength));
+      int32_t rc;
+
+      while ((rc= row->fetchNext()) != MYSQL_NO_DATA) {
+        if (rc == 1 && capiStmtHandle != nullptr) {
+          throwStmtError(capiStmtHandle);
+        }
+        for (int32_t column= 0; column < columnInformationLength; ++column) {
+          std::size_t len;
+          const char* value= row->getRawValue(column, len);
+          spill->addValue(value, len);
+        }
+        spill->endRow();
+        ++dataSize;
+      }
+    }
+
+    // Text protocol reports errors the same way as the end of the result
+    if (capiConnHandle != nullptr && mysql_errno(capiConnHandle) != 0) {
+      throw *ExceptionFactory::INSTANCE.create(mysql_error(capiConnHandle), mysql_sqlstate(capiConnHandle),
+        mysql_errno(capiConnHandle));
+    }
+  }
+
+  /**
+    * Request next fetchSize rows from the fetcher thread, starting the thread with the first request. Only one
+    * request is outstanding at a time, thus the fetcher is never more than one batch ahead of the application.
+    * Must have "lock" locked before invoking.
+    */
+  void SelectResultSetCapi::startReadAhead()
+  {
+    if (!readAheadControl) {
+      readAheadControl.reset(new ReadAheadControl());
+      std::thread(&SelectResultSetCapi::readAheadLoop, this, readAheadControl, lock).detach();
+    }
+    std::lock_guard<std::mutex> stateLock(readAheadControl->mutex);
+
+    // The fetcher is idle, and does not use the buffers
+    readAheadData.clear();
+    readAheadArena.clear();
+    readAheadSize= 0;
+    readAheadControl->maxRows= fetchSize;
+    readAheadControl->state= ReadAheadControl::REQUESTED;
+    readAheadRequested= true;
+    readAheadControl->cond.notify_all();
+  }
+
+  /**
+    * Body of the fetcher thread. It waits for a request, and fetches rows holding the connection lock. Blocking on
+    * the lock is safe - the thread, that holds it, never waits for the fetcher, since the fetcher can't be fetching
+    * at that time. If the fetcher has not got the lock yet, such thread takes the request back, and fetches the rows
+    * itself. The result set is used only while fetching. The thread is detached, and exits once it sees the STOPPED
+    * state, even if the result set has been destroyed by then.
+    *
+    * @param control state shared with the result set
+    * @param connectionLock connection lock
+    */
+  void SelectResultSetCapi::readAheadLoop(std::shared_ptr<ReadAheadControl> control, Shared::mutex connectionLock)
+  {
+    std::unique_lock<std::mutex> stateLock(control->mutex);
+
+    while (true) {
+      control->cond.wait(stateLock, [&control]() {
+        return control->state == ReadAheadControl::REQUESTED || control->state == ReadAheadControl::STOPPED;
+      });
+
+      if (control->state == ReadAheadControl::STOPPED) {
+        return;
+      }
+      stateLock.unlock();
+      std::lock_guard<std::mutex> fetchLock(*connectionLock);
+      stateLock.lock();
+
+      if (control->state != ReadAheadControl::REQUESTED) {
+        continue;
+      }
+      control->state= ReadAheadControl::FETCHING;
+      stateLock.unlock();
+
+      bool hasMore= true;
+      std::exception_ptr error;
+      try {
+        hasMore= fetchRows(readAheadData, readAheadArena, readAheadSize, control->maxRows, control->cancelled);
+      }
+      catch (...) {
+        error= std::current_exception();
+      }
+
+      stateLock.lock();
+      control->hasMore= hasMore;
+      control->error= error;
+      control->state= ReadAheadControl::READY;
+      control->cond.notify_all();
+    }
+  }
+
+  /**
+    * Add rows fetched by the fetcher thread to the result set data. If the fetcher has not started yet, the request
+    * is taken back, and rows are fetched synchronously. Must have "lock" locked before invoking, thus the fetcher
+    * is not fetching now.
+    *
+    * @return false if the end of the result set has been reached
+    * @throws SQLException if the fetch failed
+    */
+  bool SelectResultSetCapi::takeReadAheadRows()
+  {
+    std::unique_lock<std::mutex> stateLock(readAheadControl->mutex);
+    const bool ready= readAheadControl->state == ReadAheadControl::READY;
+    const bool hasMore= readAheadControl->hasMore;
+    std::exception_ptr error;
+
+    readAheadRequested= false;
+    readAheadControl->state= ReadAheadControl::IDLE;
+    std::swap(error, readAheadControl->error);
+    stateLock.unlock();
+
+    if (!ready) {
+      std::atomic_bool notCancelled(false);
+      return fetchRows(data, arena, dataSize, fetchSize, notCancelled);
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+
+    if (dataSize == 0) {
+      data.swap(readAheadData);
+      std::swap(arena, readAheadArena);
+      dataSize= readAheadSize;
+    }
+    else {
+      data.resize(dataSize*columnInformationLength);
+      data.insert(data.end(), readAheadData.begin(), readAheadData.begin() + readAheadSize*columnInformationLength);
+      arena.adopt(readAheadArena);
+      dataSize+= readAheadSize;
+    }
+    readAheadSize= 0;
+
+    return hasMore;
+  }
+
+  /**
+    * Turn read-ahead off, and discard rows the fetcher has fetched. Must have "lock" locked before invoking.
+    *
+    * @return false if the end of the result set has been reached
+    * @throws SQLException if the fetch failed
+    */
+  bool SelectResultSetCapi::cancelReadAhead()
+  {
+    std::unique_lock<std::mutex> stateLock(readAheadControl->mutex);
+    const bool hasMore= readAheadControl->state != ReadAheadControl::READY || readAheadControl->hasMore;
+    std::exception_ptr error;
+
+    readAhead= false;
+    readAheadRequested= false;
+    readAheadControl->state= ReadAheadControl::IDLE;
+    std::swap(error, readAheadControl->error);
+    stateLock.unlock();
+
+    readAheadData.clear();
+    readAheadArena.clear();
+    readAheadSize= 0;
+
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    return hasMore;
+  }
+
+  /**
+    * Make the fetcher thread exit. If it is fetching, waits for it to stop at the next row - it holds the connection
+    * lock then, thus the caller does not, and waiting is safe.
+    */
+  void SelectResultSetCapi::stopReadAhead()
+  {
+    if (!readAheadControl) {
+      return;
+    }
+    std::unique_lock<std::mutex> stateLock(readAheadControl->mutex);
+
+    readAheadControl->cancelled= true;
+    readAheadControl->cond.wait(stateLock, [this]() {
+      return readAheadControl->state != ReadAheadControl::FETCHING;
+    });
+    readAheadRequested= false;
+    readAheadControl->state= ReadAheadControl::STOPPED;
+    readAheadControl->cond.notify_all();
+    stateLock.unlock();
+
+    readAheadControl.reset();
+  }
+
+
   /**
     * Read next value.
     *
@@ -361,7 +724,7 @@ namespace capi
     */
   bool SelectResultSetCapi::readNextValue()
   {
-    switch (row->fetchNext()) {
+    switch (fetchingRow()->fetchNext()) {
 
     case MYSQL_DATA_TRUNCATED: {
       /*protocol->removeActiveStreamingResult();
@@ -378,53 +741,61 @@ namespace capi
         false);*/
     }
 
-    case MYSQL_NO_DATA: {
-      uint32_t serverStatus;
-      uint32_t warnings;
-
-      if (!eofDeprecated) {
-
-        protocol->readEofPacket();
-        warnings= warningCount();
-        serverStatus= protocol->getServerStatus();
+    case MYSQL_NO_DATA:
+      readEof();
+      return false;
 
-        // CallableResult has been read from intermediate EOF server_status
-        // and is mandatory because :
-        //
-        // - Call query will have an callable resultSet for OUT parameters
-        //   this resultSet must be identified and not listed in JDBC statement.getResultSet()
-        //
-        // - after a callable resultSet, a OK packet is send,
-        //   but mysql before 5.7.4 doesn't send MORE_RESULTS_EXISTS flag
-        if (callableResult) {
-          serverStatus|= MORE_RESULTS_EXISTS;
-        }
-      }
-      else {
-        // OK_Packet with a 0xFE header
-        // protocol->readOkPacket()?
-        serverStatus= protocol->getServerStatus();
-        warnings= warningCount();;
-        callableResult= (serverStatus & PS_OUT_PARAMETERS)!=0;
+    case 1:
+      if (capiStmtHandle != nullptr) {
+        throwStmtError(capiStmtHandle);
       }
-      protocol->setServerStatus(serverStatus);
-      protocol->setHasWarnings(warnings > 0);
+      break;
+    }
 
-      if ((serverStatus & MORE_RESULTS_EXISTS) == 0) {
-        protocol->removeActiveStreamingResult();
-      }
+    return true;
+  }
 
-      resetVariables();
-      return false;
+  /**
+    * Process the end of the result set.
+    */
+  void SelectResultSetCapi::readEof()
+  {
+    uint32_t serverStatus;
+    uint32_t warnings;
+
+    if (!eofDeprecated) {
+
+      protocol->readEofPacket();
+      warnings= warningCount();
+      serverStatus= protocol->getServerStatus();
+
+      // CallableResult has been read from intermediate EOF server_status
+      // and is mandatory because :
+      //
+      // - Call query will have an callable resultSet for OUT parameters
+      //   this resultSet must be identified and not listed in JDBC statement.getResultSet()
+      //
+      // - after a callable resultSet, a OK packet is send,
+      //   but mysql before 5.7.4 doesn't send MORE_RESULTS_EXISTS flag
+      if (callableResult) {
+        serverStatus|= MORE_RESULTS_EXISTS;
+      }
     }
+    else {
+      // OK_Packet with a 0xFE header
+      // protocol->readOkPacket()?
+      serverStatus= protocol->getServerStatus();
+      warnings= warningCount();;
+      callableResult= (serverStatus & PS_OUT_PARAMETERS)!=0;
     }
+    protocol->setServerStatus(serverStatus);
+    protocol->setHasWarnings(warnings > 0);
 
-
-    if (dataSize + 1 >= data.size()) {
-      growDataArray();
+    if ((serverStatus & MORE_RESULTS_EXISTS) == 0) {
+      protocol->removeActiveStreamingResult();
     }
-    //data[dataSize++]= ?;
-    return true;
+
+    resetVariables();
   }
 
   /**
@@ -432,8 +803,8 @@ namespace capi
     *
     * @return row's raw bytes
     */
-  std::vector<sql::bytes>& SelectResultSetCapi::getCurrentRowData() {
-    return data[rowPointer];
+  sql::bytes* SelectResultSetCapi::getCurrentRowData() {
+    return getRowData(rowPointer);
   }
 
   /**
@@ -444,8 +815,9 @@ namespace capi
     */
   void SelectResultSetCapi::updateRowData(std::vector<sql::bytes>& rawData)
   {
-    data[rowPointer]= rawData;
-    row->resetRow(data[rowPointer]);
+    // Previous values stay in the arena until the result set is closed
+    storeRow(getRowData(rowPointer), rawData);
+    row->resetRow(getRowData(rowPointer));
   }
 
   /**
@@ -455,21 +827,102 @@ namespace capi
     */
   void SelectResultSetCapi::deleteCurrentRowData() {
 
-    data.erase(data.begin()+lastRowPointer);
+    data.erase(data.begin() + lastRowPointer*columnInformationLength, data.begin() + (lastRowPointer + 1)*columnInformationLength);
     dataSize--;
     lastRowPointer= -1;
     previous();
   }
 
   void SelectResultSetCapi::addRowData(std::vector<sql::bytes>& rawData) {
-    if (dataSize +1 >= data.size()) {
-      growDataArray();
-    }
-    data[dataSize]= rawData;
+    data.resize((dataSize + 1)*columnInformationLength);
+    storeRow(getRowData(static_cast<int32_t>(dataSize)), rawData);
     rowPointer= static_cast<int32_t>(dataSize);
     dataSize++;
   }
 
+  /**
+    * Get values of the stored row.
+    *
+    * @param rowIndex index of the row
+    * @return pointer to the first value of the row
+    */
+  sql::bytes* SelectResultSetCapi::getRowData(int32_t rowIndex)
+  {
+    std::size_t memoryRows= data.size() / columnInformationLength;
+
+    if (spill && static_cast<std::size_t>(rowIndex) >= memoryRows) {
+      return spill->getRow(static_cast<std::size_t>(rowIndex) - memoryRows);
+    }
+    return data.data() + static_cast<std::size_t>(rowIndex)*columnInformationLength;
+  }
+
+  /**
+    * Copy row values to the arena, and point row values there.
+    *
+    * @param rowValues values of the stored row to set
+    * @param rawData row data to copy
+    */
+  void SelectResultSetCapi::storeRow(sql::bytes* rowValues, const std::vector<sql::bytes>& rawData)
+  {
+    for (int32_t i= 0; i < columnInformationLength; ++i) {
+      if (static_cast<std::size_t>(i) >= rawData.size() || rawData[i].arr == nullptr) {
+        rowValues[i].wrap(nullptr, 0);
+        continue;
+      }
+      std::size_t len= rawData[i].size();
+      char* value= arena.alloc(len);
+      std::memcpy(value, rawData[i].arr, len);
+      rowValues[i].wrap(value, len);
+    }
+  }
+
+  /**
+    * Allocate memory in the arena. Memory is freed only when the arena is cleared.
+    *
+    * @param size number of bytes to allocate
+    * @return pointer to the allocated memory
+    */
+  char* RowArena::alloc(std::size_t size)
+  {
+    size= (size + 7) & ~static_cast<std::size_t>(7);
+
+    if (size > free || pos == nullptr) {
+      std::size_t chunkSize= std::max(size, CHUNK_SIZE);
+      chunks.emplace_back(new char[chunkSize]);
+      allocated+= chunkSize;
+      pos= chunks.back().get();
+      free= chunkSize;
+    }
+    char* result= pos;
+    pos+= size;
+    free-= size;
+
+    return result;
+  }
+
+  /**
+    * Take over the memory of other arena. Allocations continue in the current chunk.
+    *
+    * @param other arena to take the memory from. It is empty afterwards
+    */
+  void RowArena::adopt(RowArena& other)
+  {
+    for (auto& chunk : other.chunks) {
+      chunks.push_back(std::move(chunk));
+    }
+    allocated+= other.allocated;
+    other.clear();
+  }
+
+
+  void RowArena::clear()
+  {
+    chunks.clear();
+    pos= nullptr;
+    free= 0;
+    allocated= 0;
+  }
+
   /*int32_t SelectResultSetCapi::skipLengthEncodedValue(std::string& buf, int32_t pos) {
     int32_t type= buf[pos++] &0xff;
     switch (type) {
@@ -501,17 +954,6 @@ namespace capi
     }
   }*/
 
-  /** Grow data array. */
-  void SelectResultSetCapi::growDataArray() {
-    int32_t newCapacity= static_cast<int32_t>(data.size() + (data.size() >>1));
-
-    if (newCapacity - MAX_ARRAY_SIZE > 0) {
-      newCapacity= MAX_ARRAY_SIZE;
-    }
-    // Commenting this out so far as we do not put data from server here, thus growing is in vain
-    //data.reserve(newCapacity);
-  }
-
   /**
     * Connection.abort() has been called, abort result-set.
     *
@@ -519,11 +961,13 @@ namespace capi
     */
   void SelectResultSetCapi::abort() {
     isClosedFlag= true;
+    readAhead= false;
+    stopReadAhead();
     resetVariables();
 
-    for (auto& row : data) {
-      row.clear();
-    }
+    data.clear();
+    arena.clear();
+    spill.reset();
 
     if (statement != nullptr) {
       statement->checkCloseOnCompletion(this);
@@ -537,6 +981,9 @@ namespace capi
     if (!isEof) {
       std::unique_lock<std::mutex> localScopeLock(*lock);
       try {
+        if (readAheadRequested && !cancelReadAhead()) {
+          readEof();
+        }
         while (!isEof) {
           dataSize= 0; // to avoid storing data
           readNextValue();
@@ -551,13 +998,12 @@ namespace capi
         throw handleIoException(ioe);
       }
     }
+    stopReadAhead();
     resetVariables();
 
-    for (size_t i= 0; i < data.size(); i++)
-    {
-      data[i].clear();
-
-    }
+    data.clear();
+    arena.clear();
+    spill.reset();
 
     if (statement != nullptr) {
       statement->checkCloseOnCompletion(this);
@@ -575,9 +1021,10 @@ namespace capi
   {
     ++rowPointer;
     if (data.size() > 0) {
-      row->resetRow(data[rowPointer]);
+      row->resetRow(getRowData(rowPointer));
     }
-    else {
+    // Streamed row, that has not been copied, is already fetched by the decoder
+    else if (!streaming) {
       if (row->fetchNext() == MYSQL_NO_DATA) {
         return false;
       }
@@ -636,9 +1083,10 @@ namespace capi
   void SelectResultSetCapi::resetRow()
   {
     if (data.size() > 0) {
-      row->resetRow(data[rowPointer]);
+      row->resetRow(getRowData(rowPointer));
     }
-    else {
+    // Streamed row, that has not been copied, is read from the decoder's buffers
+    else if (!streaming) {
       row->installCursorAtPosition(rowPointer);
     }
     lastRowPointer= rowPointer;
@@ -809,11 +1257,11 @@ namespace capi
 
     fetchRemaining();
 
-    if (row >= 0) {
+    if (rowPos >= 0) {
 
       if (static_cast<uint32_t>(rowPos) <= dataSize) {
         rowPointer= rowPos - 1;
-        row->installCursorAtPosition(rowPointer);
+        lastRowPointer= -1;
         return true;
       }
 
@@ -826,7 +1274,7 @@ namespace capi
       if (dataSize + rowPos >= 0) {
 
         rowPointer= static_cast<int32_t>(dataSize + rowPos);
-        row->installCursorAtPosition(rowPointer);
+        lastRowPointer= -1;
         return true;
       }
 
@@ -852,7 +1300,7 @@ namespace capi
     }
     else {
       rowPointer= newPos;
-      row->installCursorAtPosition(rowPointer);
+      lastRowPointer= -1;
       return true;
     }
   }
@@ -888,6 +1336,7 @@ namespace capi
     if (streaming &&fetchSize == 0) {
       std::lock_guard<std::mutex> localScopeLock(*lock);
       try {
+        readAhead= false;
 
         while (!isEof) {
           addStreamingValue();
@@ -984,6 +1433,47 @@ namespace capi
     return getString(findColumn(columnLabel));
   }
 
+  /**
+    * Get column value without copying it.
+    *
+    * @param columnIndex column index
+    * @param length [out] value length
+    * @return pointer to the value, valid until the cursor is moved, or NULL if the value is NULL
+    */
+  const char* SelectResultSetCapi::getStringView(int32_t columnIndex, std::size_t& length)
+  {
+    checkObjectRange(columnIndex);
+    return row->getInternalStringView(columnsInformation[columnIndex - 1].get(), length);
+  }
+
+  /** {inheritDoc}. */
+  const char* SelectResultSetCapi::getStringView(const SQLString& columnLabel, std::size_t& length) {
+    return getStringView(findColumn(columnLabel), length);
+  }
+
+  /**
+    * Append column value to the caller's buffer.
+    *
+    * @param columnIndex column index
+    * @param buffer string to append value to
+    * @return number of bytes appended
+    */
+  std::size_t SelectResultSetCapi::getString(int32_t columnIndex, SQLString& buffer)
+  {
+    std::size_t length;
+    const char* value= getStringView(columnIndex, length);
+
+    if (value != nullptr) {
+      buffer.append(value, length);
+    }
+    return length;
+  }
+
+  /** {inheritDoc}. */
+  std::size_t SelectResultSetCapi::getString(const SQLString& columnLabel, SQLString& buffer) {
+    return getString(findColumn(columnLabel), buffer);
+  }
+
 
   SQLString SelectResultSetCapi::zeroFillingIfNeeded(const SQLString& value, ColumnDefinition* columnInformation)
   {
@@ -1209,6 +1699,10 @@ namespace capi
 
   /** {inheritDoc}. */
   int32_t SelectResultSetCapi::findColumn(const SQLString& columnLabel) {
+    // Text protocol results get the index only if it is needed
+    if (!columnNameMap) {
+      columnNameMap.reset(new ColumnNameMap(columnsInformation));
+    }
     return columnNameMap->getIndex(columnLabel) + 1;
   }
 
@@ -1599,6 +2093,95 @@ namespace capi
     return dataSize;
   }
 
+  /**
+    * Reads up to maxRows rows, starting from the row next to the current, into the columnar batch.
+    * Rows are decoded by the row protocol directly into the column vectors, bypassing per-value getters.
+    *
+    * @param batch batch to fill. Its previous content is discarded, but allocated memory is reused
+    * @param maxRows maximum number of rows to read
+    * @return number of rows read. 0 means there are no more rows
+    */
+  std::size_t SelectResultSetCapi::fetchColumns(ColumnBatch& batch, std::size_t maxRows)
+  {
+    checkClose();
+
+    std::size_t expectedRows= 0;
+    if (streaming) {
+      expectedRows= std::min(maxRows, static_cast<std::size_t>(fetchSize));
+    }
+    else if (rowPointer + 1 < static_cast<int32_t>(dataSize)) {
+      expectedRows= std::min(maxRows, dataSize - static_cast<std::size_t>(rowPointer + 1));
+    }
+    initColumnBatch(batch, expectedRows);
+
+    std::size_t rowCount= 0;
+    while (rowCount < maxRows && next()) {
+      if ((rowCount & 7) == 0) {
+        for (auto& column : batch.columns) {
+          column.nulls.push_back(0);
+        }
+      }
+      if (lastRowPointer != rowPointer) {
+        resetRow();
+      }
+      row->appendToBatch(batch, rowCount, columnsInformation);
+      ++rowCount;
+    }
+    batch.rows= rowCount;
+    return rowCount;
+  }
+
+
+  void SelectResultSetCapi::initColumnBatch(ColumnBatch& batch, std::size_t expectedRows)
+  {
+    batch.rows= 0;
+    batch.columns.resize(columnInformationLength);
+
+    for (int32_t i= 0; i < columnInformationLength; ++i) {
+      ColumnBatch::Column& column= batch.columns[i];
+      ColumnDefinition* columnInfo= columnsInformation[i].get();
+
+      switch (columnInfo->getColumnType().getType()) {
+      case MYSQL_TYPE_BIT:
+      case MYSQL_TYPE_TINY:
+      case MYSQL_TYPE_SHORT:
+      case MYSQL_TYPE_LONG:
+      case MYSQL_TYPE_INT24:
+      case MYSQL_TYPE_LONGLONG:
+        column.kind= ColumnBatch::INT64;
+        break;
+      case MYSQL_TYPE_YEAR:
+        column.kind= options->yearIsDateType ? ColumnBatch::STRING : ColumnBatch::INT64;
+        break;
+      case MYSQL_TYPE_FLOAT:
+      case MYSQL_TYPE_DOUBLE:
+        column.kind= ColumnBatch::DOUBLE;
+        break;
+      default:
+        column.kind= ColumnBatch::STRING;
+      }
+      column.isUnsigned= !columnInfo->isSigned();
+
+      column.longs.clear();
+      column.doubles.clear();
+      column.data.clear();
+      column.offsets.assign(1, 0);
+      column.nulls.clear();
+
+      switch (column.kind) {
+      case ColumnBatch::INT64:
+        column.longs.reserve(expectedRows);
+        break;
+      case ColumnBatch::DOUBLE:
+        column.doubles.reserve(expectedRows);
+        break;
+      default:
+        column.offsets.reserve(expectedRows + 1);
+      }
+      column.nulls.reserve((expectedRows + 7) >> 3);
+    }
+  }
+
 #ifdef RS_UPDATE_FUNCTIONALITY_IMPLEMENTED
   /** {inheritDoc}. */
   void SelectResultSetCapi::updateNull(int32_t columnIndex) {
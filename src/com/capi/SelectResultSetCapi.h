@@ -23,9 +23,13 @@
 
 #include <exception>
 #include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 // Should go before Consts
 #include "com/capi/ColumnDefinitionCapi.h"
+#include "com/capi/RowSpillFile.h"
 
 #include "Consts.h"
 
@@ -54,6 +58,44 @@ namespace capi
 {
 #include "mysql.h"
 
+/* Memory for the values of the rows stored in the result set. Allocations are 8 bytes aligned, memory is freed only
+   all at once */
+struct RowArena
+{
+  /* Size of the chunk. Bigger values get dedicated chunk */
+  static const std::size_t CHUNK_SIZE= 64*1024;
+
+  std::vector<std::unique_ptr<char[]>> chunks;
+  char* pos;
+  std::size_t free;
+  /* Total size of the chunks */
+  std::size_t allocated;
+
+  RowArena() : pos(nullptr), free(0), allocated(0) {}
+  char* alloc(std::size_t size);
+  void adopt(RowArena& other);
+  void clear();
+};
+
+/* State shared by the result set with its read-ahead fetcher thread. Guarded by the mutex, except the cancelled flag */
+struct ReadAheadControl
+{
+  enum State { IDLE, REQUESTED, FETCHING, READY, STOPPED };
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  State state;
+  /* Number of rows to fetch for the request */
+  int32_t maxRows;
+  /* Results of the fetch, valid in the READY state */
+  bool hasMore;
+  std::exception_ptr error;
+  /* Makes the fetch stop at the next row */
+  std::atomic_bool cancelled;
+
+  ReadAheadControl() : state(IDLE), maxRows(0), hasMore(true), cancelled(false) {}
+};
+
 class SelectResultSetCapi : public SelectResultSet
 {
 
@@ -77,15 +119,19 @@ class SelectResultSetCapi : public SelectResultSet
   int32_t dataFetchTime;
   bool streaming;
 
-  /*std::unique_ptr<*/
-  std::vector<std::vector<sql::bytes>> data;
+  /* Values of the rows stored in the result set itself, i.e. not in the C/C result. They point to the arena chunks.
+     Row N starts at data[N*columnInformationLength] */
+  std::vector<sql::bytes> data;
   std::size_t dataSize; //Should go after data
+  RowArena arena;
+  /* Rows, that do not fit the memory limit. They go after the rows in data */
+  std::unique_ptr<RowSpillFile> spill;
 
   int32_t fetchSize;
   int32_t resultSetScrollType;
   int32_t rowPointer;
 
-  std::unique_ptr<ColumnNameMap> columnNameMap;
+  Shared::ColumnNameMap columnNameMap;
 
   int32_t lastRowPointer; /*-1*/
   bool isClosedFlag;
@@ -93,6 +139,20 @@ class SelectResultSetCapi : public SelectResultSet
   Shared::mutex lock;
   bool forceAlias;
 
+  /* Read-ahead of the streamed rows. While the application reads current rows, the fetcher thread fetches the next
+     fetchSize rows to readAheadData. The thread is started with the first request, and serves the result set until
+     all rows are fetched or the result set is closed */
+  bool readAhead;
+  std::vector<sql::bytes> readAheadData;
+  RowArena readAheadArena;
+  std::size_t readAheadSize;
+  /* Decoder, that fetches streamed rows when read-ahead is on, so that the fetcher does not share row with the
+     application's thread */
+  Unique::RowProtocol readAheadRow;
+  std::shared_ptr<ReadAheadControl> readAheadControl;
+  /* Rows have been requested from the fetcher, and not taken yet */
+  bool readAheadRequested;
+
 public:
 
   SelectResultSetCapi(
@@ -114,6 +174,8 @@ public:
     Protocol* protocol,
     int32_t resultSetScrollType);
 
+  ~SelectResultSetCapi();
+
   bool isFullyLoaded() const;
 
 private:
@@ -131,16 +193,27 @@ private:
   void nextStreamingValue();
   void addStreamingValue();
   bool readNextValue();
+  void readEof();
+  bool fetchRows(std::vector<sql::bytes>& values, RowArena& rowArena, std::size_t& rows, int32_t maxRows,
+    const std::atomic_bool& cancelled);
+  void copyFetchedRow(RowProtocol* fetcher, std::vector<sql::bytes>& values, RowArena& rowArena, std::size_t& rows);
+  void startReadAhead();
+  void readAheadLoop(std::shared_ptr<ReadAheadControl> control, Shared::mutex connectionLock);
+  bool takeReadAheadRows();
+  bool cancelReadAhead();
+  void stopReadAhead();
+  RowProtocol* fetchingRow();
+  void fetchAllRowsLimited(std::size_t memoryLimit);
+
+  void storeRow(sql::bytes* rowValues, const std::vector<sql::bytes>& rawData);
+  sql::bytes* getRowData(int32_t rowIndex);
 
 protected:
-  std::vector<sql::bytes>& getCurrentRowData();
+  sql::bytes* getCurrentRowData();
   void updateRowData(std::vector<sql::bytes>& rawData);
   void deleteCurrentRowData();
   void addRowData(std::vector<sql::bytes>& rawData);
 
-private:
-  void growDataArray();
-
 public:
   void abort();
   void close();
@@ -187,6 +260,10 @@ public:
   bool isNull(const SQLString& columnLabel);
   SQLString getString(int32_t columnIndex);
   SQLString getString(const SQLString& columnLabel);
+  const char* getStringView(int32_t columnIndex, std::size_t& length);
+  const char* getStringView(const SQLString& columnLabel, std::size_t& length);
+  std::size_t getString(int32_t columnIndex, SQLString& buffer);
+  std::size_t getString(const SQLString& columnLabel, SQLString& buffer);
 private:
   SQLString zeroFillingIfNeeded(const SQLString& value, ColumnDefinition* columnInformation);
 public:
@@ -282,6 +359,10 @@ public:
   void cancelRowUpdates();
 
   std::size_t rowsCount();
+  std::size_t fetchColumns(ColumnBatch& batch, std::size_t maxRows);
+private:
+  void initColumnBatch(ColumnBatch& batch, std::size_t expectedRows);
+public:
 
 #ifdef RS_UPDATE_FUNCTIONALITY_IMPLEMENTED
   void updateNull(int32_t columnIndex);
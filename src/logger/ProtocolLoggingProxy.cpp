@@ -249,6 +249,12 @@ namespace mariadb
 	}
 
 
+  bool ProtocolLoggingProxy::isClosedByServer()
+  {
+    return protocol->isClosedByServer();
+  }
+
+
   void ProtocolLoggingProxy::executeQuery(const SQLString& sql)
 	{
 		/* Add here logging if needed */
@@ -317,6 +323,14 @@ namespace mariadb
   }
 
 
+  bool ProtocolLoggingProxy::executeBulkArrays(ServerPrepareResult* serverPrepareResult, Shared::Results& results,
+    const std::vector<ParameterArray>& parameterArrays, std::size_t rowCount)
+  {
+    /* Add here logging if needed */
+    return protocol->executeBulkArrays(serverPrepareResult, results, parameterArrays, rowCount);
+  }
+
+
 	void ProtocolLoggingProxy::moveToNextResult(Results* results, ServerPrepareResult* spr)
 	{
 		/* Add here logging if needed */
@@ -496,6 +510,12 @@ namespace mariadb
 	}
 
 
+  void ProtocolLoggingProxy::deferReleasePrepareStatement(capi::MYSQL_STMT* statementId)
+  {
+    protocol->deferReleasePrepareStatement(statementId);
+  }
+
+
   void ProtocolLoggingProxy::forceReleaseWaitingPrepareStatement()
 	{
 		/* Add here logging if needed */
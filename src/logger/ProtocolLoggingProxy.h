@@ -82,6 +82,7 @@ public:
   const SQLString& getUsername() const;
   bool ping();
   bool isValid(int32_t timeout);
+  bool isClosedByServer();
   void executeQuery(const SQLString& sql);
   void executeQuery(bool mustExecuteOnMaster, Shared::Results& results, const SQLString& sql);
   void executeQuery(bool mustExecuteOnMaster, Shared::Results& results, const SQLString& sql, const Charset* charset);
@@ -94,6 +95,8 @@ public:
   void executePreparedQuery(bool mustExecuteOnMaster, ServerPrepareResult* serverPrepareResult, Shared::Results& results, std::vector<Shared::ParameterHolder>& parameters);
   bool executeBatchServer(bool mustExecuteOnMaster, ServerPrepareResult* serverPrepareResult, Shared::Results& results, const SQLString& sql,
                           std::vector<std::vector<Shared::ParameterHolder>>& parameterList, bool hasLongData);
+  bool executeBulkArrays(ServerPrepareResult* serverPrepareResult, Shared::Results& results,
+                         const std::vector<ParameterArray>& parameterArrays, std::size_t rowCount);
   void moveToNextResult(Results* results, ServerPrepareResult* spr=nullptr);
   void getResult(Results* results, ServerPrepareResult *pr=nullptr);
   void cancelCurrentQuery();
@@ -121,6 +124,7 @@ public:
   void setHostFailedWithoutProxy();
   void releasePrepareStatement(ServerPrepareResult* serverPrepareResult);
   bool forceReleasePrepareStatement(capi::MYSQL_STMT* statementId);
+  void deferReleasePrepareStatement(capi::MYSQL_STMT* statementId);
   void forceReleaseWaitingPrepareStatement();
   ServerPrepareStatementCache* prepareStatementCache();
   TimeZone* getTimeZone();
@@ -282,7 +282,7 @@ namespace sql
       {
         "cachePrepStmts", {"cachePrepStmts",
         "0.9.1",
-        "enable/disable prepare Statement cache, default true.",
+        "enable/disable prepare Statement cache, default false.",
         false,
         false}},
       {
@@ -675,6 +675,21 @@ namespace sql
         false,
         int32_t(0),
         int32_t(0) }},
+      {
+        "useReadAhead", {"useReadAhead",
+        "0.9.4",
+        "When streaming result set (fetch size > 0), read next fetch size rows from the server in a background "
+        "thread, while the application processes the current ones",
+        false,
+        false}},
+      {
+        "resultSetMemoryLimit", {"resultSetMemoryLimit",
+        "0.9.4",
+        "Memory limit in KB for the rows of a scrollable result set. Rows, that exceed the limit, are stored in a "
+        "temporary file. 0 means no limit, and all rows are kept in memory",
+        false,
+        int32_t(0),
+        int32_t(0) }},
       {
         "useMysqlMetadata", {"useMysqlMetadata",
         "0.9.1",
@@ -1022,7 +1037,7 @@ namespace sql
       if (options->rewriteBatchedStatements){
         options->useServerPrepStmts= false;
       }
-      if (options->pipe.empty()){
+      if (!options->pipe.empty()){
         options->useBatchMultiSend= false;
         options->usePipelineAuth= false;
       }
@@ -1032,12 +1047,10 @@ namespace sql
           options->minPoolSize == 0
           ? options->maxPoolSize
           : std::min(options->minPoolSize, options->maxPoolSize);
-
-        throw SQLFeatureNotImplementedException("Pool support is not implemented yet");
       }
 
-      if (options->cacheCallableStmts || options->cachePrepStmts) {
-        throw SQLFeatureNotImplementedException("Callable/Prepared statement caches are not supported yet");
+      if (options->cacheCallableStmts) {
+        throw SQLFeatureNotImplementedException("Callable statement cache is not supported yet");
       }
       if (options->defaultFetchSize < 0){
         options->defaultFetchSize= 0;
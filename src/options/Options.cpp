@@ -114,6 +114,8 @@ namespace mariadb
     OPTIONS_FIELD(includeThreadDumpInDeadlockExceptions),
     OPTIONS_FIELD(servicePrincipalName),
     OPTIONS_FIELD(defaultFetchSize),
+    OPTIONS_FIELD(useReadAhead),
+    OPTIONS_FIELD(resultSetMemoryLimit),
     OPTIONS_FIELD(tlsPeerFPList),
     OPTIONS_FIELD(log),
     OPTIONS_FIELD(profileSql),
@@ -362,6 +364,12 @@ namespace mariadb
     if (defaultFetchSize != opt->defaultFetchSize) {
       return false;
     }
+    if (useReadAhead != opt->useReadAhead) {
+      return false;
+    }
+    if (resultSetMemoryLimit != opt->resultSetMemoryLimit) {
+      return false;
+    }
     if (useBulkStmts != opt->useBulkStmts) {
       return false;
     }
@@ -604,6 +612,8 @@ namespace mariadb
     result= 31 *result + (includeThreadDumpInDeadlockExceptions ? 1 : 0);
     result= 31 *result + (useBulkStmts ? 1 : 0);
     result= 31 *result + defaultFetchSize;
+    result= 31 *result + (useReadAhead ? 1 : 0);
+    result= 31 *result + resultSetMemoryLimit;
     result= 31 *result + (disableSslHostnameVerification ? 1 : 0);
     result= 31 *result + (log ? 1 : 0);
     result= 31 *result + (profileSql ? 1 : 0);
@@ -109,6 +109,8 @@ struct Options
   bool      includeThreadDumpInDeadlockExceptions;
   SQLString servicePrincipalName;
   int32_t   defaultFetchSize;
+  bool      useReadAhead;
+  int32_t   resultSetMemoryLimit;
 
   Properties nonMappedOptions;
 
@@ -20,6 +20,8 @@
 
 #include "DoubleParameter.h"
 
+#include "util/Utils.h"
+
 namespace sql
 {
 namespace mariadb
@@ -33,7 +35,7 @@ namespace mariadb
 
   void DoubleParameter::writeTo(SQLString& str)
   {
-    str.append(std::to_string(value));
+    Utils::appendDouble(str, value);
   }
 
 
@@ -44,7 +46,7 @@ namespace mariadb
 
   int64_t DoubleParameter::getApproximateTextProtocolLength()
   {
-    return std::to_string(value).length();
+    return static_cast<int64_t>(Utils::doubleTextLength(value));
   }
 
   /**
@@ -20,6 +20,8 @@
 
 #include "FloatParameter.h"
 
+#include "util/Utils.h"
+
 namespace sql
 {
 namespace mariadb
@@ -32,7 +34,7 @@ namespace mariadb
 
   void FloatParameter::writeTo(SQLString& str)
   {
-    str.append(std::to_string(value));
+    Utils::appendDouble(str, value, 9);
   }
 
   void FloatParameter:: writeTo(PacketOutputStream& os)
@@ -42,7 +44,7 @@ namespace mariadb
 
   int64_t FloatParameter::getApproximateTextProtocolLength()
   {
-    return std::to_string(value).length();
+    return static_cast<int64_t>(Utils::doubleTextLength(value, 9));
   }
 
   /**
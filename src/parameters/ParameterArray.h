@@ -0,0 +1,63 @@
+/************************************************************************************
+   Copyright (C) 2020 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+#ifndef _PARAMETERARRAY_H_
+#define _PARAMETERARRAY_H_
+
+#include <cstddef>
+
+#include "ColumnType.h"
+
+namespace sql
+{
+namespace mariadb
+{
+/**
+  * Values of one parameter for all rows of the batch, as application has bound them with array setters.
+  * Application's buffers are not copied, and have to stay valid until the batch is executed.
+  */
+struct ParameterArray
+{
+  const ColumnType* columnType= nullptr;
+  /* Array of values of fixed length type, or array of pointers to strings, where nullptr means NULL value */
+  const void* values= nullptr;
+  /* Optional NULL flags of fixed length values */
+  const bool* nulls= nullptr;
+  /* Lengths of strings */
+  const std::size_t* lengths= nullptr;
+  /* Size of the fixed length type value, 0 for strings */
+  std::size_t valueSize= 0;
+  std::size_t rowCount= 0;
+  /* Set when the batch has been executed with the array. Arrays bound after that start new batch */
+  bool executed= false;
+
+  bool isNull(std::size_t row) const
+  {
+    return lengths != nullptr ? static_cast<const char* const*>(values)[row] == nullptr : (nulls != nullptr && nulls[row]);
+  }
+
+  std::size_t valueLength(std::size_t row) const
+  {
+    return lengths != nullptr ? lengths[row] : valueSize;
+  }
+};
+}
+}
+#endif
@@ -0,0 +1,256 @@
+/************************************************************************************
+   Copyright (C) 2020 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include <new>
+
+#include "ParameterSlot.h"
+#include "StringParameter.h"
+
+namespace sql
+{
+namespace mariadb
+{
+
+  ParameterSlot::ParameterSlot()
+    : tag(EMPTY)
+    , holder(nullptr)
+  {
+  }
+
+
+  ParameterSlot::ParameterSlot(const ParameterSlot& other)
+    : tag(EMPTY)
+    , holder(nullptr)
+  {
+    copy(other);
+  }
+
+
+  ParameterSlot::ParameterSlot(ParameterSlot&& other) noexcept
+    : tag(EMPTY)
+    , holder(nullptr)
+  {
+    if (other.tag == SHARED) {
+      Shared::ParameterHolder* shared= new (&storage) Shared::ParameterHolder(
+        std::move(*reinterpret_cast<Shared::ParameterHolder*>(&other.storage)));
+      holder= shared->get();
+      tag= SHARED;
+      other.destroy();
+    }
+    else {
+      copy(other);
+    }
+  }
+
+
+  ParameterSlot::~ParameterSlot()
+  {
+    destroy();
+  }
+
+
+  ParameterSlot& ParameterSlot::operator=(const ParameterSlot& other)
+  {
+    if (this != &other) {
+      copy(other);
+    }
+    return *this;
+  }
+
+
+  template <class HolderType, typename... Args>
+  void ParameterSlot::construct(Tag newTag, Args&&... args)
+  {
+    destroy();
+    holder= new (&storage) HolderType(std::forward<Args>(args)...);
+    tag= newTag;
+  }
+
+
+  void ParameterSlot::copy(const ParameterSlot& other)
+  {
+    switch (other.tag) {
+    case BOOLEAN:
+      construct<BooleanParameter>(BOOLEAN, *static_cast<const BooleanParameter*>(other.holder));
+      break;
+    case BYTE:
+      construct<ByteParameter>(BYTE, *static_cast<const ByteParameter*>(other.holder));
+      break;
+    case SHORT:
+      construct<ShortParameter>(SHORT, *static_cast<const ShortParameter*>(other.holder));
+      break;
+    case INT:
+      construct<IntParameter>(INT, *static_cast<const IntParameter*>(other.holder));
+      break;
+    case LONG:
+      construct<LongParameter>(LONG, *static_cast<const LongParameter*>(other.holder));
+      break;
+    case ULONG:
+      construct<ULongParameter>(ULONG, *static_cast<const ULongParameter*>(other.holder));
+      break;
+    case FLOAT:
+      construct<FloatParameter>(FLOAT, *static_cast<const FloatParameter*>(other.holder));
+      break;
+    case DOUBLE:
+      construct<DoubleParameter>(DOUBLE, *static_cast<const DoubleParameter*>(other.holder));
+      break;
+    case NULLVALUE:
+      construct<NullParameter>(NULLVALUE, *static_cast<const NullParameter*>(other.holder));
+      break;
+    case SMALLSTRING:
+      construct<SmallStringParameter>(SMALLSTRING, *static_cast<const SmallStringParameter*>(other.holder));
+      break;
+    case SHARED:
+    {
+      destroy();
+      Shared::ParameterHolder* shared= new (&storage) Shared::ParameterHolder(
+        *reinterpret_cast<const Shared::ParameterHolder*>(&other.storage));
+      holder= shared->get();
+      tag= SHARED;
+      break;
+    }
+    default:
+      destroy();
+    }
+  }
+
+
+  void ParameterSlot::destroy()
+  {
+    if (tag == SHARED) {
+      reinterpret_cast<Shared::ParameterHolder*>(&storage)->~shared_ptr();
+    }
+    else if (tag != EMPTY) {
+      holder->~ParameterHolder();
+    }
+    tag= EMPTY;
+    holder= nullptr;
+  }
+
+
+  void ParameterSlot::setBoolean(bool value)
+  {
+    construct<BooleanParameter>(BOOLEAN, value);
+  }
+
+
+  void ParameterSlot::setByte(int8_t value)
+  {
+    construct<ByteParameter>(BYTE, value);
+  }
+
+
+  void ParameterSlot::setShort(int16_t value)
+  {
+    construct<ShortParameter>(SHORT, value);
+  }
+
+
+  void ParameterSlot::setInt(int32_t value)
+  {
+    construct<IntParameter>(INT, value);
+  }
+
+
+  void ParameterSlot::setLong(int64_t value)
+  {
+    construct<LongParameter>(LONG, value);
+  }
+
+
+  void ParameterSlot::setULong(uint64_t value)
+  {
+    construct<ULongParameter>(ULONG, value);
+  }
+
+
+  void ParameterSlot::setFloat(float value)
+  {
+    construct<FloatParameter>(FLOAT, value);
+  }
+
+
+  void ParameterSlot::setDouble(double value)
+  {
+    construct<DoubleParameter>(DOUBLE, value);
+  }
+
+
+  void ParameterSlot::setNull(const ColumnType& type)
+  {
+    construct<NullParameter>(NULLVALUE, type);
+  }
+
+  /**
+    * Strings up to SmallStringParameter::MAX_LENGTH bytes are kept in the slot, longer ones are allocated.
+    */
+  void ParameterSlot::setString(const char* str, std::size_t length, bool noBackslashEscapes)
+  {
+    if (length <= SmallStringParameter::MAX_LENGTH) {
+      construct<SmallStringParameter>(SMALLSTRING, str, length, noBackslashEscapes);
+    }
+    else {
+      set(new StringParameter(SQLString(str, length), noBackslashEscapes));
+    }
+  }
+
+
+  void ParameterSlot::setString(const SQLString& str, bool noBackslashEscapes)
+  {
+    if (str.length() <= SmallStringParameter::MAX_LENGTH) {
+      construct<SmallStringParameter>(SMALLSTRING, str.c_str(), str.length(), noBackslashEscapes);
+    }
+    else {
+      set(new StringParameter(str, noBackslashEscapes));
+    }
+  }
+
+  /**
+    * Takes ownership of the holder of the type, that can't be kept in the slot.
+    *
+    * @param newHolder holder allocated with new
+    */
+  void ParameterSlot::set(ParameterHolder* newHolder)
+  {
+    Shared::ParameterHolder owner(newHolder);
+
+    destroy();
+    new (&storage) Shared::ParameterHolder(std::move(owner));
+    holder= newHolder;
+    tag= SHARED;
+  }
+
+
+  void ParameterSlot::reset()
+  {
+    destroy();
+  }
+
+  /**
+    * Returns pointer to the holder, that does not own it, and does not have reference counter. Copying of it is as
+    * cheap as copying of raw pointer. Valid as long as the slot is not changed or destroyed.
+    */
+  Shared::ParameterHolder ParameterSlot::view() const
+  {
+    return Shared::ParameterHolder(Shared::ParameterHolder(), holder);
+  }
+}
+}
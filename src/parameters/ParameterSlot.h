@@ -0,0 +1,108 @@
+/************************************************************************************
+   Copyright (C) 2020 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#ifndef _PARAMETERSLOT_H_
+#define _PARAMETERSLOT_H_
+
+#include <type_traits>
+
+#include "Consts.h"
+
+#include "BooleanParameter.h"
+#include "ByteParameter.h"
+#include "ShortParameter.h"
+#include "IntParameter.h"
+#include "LongParameter.h"
+#include "ULongParameter.h"
+#include "FloatParameter.h"
+#include "DoubleParameter.h"
+#include "NullParameter.h"
+#include "SmallStringParameter.h"
+
+namespace sql
+{
+namespace mariadb
+{
+/**
+  * Value of one parameter. Holders of scalar types, NULL and short strings are constructed in the slot itself, so
+  * setting of such value does not allocate, and copying of the slot to the batch does not touch any reference
+  * counter. Holders of other types are allocated and shared, since they are not changed after creation.
+  */
+class ParameterSlot
+{
+public:
+  enum Tag {
+    EMPTY,
+    BOOLEAN,
+    BYTE,
+    SHORT,
+    INT,
+    LONG,
+    ULONG,
+    FLOAT,
+    DOUBLE,
+    NULLVALUE,
+    SMALLSTRING,
+    SHARED
+  };
+
+private:
+  typedef std::aligned_union<0, BooleanParameter, ByteParameter, ShortParameter, IntParameter, LongParameter,
+    ULongParameter, FloatParameter, DoubleParameter, NullParameter, SmallStringParameter,
+    Shared::ParameterHolder>::type Storage;
+
+  Tag tag;
+  ParameterHolder* holder;
+  Storage storage;
+
+  template <class HolderType, typename... Args>
+  void construct(Tag newTag, Args&&... args);
+  void copy(const ParameterSlot& other);
+  void destroy();
+
+public:
+  ParameterSlot();
+  ParameterSlot(const ParameterSlot& other);
+  ParameterSlot(ParameterSlot&& other) noexcept;
+  ~ParameterSlot();
+  ParameterSlot& operator=(const ParameterSlot& other);
+
+  void setBoolean(bool value);
+  void setByte(int8_t value);
+  void setShort(int16_t value);
+  void setInt(int32_t value);
+  void setLong(int64_t value);
+  void setULong(uint64_t value);
+  void setFloat(float value);
+  void setDouble(double value);
+  void setNull(const ColumnType& type);
+  void setString(const char* str, std::size_t length, bool noBackslashEscapes);
+  void setString(const SQLString& str, bool noBackslashEscapes);
+  void set(ParameterHolder* newHolder);
+  void reset();
+
+  bool empty() const { return tag == EMPTY; }
+  ParameterHolder* get() const { return holder; }
+  Shared::ParameterHolder view() const;
+};
+}
+}
+#endif
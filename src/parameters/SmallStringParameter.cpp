@@ -0,0 +1,104 @@
+/************************************************************************************
+   Copyright (C) 2020 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include <cstring>
+
+#include "SmallStringParameter.h"
+
+#include "util/Utils.h"
+
+namespace sql
+{
+namespace mariadb
+{
+
+  SmallStringParameter::SmallStringParameter(const char* str, std::size_t _length, bool noBackslashEscapes)
+    : length(static_cast<uint8_t>(_length))
+    , noBackslashEscapes(noBackslashEscapes)
+  {
+    std::memcpy(stringValue, str, length);
+    stringValue[length]= '\0';
+  }
+
+
+  void SmallStringParameter::writeTo(PacketOutputStream& pos)
+  {
+    pos.write(SQLString(stringValue, length), true, noBackslashEscapes);
+  }
+
+
+  void SmallStringParameter::writeTo(SQLString& str)
+  {
+    str.append(QUOTE);
+    Utils::escapeData(stringValue, length, noBackslashEscapes, str);
+    str.append(QUOTE);
+  }
+
+
+  int64_t SmallStringParameter::getApproximateTextProtocolLength()
+  {
+    return length*3;
+  }
+
+  /**
+    * Write data to socket in binary format.
+    *
+    * @param pos socket output stream
+    * @throws IOException if socket error occur
+    */
+  void SmallStringParameter::writeBinary(PacketOutputStream& pos)
+  {
+    pos.writeFieldLength(length);
+    pos.write(stringValue, 0, length);
+  }
+
+  uint32_t SmallStringParameter::writeBinary(sql::bytes& buffer)
+  {
+    if (buffer.size() < length)
+    {
+      throw SQLException("Parameter buffer size is too small for string value");
+    }
+    std::memcpy(buffer.arr, stringValue, length);
+    return length;
+  }
+
+  const ColumnType& SmallStringParameter::getColumnType() const
+  {
+    return ColumnType::STRING;
+  }
+
+  SQLString SmallStringParameter::toString()
+  {
+    SQLString result("'");
+    return result.append(stringValue, length).append('\'');
+  }
+
+  bool SmallStringParameter::isNullData() const
+  {
+    return false;
+  }
+
+  bool SmallStringParameter::isLongData()
+  {
+    return false;
+  }
+}
+}
@@ -18,365 +18,596 @@
 *************************************************************************************/
 
 
+
+#include <chrono>
+#include <algorithm>
+
 #include "Pool.h"
+#include "MariaDbPooledConnection.h"
+#include "ExceptionMapper.h"
+#include "logger/LoggerFactory.h"
+#include "util/Utils.h"
+#include "Results.h"
 
 namespace sql
 {
 namespace mariadb
 {
-  const Shared::Logger logger= LoggerFactory::getLogger(typeid(Pool));
-  int32_t Pool::POOL_STATE_OK= 0;
-  int32_t Pool::POOL_STATE_CLOSING= 1;
+  const Shared::Logger Pool::logger= LoggerFactory::getLogger(typeid(Pool));
+  const int32_t Pool::POOL_STATE_OK;
+  const int32_t Pool::POOL_STATE_CLOSING;
+  const int32_t Pool::MAX_CONCURRENT_CONNECTS;
+  const int32_t Pool::IDLE_REFILL_THRESHOLD;
+  const int64_t Pool::AFFINITY_WINDOW_NANOS;
+
+  /* Source of pool generation ids. 0 is never given out, and means no pool */
+  static std::atomic<uint64_t> generationCounter(0);
+
+  /* Slot the thread has given connection back to last time, and generation of the pool it belongs to */
+  struct PoolAffinity
+  {
+    uint64_t generation;
+    int32_t slot;
+  };
+  static thread_local PoolAffinity affinity= { 0, 0 };
+
+  static int64_t nanosNow()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
 
   /**
-    * Create pool from configuration.
+    * Read session transaction isolation level of the new pool connection. The query goes directly through the protocol,
+    * since no connection object exists for it yet.
     *
-    * @param urlParser configuration parser
-    * @param poolIndex pool index to permit distinction of thread name
-    * @param poolExecutor pools common executor
+    * @param protocol protocol of the new connection
+    * @return transaction isolation level
+    * @throws SQLException if the level cannot be read
     */
-  Pool::Pool(UrlParser &urlParser, int32_t poolIndex, ScheduledThreadPoolExecutor& poolExecutor) :
-    urlParser(urlParser),
-    options(urlParser.getOptions()),
-    maxIdleTime(options->maxIdleTime)
-  {
-    poolTag= generatePoolTag(poolIndex);
-
-    connectionAppenderQueue= new ArrayBlockingQueue<>(options->maxPoolSize);
-    connectionAppender =
-      new ThreadPoolExecutor(
-        1,
-        1,
-        10,
-        TimeUnit::SECONDS,
-        connectionAppenderQueue,
-        new MariaDbThreadFactory(poolTag +"-appender"));
-    connectionAppender.allowCoreThreadTimeOut(true);
-
-    connectionAppender.prestartCoreThread();
-
-    idleConnections= new LinkedBlockingDeque<>();
-
-    int32_t scheduleDelay= Math.min(30, maxIdleTime 2);
-    this->poolExecutor= poolExecutor;
-    scheduledFuture =
-      poolExecutor.scheduleAtFixedRate(
-        this::removeIdleTimeoutConnection, scheduleDelay, scheduleDelay, TimeUnit.SECONDS);
-
-    try
+  static int32_t queryTransactionIsolation(Shared::Protocol& protocol)
+  {
+    SQLString sql("SELECT @@tx_isolation");
+
+    if (!protocol->isServerMariaDb())
     {
-      for (int32_t i= 0; i <options->minPoolSize; i++) {
-        addConnection();
+      if ((protocol->getMajorServerVersion()>=8 &&protocol->versionGreaterOrEqual(8, 0, 3))
+        ||(protocol->getMajorServerVersion()<8 &&protocol->versionGreaterOrEqual(5, 7, 20)))
+      {
+        sql= "SELECT @@transaction_isolation";
       }
     }
-    catch (Exception& ex) {
-      logger.error("error initializing pool connection", sqle);
+    Shared::Results results(new Results());
+    std::lock_guard<std::mutex> localScopeLock(*protocol->getLock());
+
+    protocol->executeQuery(false, results, sql);
+    results->commandEnd();
+    ResultSet* rs= results->getResultSet();
+
+    if (rs != nullptr && rs->next())
+    {
+      const SQLString response(rs->getString(1));
+
+      if (response.compare("REPEATABLE-READ") == 0)
+      {
+        return sql::TRANSACTION_REPEATABLE_READ;
+      }
+      else if (response.compare("READ-UNCOMMITTED") == 0)
+      {
+        return sql::TRANSACTION_READ_UNCOMMITTED;
+      }
+      else if (response.compare("READ-COMMITTED") == 0)
+      {
+        return sql::TRANSACTION_READ_COMMITTED;
+      }
+      else if (response.compare("SERIALIZABLE") == 0)
+      {
+        return sql::TRANSACTION_SERIALIZABLE;
+      }
+      throw SQLException("Could not get transaction isolation level: Invalid value \"" + response + "\"");
     }
+    throw SQLException("Failed to retrieve transaction isolation");
   }
 
   /**
-    * Add new connection if needed. Only one thread create new connection, so new connection request
-    * will wait to newly created connection or for a released connection.
+    * Create pool from configuration.
+    *
+    * @param urlParser configuration parser
+    * @param poolIndex pool index to permit distinction of thread name
     */
-  void Pool::addConnectionRequest()
+  Pool::Pool(std::shared_ptr<UrlParser>& _urlParser, int32_t poolIndex)
+    : poolState(POOL_STATE_OK)
+    , generation(generationCounter.fetch_add(1) + 1)
+    , urlParser(_urlParser)
+    , options(_urlParser->getOptions())
+    , maxPoolSize(options->maxPoolSize)
+    , minPoolSize(options->minPoolSize)
+    , pendingRequestNumber(0)
+    , totalConnection(0)
+    , connectingCount(0)
+    , maxConnecting(std::min(options->maxPoolSize, MAX_CONCURRENT_CONNECTS))
+    , idleCount(0)
+    , idleConnections(new IdleSlot[options->maxPoolSize])
+    , poolTag(generatePoolTag(poolIndex))
+    , maxIdleTime(options->maxIdleTime)
+    , connectionsCreated(0)
+    , connectionsFailed(0)
+    , validationsFailed(0)
+    , connectionTimeouts(0)
   {
-    if (totalConnection.get() < options->maxPoolSize && poolState.get() == POOL_STATE_OK)
-    {
-      connectionAppender.prestartCoreThread();
-      connectionAppenderQueue.offer(
-        ()->{
-        if ((totalConnection.get()<options->minPoolSize ||pendingRequestNumber.get()>0)
-          &&totalConnection.get()<options->maxPoolSize) {
-          try {
-            addConnection();
-          }
-          catch (SQLException&)
-          {
-          }
-        }
-      });
+    for (int32_t i= 0; i < maxPoolSize; ++i) {
+      idleConnections[i].item.store(nullptr);
+      idleConnections[i].releasedAt.store(0);
     }
   }
 
   /**
-    * Removing idle connection. Close them and recreate connection to reach minimal number of
-    * connection.
+    * Create pool, and start its housekeeping thread, that removes connections idle for too long, and connection
+    * appender threads, that start opening minPoolSize connections in parallel right away.
+    *
+    * @param urlParser configuration parser
+    * @param poolIndex pool index to permit distinction of thread name
+    * @return new pool
     */
-  void Pool::removeIdleTimeoutConnection()
+  Shared::Pool Pool::newInstance(std::shared_ptr<UrlParser>& urlParser, int32_t poolIndex)
   {
-    Iterator<MariaDbPooledConnection>iterator= idleConnections.descendingIterator();
-    MariaDbPooledConnection item;
+    Shared::Pool pool(new Pool(urlParser, poolIndex));
+    pool->self= pool;
+    pool->houseKeeper= std::thread(&Pool::houseKeeping, pool.get());
+    for (int32_t i= 0; i < pool->maxConnecting; ++i) {
+      pool->connectionAppender.emplace_back(&Pool::appendConnections, pool.get());
+    }
+    return pool;
+  }
 
-    while (iterator.hasNext())
-    {
-      item= iterator.next();
 
-      int64_t idleTime= System.nanoTime()-item.getLastUsed().get();
-      bool timedOut= idleTime >TimeUnit.SECONDS.toNanos(maxIdleTime);
+  Pool::~Pool()
+  {
+    close();
+  }
 
-      bool shouldBeReleased= false;
 
-      if (globalInfo) {
+  void Pool::houseKeeping()
+  {
+    const std::chrono::seconds scheduleDelay(std::max(1, std::min(30, maxIdleTime / 2)));
+    std::unique_lock<std::mutex> localScopeLock(houseKeepingLock);
 
+    while (poolState.load() == POOL_STATE_OK) {
+      localScopeLock.unlock();
+      removeIdleTimeoutConnection();
+      addConnectionRequest();
+      localScopeLock.lock();
+      houseKeepingWakeUp.wait_for(localScopeLock, scheduleDelay, [this]() {
+        return poolState.load() != POOL_STATE_OK;
+      });
+    }
+  }
 
-        if (idleTime >TimeUnit.SECONDS.toNanos(globalInfo.getWaitTimeout()-45)) {
-          shouldBeReleased= true;
-        }
+  /**
+    * Removing idle connection. Close them and remove them from idle slots, if the pool has more than minPoolSize
+    * connections. Connections idle for too long are validated otherwise, so that the server does not close them
+    * because of wait_timeout.
+    */
+  void Pool::removeIdleTimeoutConnection()
+  {
+    const int64_t maxIdleNanos= static_cast<int64_t>(maxIdleTime)*1000000000LL;
 
+    for (int32_t i= 0; i < maxPoolSize && poolState.load() == POOL_STATE_OK; ++i) {
+      // Connection has to be taken from the slot, before it can be looked at - otherwise it could be gone by then
+      MariaDbPooledConnection* item= takeIdleConnection(i);
+      if (item == nullptr) {
+        continue;
+      }
+      const int64_t releasedAt= idleConnections[i].releasedAt.load(std::memory_order_relaxed);
 
-        if (timedOut &&totalConnection.get()>options->minPoolSize) {
-          shouldBeReleased= true;
+      if (nanosNow() - item->getLastUsed() <= maxIdleNanos) {
+        restoreIdleConnection(i, item, releasedAt);
+      }
+      else if (totalConnection.load() > minPoolSize || !validate(item)) {
+        silentCloseConnection(item);
+      }
+      else {
+        restoreIdleConnection(i, item, releasedAt);
+      }
+    }
+  }
+
+  /**
+    * Put connection back to the slot it's been taken from, or to any other free slot if that is already taken.
+    * The connection keeps the time it has been given back to the pool, and the current thread does not become
+    * affine to the slot.
+    *
+    * @param slot slot index, connection has been taken from
+    * @param item connection
+    * @param releasedAt time the connection has been given back to the pool
+    */
+  void Pool::restoreIdleConnection(int32_t slot, MariaDbPooledConnection* item, int64_t releasedAt)
+  {
+    if (putIdleConnection(slot, item, releasedAt)) {
+      return;
+    }
+    while (true) {
+      for (int32_t i= 0; i < maxPoolSize; ++i) {
+        if (putIdleConnection(i, item, releasedAt)) {
+          return;
         }
+      }
+      std::this_thread::yield();
+    }
+  }
+
 
+  /**
+    * Connection appender thread. Adds connections while the pool has fewer than minPoolSize of them, or runs low
+    * on idle ones. Waits a second after a failure, not to hammer the server that is down.
+    */
+  void Pool::appendConnections()
+  {
+    std::unique_lock<std::mutex> localScopeLock(appenderLock);
+
+    while (poolState.load() == POOL_STATE_OK) {
+      appenderWakeUp.wait(localScopeLock, [this]() {
+        return poolState.load() != POOL_STATE_OK || needConnection();
+      });
+      if (poolState.load() != POOL_STATE_OK) {
+        break;
       }
-      else if (timedOut) {
-        shouldBeReleased= true;
+      localScopeLock.unlock();
+      bool failed= reserveConnection() && !addConnection();
+      localScopeLock.lock();
+
+      if (failed) {
+        appenderWakeUp.wait_for(localScopeLock, std::chrono::seconds(1), [this]() {
+          return poolState.load() != POOL_STATE_OK;
+        });
       }
+    }
+  }
 
-      if (shouldBeReleased &&idleConnections.remove(item)) {
+  /**
+    * Wake up a connection appender, if the pool needs one more connection.
+    */
+  void Pool::addConnectionRequest()
+  {
+    if (needConnection()) {
+      // Taking the lock guarantees, that the appender either sees the changed state, or already waits
+      std::lock_guard<std::mutex> localScopeLock(appenderLock);
+      appenderWakeUp.notify_one();
+    }
+  }
 
-        totalConnection.decrementAndGet();
-        silentCloseConnection(item);
-        addConnectionRequest();
-        if (logger.isDebugEnabled()) {
-          logger.debug(
-            "pool {} connection removed due to inactivity (total:{}, active:{}, pending:{})",
-            poolTag,
-            totalConnection.get(),
-            getActiveConnections(),
-            pendingRequestNumber.get());
-        }
 
+  bool Pool::needConnection() const
+  {
+    int32_t total= totalConnection.load();
+    int32_t connecting= connectingCount.load();
 
-      }
+    if (total >= maxPoolSize || connecting >= maxConnecting) {
+      return false;
     }
+    return total < minPoolSize || idleCount.load() + connecting < IDLE_REFILL_THRESHOLD;
   }
 
   /**
-    * Create new connection.
+    * Create new connection, that has been reserved by the caller, and add it to the idle ones.
     *
-    * @throws SQLException if connection creation failed
+    * @return true if the connection has been added
     */
-  void Pool::addConnection() {
+  bool Pool::addConnection()
+  {
+    MariaDbPooledConnection* item;
+    try {
+      item= createPoolConnection();
+    }
+    catch (SQLException& sqle) {
+      logger->error("error adding connection to the pool", sqle);
+      return false;
+    }
 
-    Protocol& protocol= Utils::retrieveProxy(urlParser, globalInfo);
-    MariaDbConnection connection= new MariaDbConnection(protocol);
-    MariaDbPooledConnection pooledConnection= createPoolConnection(connection);
+    releaseConnection(item);
+    return true;
+  }
 
-    if (options->staticGlobal) {
+  /**
+    * Reserve new connection in the connection counts, if the pool has less than maxPoolSize connections, and
+    * less than maxConnecting of them are being established. Thread that did it, has to create the connection with
+    * createPoolConnection.
+    *
+    * @return true if the thread may create new connection
+    */
+  bool Pool::reserveConnection()
+  {
+    int32_t connecting= connectingCount.load();
 
-      if (globalInfo) {
-        initializePoolGlobalState(connection);
+    do {
+      if (connecting >= maxConnecting) {
+        return false;
       }
+    } while (!connectingCount.compare_exchange_weak(connecting, connecting + 1));
+
+    int32_t current= totalConnection.load();
 
-      connection.setDefaultTransactionIsolation(globalInfo.getDefaultTransactionIsolation());
+    while (current < maxPoolSize) {
+      if (totalConnection.compare_exchange_weak(current, current + 1)) {
+        return true;
+      }
     }
-    else {
+    connectingCount.fetch_sub(1);
+    notifyWaiter();
+    return false;
+  }
+
+  /**
+    * Take idle connection from the slot, the thread has given connection back to last time. Otherwise, from the
+    * lowest occupied slot, skipping connections given back just now, as their threads will likely come for them.
+    *
+    * @return connection or nullptr, if there is no idle connection
+    */
+  MariaDbPooledConnection* Pool::pollIdleConnection()
+  {
+    MariaDbPooledConnection* item;
 
-      connection.setDefaultTransactionIsolation(connection.getTransactionIsolation());
+    if (isAffineThread() && (item= takeIdleConnection(affinity.slot)) != nullptr) {
+      addConnectionRequest();
+      return item;
+    }
+    if (idleCount.load() == 0) {
+      return nullptr;
     }
 
-    if (poolState.get()==POOL_STATE_OK
-      &&totalConnection.incrementAndGet()<=options->maxPoolSize) {
-      idleConnections.addFirst(pooledConnection);
+    const int64_t affinityEnd= nanosNow() - AFFINITY_WINDOW_NANOS;
 
-      if (logger.isDebugEnabled()) {
-        logger.debug(
-          "pool {} new physical connection created (total:{}, active:{}, pending:{})",
-          poolTag,
-          totalConnection.get(),
-          getActiveConnections(),
-          pendingRequestNumber.get());
+    for (int32_t i= 0; i < maxPoolSize; ++i) {
+      if (idleConnections[i].releasedAt.load(std::memory_order_relaxed) < affinityEnd
+        && (item= takeIdleConnection(i)) != nullptr) {
+        addConnectionRequest();
+        return item;
       }
-      return;
     }
-
-    silentCloseConnection(pooledConnection);
+    for (int32_t i= 0; i < maxPoolSize; ++i) {
+      if ((item= takeIdleConnection(i)) != nullptr) {
+        addConnectionRequest();
+        return item;
+      }
+    }
+    return nullptr;
   }
 
-  MariaDbPooledConnection Pool::getIdleConnection() {
-    return getIdleConnection(0, TimeUnit.NANOSECONDS);
+  /**
+    * Whether current thread has used a slot of this pool.
+    */
+  bool Pool::isAffineThread() const
+  {
+    return affinity.generation == generation;
   }
 
   /**
-    * Get an existing idle connection in pool.
+    * Take connection from the slot.
     *
-    * @return an IDLE connection.
+    * @param slot slot index
+    * @return connection or nullptr, if the slot is empty, or has been emptied concurrently
     */
-  MariaDbPooledConnection Pool::getIdleConnection(int64_t timeout, TimeUnit timeUnit) {
-
-
-    while (true) {
-      MariaDbPooledConnection item =
-        (timeout ==0)
-        ? idleConnections.pollFirst()
-        : idleConnections.pollFirst(timeout, timeUnit);
+  MariaDbPooledConnection* Pool::takeIdleConnection(int32_t slot)
+  {
+    MariaDbPooledConnection* item= idleConnections[slot].item.load();
 
-      if (item) {
-        MariaDbConnection connection= item.getConnection();
-        try {
-          if (TimeUnit.NANOSECONDS.toMillis(System.nanoTime()-item.getLastUsed().get())
->options->poolValidMinDelay) {
+    if (item != nullptr && idleConnections[slot].item.compare_exchange_strong(item, nullptr)) {
+      idleCount.fetch_sub(1);
+      return item;
+    }
+    return nullptr;
+  }
 
+  /**
+    * Put connection to the slot, if it is free.
+    *
+    * @param slot slot index
+    * @param item connection
+    * @param releasedAt time the connection has been given back to the pool
+    * @return true if the connection has been put to the slot
+    */
+  bool Pool::putIdleConnection(int32_t slot, MariaDbPooledConnection* item, int64_t releasedAt)
+  {
+    MariaDbPooledConnection* expected= nullptr;
 
-            if (connection.isValid(10)) {
-              item.lastUsedToNow();
-              return item;
-            }
+    if (idleConnections[slot].item.compare_exchange_strong(expected, item)) {
+      idleConnections[slot].releasedAt.store(releasedAt, std::memory_order_relaxed);
+      idleCount.fetch_add(1);
+      notifyWaiter();
+      return true;
+    }
+    return false;
+  }
 
-          }
-          else {
+  /**
+    * Put connection to the slot the thread has used last time, or to the lowest free slot, that becomes the
+    * thread's slot. Connections never outnumber slots, so there is always a free one, but it can be freed
+    * concurrently with the scan.
+    *
+    * @param item connection
+    */
+  void Pool::pushIdleConnection(MariaDbPooledConnection* item)
+  {
+    const int64_t releasedAt= nanosNow();
 
+    if (isAffineThread() && putIdleConnection(affinity.slot, item, releasedAt)) {
+      return;
+    }
+    while (true) {
+      for (int32_t i= 0; i < maxPoolSize; ++i) {
+        if (putIdleConnection(i, item, releasedAt)) {
+          affinity.generation= generation;
+          affinity.slot= i;
+          return;
+        }
+      }
+      std::this_thread::yield();
+    }
+  }
 
-            item.lastUsedToNow();
-            return item;
-          }
+  /**
+    * Get an idle connection, or create new one if the pool has less than maxPoolSize connections, and not too
+    * many are being created already. Otherwise wait until a connection is given back to the pool, or added to it.
+    *
+    * @param timeoutMs time to wait in milliseconds. 0 means no limit
+    * @return connection
+    * @throws SQLException if no connection became available in time, or new connection could not be created
+    */
+  MariaDbPooledConnection* Pool::getIdleConnection(int64_t timeoutMs)
+  {
+    const auto deadline= std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
 
-        }
-        catch (SQLException& sqle) {
+    while (poolState.load() == POOL_STATE_OK) {
+      MariaDbPooledConnection* item= pollIdleConnection();
 
+      if (item != nullptr) {
+        if (validate(item)) {
+          return item;
         }
+        silentCloseConnection(item);
+        continue;
+      }
 
-        totalConnection.decrementAndGet();
+      if (reserveConnection()) {
+        return createPoolConnection();
+      }
 
+      std::unique_lock<std::mutex> localScopeLock(waitLock);
+      // Whoever makes a connection available after the request is counted, will notify us under the lock
+      pendingRequestNumber.fetch_add(1);
+      bool timedOut= false;
 
-        silentAbortConnection(item);
-        addConnectionRequest();
-        if (logger.isDebugEnabled()) {
-          logger.debug(
-            "pool {} connection removed from pool due to failed validation (total:{}, active:{}, pending:{})",
-            poolTag,
-            totalConnection.get(),
-            getActiveConnections(),
-            pendingRequestNumber.get());
+      if (idleCount.load() == 0 && !canConnect() && poolState.load() == POOL_STATE_OK) {
+        if (timeoutMs > 0) {
+          timedOut= connectionAvailable.wait_until(localScopeLock, deadline) == std::cv_status::timeout;
+        }
+        else {
+          connectionAvailable.wait(localScopeLock);
         }
-        continue;
       }
+      pendingRequestNumber.fetch_sub(1);
 
-      return NULL;
+      if (timedOut && idleCount.load() == 0 && !canConnect()) {
+        connectionTimeouts.fetch_add(1, std::memory_order_relaxed);
+        throw ExceptionMapper::connException(
+          "No connection available within the specified time (option 'connectTimeout': "
+          + std::to_string(options->connectTimeout) + " ms)");
+      }
     }
+    throw ExceptionMapper::connException("Pool " + poolTag + " is closed");
   }
 
-  void Pool::silentCloseConnection(MariaDbPooledConnection item) {
-    try {
-      item.close();
+  /**
+    * Check connection before giving it to the application. Connection used recently, i.e. within
+    * poolValidMinDelay, is considered valid.
+    *
+    * @param item connection
+    * @return true if connection can be used
+    */
+  bool Pool::validate(MariaDbPooledConnection* item)
+  {
+    // Connection closed by the server is detected without the round trip, regardless of poolValidMinDelay
+    if (item->isBroken() || item->getProtocol()->isClosedByServer()) {
+      validationsFailed.fetch_add(1, std::memory_order_relaxed);
+      return false;
     }
-    catch (SQLException& ex) {
-
+    if (nanosNow() - item->getLastUsed() > static_cast<int64_t>(options->poolValidMinDelay)*1000000LL) {
+      bool valid;
+      try {
+        // 10s, same as the connection would use
+        valid= item->getProtocol()->isValid(10000);
+      }
+      catch (SQLException&) {
+        valid= false;
+      }
+      if (!valid) {
+        validationsFailed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
     }
+    item->lastUsedToNow();
+    return true;
   }
 
-  void Pool::silentAbortConnection(MariaDbPooledConnection item) {
-    try {
-      item.abort(poolExecutor);
-    }
-    catch (SQLException& ex) {
-
-    }
+  /**
+    * Close connection, that is not needed anymore or cannot be used, and update the pool's counters.
+    *
+    * @param item connection
+    */
+  void Pool::silentCloseConnection(MariaDbPooledConnection* item)
+  {
+    connectionLifetime.record(static_cast<uint64_t>(nanosNow() - item->getCreationTime())/1000000);
+    delete item;
+    totalConnection.fetch_sub(1);
+    notifyWaiter();
+    addConnectionRequest();
   }
 
-  MariaDbPooledConnection Pool::createPoolConnection(MariaDbConnection connection) {
-    MariaDbPooledConnection pooledConnection= new MariaDbPooledConnection(connection);
-    pooledConnection.addConnectionEventListener(
-      new ConnectionEventListener(){
-
-      @Override
-      void Pool::connectionClosed(ConnectionEvent event) {
-      MariaDbPooledConnection item =(MariaDbPooledConnection)event.getSource();
-      if (poolState.get()==POOL_STATE_OK) {
-      try {
-      if (!(idleConnections.find_first_of(item) >= 0)) {
-      item.getConnection().reset();
-      idleConnections.addFirst(item);
-      }
-      }
-      catch (SQLException& sqle) {
 
+  void Pool::notifyWaiter()
+  {
+    if (pendingRequestNumber.load() > 0) {
+      std::lock_guard<std::mutex> localScopeLock(waitLock);
+      connectionAvailable.notify_one();
+    }
+  }
 
-      totalConnection.decrementAndGet();
-      silentCloseConnection(item);
-      logger.debug("connection removed from pool {} due to error during reset",poolTag);
-      }
-      }
-      else {
+  /**
+    * Create new physical connection. Caller must have reserved it with reserveConnection.
+    *
+    * @return new pool connection
+    * @throws SQLException if connection could not be established
+    */
+  MariaDbPooledConnection* Pool::createPoolConnection()
+  {
+    std::unique_ptr<MariaDbPooledConnection> item;
 
     try {
-    item.close();
-    }
-    catch (SQLException& sqle) {
+      // Protocol takes ownership of the parser it gets
+      Shared::Protocol protocol(Utils::retrieveProxy(*urlParser->clone(), nullptr));
 
+      item.reset(new MariaDbPooledConnection(protocol, self));
+      item->setDefaultTransactionIsolation(queryTransactionIsolation(protocol));
     }
-    totalConnection.decrementAndGet();
-    }
+    catch (SQLException&) {
+      connectionsFailed.fetch_add(1, std::memory_order_relaxed);
+      totalConnection.fetch_sub(1);
+      connectingCount.fetch_sub(1);
+      notifyWaiter();
+      throw;
     }
+    connectionsCreated.fetch_add(1, std::memory_order_relaxed);
+    connectingCount.fetch_sub(1);
+    notifyWaiter();
+
+    return item.release();
+  }
 
-    @Override
-    void Pool::connectionClosed(ConnectionEvent event) {
 
-    MariaDbPooledConnection item =((MariaDbPooledConnection)event.getSource());
-    if (idleConnections.remove(item)) {
-    totalConnection.decrementAndGet();
-    }
-    silentCloseConnection(item);
-    addConnectionRequest();
-    logger.debug(
-    "connection {} removed from pool {} due to having throw a Connection* exception (total:{}, active:{}, pending:{})",
-    item.getConnection().getServerThreadId(),
-    poolTag,
-    totalConnection.get(),
-    getActiveConnections(),
-    pendingRequestNumber.get());
-    }
-      });
-    return pooledConnection;
+  bool Pool::canConnect() const
+  {
+    return totalConnection.load() < maxPoolSize && connectingCount.load() < maxConnecting;
   }
 
   /**
-    * Retrieve new connection. If possible return idle connection, if not, stack connection query,
-    * ask for a connection creation, and loop until a connection become idle / a new connection is
-    * created.
+    * Retrieve new connection. If possible return idle connection, if not, create new one, or wait until a
+    * connection is given back to the pool.
     *
     * @return a connection object
     * @throws SQLException if no connection is created when reaching timeout (connectTimeout option)
     */
   MariaDbConnection* Pool::getConnection()
   {
-    pendingRequestNumber.incrementAndGet();
+    const int64_t start= nanosNow();
+    MariaDbPooledConnection* item= getIdleConnection(options->connectTimeout);
 
-    MariaDbPooledConnection pooledConnection;
+    checkoutWaitTime.record(static_cast<uint64_t>(nanosNow() - start)/1000);
 
     try {
-
-
-      if ((pooledConnection =
-        getIdleConnection(totalConnection.get()>4 ? 0 : 50, TimeUnit.MICROSECONDS))) {
-        return pooledConnection.getConnection();
-      }
-
-
-      addConnectionRequest();
-
-
-      if ((pooledConnection =
-        getIdleConnection(
-          TimeUnit.MILLISECONDS.toNanos(options->connectTimeout), TimeUnit.NANOSECONDS))) {
-        return pooledConnection.getConnection();
-      }
-
-      throw ExceptionMapper.connException(
-        "No connection available within the specified time "
-        +"(option 'connectTimeout': "
-        +NumberFormat.getInstance().format(options->connectTimeout)
-        +" ms)");
-
+      return item->getConnection();
     }
-    catch (InterruptedException& interrupted)
-    {
-      throw ExceptionMapper.connException("Thread was interrupted", interrupted);
-    }
-    finally
-    {
-      pendingRequestNumber.decrementAndGet();
+    catch (std::exception&) {
+      silentCloseConnection(item);
+      throw;
     }
   }
 
@@ -389,229 +620,151 @@ namespace mariadb
     * @return connection
     * @throws SQLException if any error occur during connection
     */
-  MariaDbConnection Pool::getConnection(SQLString& username, SQLString& password) {
-
-
-    try {
-
-      if ((urlParser.getUsername()
-        ? (urlParser.getUsername().compare(username) == 0)
-        : username)
-        &&(urlParser.getPassword()
-          ? (urlParser.getUsername().compare(username) == 0)
-          : password)) {
-        return getConnection();
-      }
+  MariaDbConnection* Pool::getConnection(const SQLString& username, const SQLString& password)
+  {
+    if (urlParser->getUsername().compare(username) == 0 && urlParser->getPassword().compare(password) == 0) {
+      return getConnection();
+    }
 
-      UrlParser tmpUrlParser =(UrlParser)urlParser.clone();
-      tmpUrlParser.setUsername(username);
-      tmpUrlParser.setPassword(password);
-      Protocol& protocol= Utils.retrieveProxy(tmpUrlParser, globalInfo);
-      return new MariaDbConnection(protocol);
+    UrlParser* tmpUrlParser= urlParser->clone();
+    SQLString user(username), pwd(password);
 
-    }
-    catch (CloneNotSupportedException& cloneException) {
+    tmpUrlParser->setUsername(user);
+    tmpUrlParser->setPassword(pwd);
 
-      throw SQLException(
-        "Error getting connection, parameters cannot be cloned", cloneException);
-    }
+    Shared::Protocol protocol(Utils::retrieveProxy(*tmpUrlParser, nullptr));
+    return new MariaDbConnection(protocol);
   }
 
-  SQLString Pool::generatePoolTag(int32_t poolIndex)
+  /**
+    * Give connection back to the pool. Connection, that got broken while in use, or given back after the pool
+    * has been closed, is closed.
+    *
+    * @param item connection
+    */
+  void Pool::releaseConnection(MariaDbPooledConnection* item)
   {
-    if (options->poolName.empty())
-    {
-      options->poolName= "MariaDB-pool";
+    if (poolState.load() != POOL_STATE_OK || item->isBroken()) {
+      silentCloseConnection(item);
+      return;
     }
-    return options->poolName + "-" + poolIndex;
+    item->lastUsedToNow();
+    pushIdleConnection(item);
   }
 
-  UrlParser& Pool::getUrlParser()
+
+  SQLString Pool::generatePoolTag(int32_t poolIndex)
   {
-    return urlParser;
+    return (options->poolName.empty() ? SQLString("MariaDB-pool") : options->poolName) + "-" + std::to_string(poolIndex);
   }
 
   /**
-    * Close pool and underlying connections.
-    *
-    * @throws InterruptedException if interrupted
+    * Close pool and idle connections. Connections in use are closed when they are given back.
     */
   void Pool::close()
   {
-    //synchronized(this)
-    {
-      Pools.remove(this);
-      poolState.set(POOL_STATE_CLOSING);
-      pendingRequestNumber.set(0);
-
-      scheduledFuture.cancel(false);
-      connectionAppender.shutdown();
-
-      try
+    if (poolState.exchange(POOL_STATE_CLOSING) == POOL_STATE_OK) {
       {
-        connectionAppender.awaitTermination(10, TimeUnit.SECONDS);
+        std::lock_guard<std::mutex> localScopeLock(houseKeepingLock);
+        houseKeepingWakeUp.notify_all();
       }
-      catch (std::exception &))
       {
-      closeAll(connectionRemover, idleConnections);
-}
-
-      connectionRemover.shutdown();
-      try {
-        unRegisterJmx();
+        std::lock_guard<std::mutex> localScopeLock(appenderLock);
+        appenderWakeUp.notify_all();
       }
-      catch (Exception& exception) {
-
+      if (houseKeeper.joinable()) {
+        houseKeeper.join();
+      }
+      for (auto& appender : connectionAppender) {
+        appender.join();
       }
-      connectionRemover.awaitTermination(10, TimeUnit.SECONDS);
     }
-  }
-
-  void Pool::closeAll(ExecutorService connectionRemover, Collection<MariaDbPooledConnection>collection) {
-    synchronized(collection) {
-      for (MariaDbPooledConnection item : collection) {
-        collection.remove(item);
-        totalConnection.decrementAndGet();
-        try {
-          item.abort(connectionRemover);
-        }
-        catch (SQLException& ex) {
-
-        }
-
 
+    for (int32_t i= 0; i < maxPoolSize; ++i) {
+      MariaDbPooledConnection* item= idleConnections[i].item.exchange(nullptr);
+      if (item != nullptr) {
+        idleCount.fetch_sub(1);
+        silentCloseConnection(item);
       }
     }
 
-    void Pool::initializePoolGlobalState(MariaDbConnection connection) {
-      try (Statement* stmt= connection.createStatement()) {
-        SQLString sql =
-          "SELECT @@max_allowed_packet,"
-          +"@@wait_timeout,"
-          +"@@autocommit,"
-          +"@@auto_increment_increment,"
-          +"@@time_zone,"
-          +"@@system_time_zone,"
-          +"@@tx_isolation";
-        if (!connection.isServerMariaDb()) {
-          int32_t major= connection.getMetaData().getDatabaseMajorVersion();
-          if ((major >=8 &&connection.versionGreaterOrEqual(8, 0, 3))
-            ||(major <8 &&connection.versionGreaterOrEqual(5, 7, 20))) {
-            sql =
-              "SELECT @@max_allowed_packet,"
-              +"@@wait_timeout,"
-              +"@@autocommit,"
-              +"@@auto_increment_increment,"
-              +"@@time_zone,"
-              +"@@system_time_zone,"
-              +"@@transaction_isolation";
-          }
-        }
-
-        try (ResultSet* rs= stmt.executeQuery(sql)) {
-
-          rs.next();
-
-          int32_t transactionIsolation= Utils.transactionFromString(rs.getString(7));
-
-          globalInfo =
-            new GlobalStateInfo(
-              rs.getLong(1),
-              rs.getInt(2),
-              rs.getBoolean(3),
-              rs.getInt(4),
-              rs.getString(5),
-              rs.getString(6),
-              transactionIsolation);
-
-
-
-          maxIdleTime= Math.min(options->maxIdleTime, globalInfo.getWaitTimeout()-45);
-
-
-        }
-      }
+    std::lock_guard<std::mutex> localScopeLock(waitLock);
+    connectionAvailable.notify_all();
+  }
 
-      SQLString Pool::getPoolTag() {
-        return poolTag;
-      }
 
-      bool Pool::equals(sql::Object* obj) {
-        if (this ==obj) {
-          return true;
-        }
-        if (obj ||getClass()!=obj.getClass()) {
-          return false;
-        }
+  const SQLString& Pool::getPoolTag() const
+  {
+    return poolTag;
+  }
 
-        Pool pool =(Pool)obj;
 
-        return (poolTag.compare(pool.poolTag) == 0);
-      }
+  int64_t Pool::getActiveConnections() const
+  {
+    return std::max<int64_t>(0, totalConnection.load() - idleCount.load());
+  }
 
-      int64_t Pool::hashCode() {
-        return poolTag.hashCode();
-      }
 
-      GlobalStateInfo Pool::getGlobalInfo() {
-        return globalInfo;
-      }
+  int64_t Pool::getTotalConnections() const
+  {
+    return totalConnection.load();
+  }
 
-      int64_t Pool::getActiveConnections() {
-        return totalConnection.get()-idleConnections.size();
-      }
 
-      int64_t Pool::getTotalConnections() {
-        return totalConnection.get();
-      }
+  int64_t Pool::getIdleConnections() const
+  {
+    return idleCount.load();
+  }
 
-      int64_t Pool::getIdleConnections() {
-        return idleConnections.size();
-      }
 
-      int64_t Pool::getConnectionRequests() {
-        return pendingRequestNumber.get();
-      }
+  int64_t Pool::getConnectionRequests() const
+  {
+    return pendingRequestNumber.load();
+  }
 
-      void Pool::registerJmx() {
-        MBeanServer mbs= ManagementFactory.getPlatformMBeanServer();
-        SQLString jmxName= replace(poolTag, ":", "_");
-        ObjectName name= new ObjectName("org.mariadb.jdbc.pool:type="+jmxName);
+  /**
+    * Number of connections the pool has established.
+    */
+  uint64_t Pool::getConnectionsCreated() const
+  {
+    return connectionsCreated.load(std::memory_order_relaxed);
+  }
 
-        if (!mbs.isRegistered(name)) {
-          mbs.registerMBean(this, name);
-        }
-      }
+  /**
+    * Number of failed attempts to establish connection.
+    */
+  uint64_t Pool::getConnectionsFailed() const
+  {
+    return connectionsFailed.load(std::memory_order_relaxed);
+  }
 
-      void Pool::unRegisterJmx() {
-        MBeanServer mbs= ManagementFactory.getPlatformMBeanServer();
-        SQLString jmxName= replace(poolTag, ":", "_");
-        ObjectName name= new ObjectName("org.mariadb.jdbc.pool:type="+jmxName);
+  /**
+    * Number of idle connections, that have been found broken, when they were about to be given out, or checked
+    * by the housekeeping.
+    */
+  uint64_t Pool::getValidationsFailed() const
+  {
+    return validationsFailed.load(std::memory_order_relaxed);
+  }
 
-        if (mbs.isRegistered(name)) {
-          mbs.unregisterMBean(name);
-        }
-      }
+  /**
+    * Number of getConnection calls, that have not got a connection within connectTimeout.
+    */
+  uint64_t Pool::getConnectionTimeouts() const
+  {
+    return connectionTimeouts.load(std::memory_order_relaxed);
+  }
 
-      /**
-        * For testing purpose only.
-        *
-        * @return current thread id's
-        */
-      std::list<Long>testGetConnectionIdleThreadIds() {
-        std::list<Long>threadIds= new ArrayList<>();
-        for (MariaDbPooledConnection pooledConnection : idleConnections) {
-          threadIds.add(pooledConnection.getConnection().getServerThreadId());
-        }
-        return threadIds;
-      }
 
-      /** JMX method to remove state (will be reinitialized on next connection creation). */  void Pool::resetStaticGlobal() {
-        globalInfo= NULL;
-      }
+  const Histogram& Pool::getCheckoutWaitTime() const
+  {
+    return checkoutWaitTime;
+  }
 
 
-    }
+  const Histogram& Pool::getConnectionLifetime() const
+  {
+    return connectionLifetime;
   }
 }
-}
\ No newline at end of file
+}
@@ -18,101 +18,154 @@
 *************************************************************************************/
 
 
+
 #ifndef _POOL_H_
 #define _POOL_H_
 
 #include <vector>
 #include <atomic>
-#include <deque>
-#include <list>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 #include "Consts.h"
 #include "UrlParser.h"
 #include "GlobalStateInfo.h"
 #include "MariaDbConnection.h"
+#include "util/Histogram.h"
 
 namespace sql
 {
 namespace mariadb
 {
-class ThreadPoolExecutor;
-class Runnable
-{
-  int32_t dummy;
-};
-class ScheduledFuture;
-class ExecutorService;
-
-class ScheduledThreadPoolExecutor;
-enum TimeUnit {
-  SECONDS
-};
-
 class MariaDbConnection;
-
+class MariaDbPooledConnection;
+
+/**
+  * Pool of physical connections sharing one configuration. Idle connections are kept in the fixed array of
+  * slots, sized maxPoolSize, that threads take from and put back to with compare-and-swap only. Lower slots are
+  * preferred in both directions, so the most recently used connections are reused first, while connections in
+  * the upper slots get idle and are eventually removed by the housekeeping thread.
+  * Every thread remembers the slot it has given its connection back to, and looks there first on the next
+  * checkout. Thus threads, that take and give back connections all the time, mostly get the same connection, and
+  * work with different slots. Other threads take connection from such a slot only after the owner had time to
+  * come back for it, or if there is no other idle connection.
+  */
 class Pool
 {
-  static const Shared::Logger logger; /*LoggerFactory.getLogger(Pool.class)*/
-  static int32_t POOL_STATE_OK; /*0*/
-  static int32_t POOL_STATE_CLOSING; /*1*/
-  std::atomic<int32_t> poolState; /*new std::atomic<int32_t>()*/
+  static const Shared::Logger logger;
+  static const int32_t POOL_STATE_OK= 0;
+  static const int32_t POOL_STATE_CLOSING= 1;
+  /* Limit of connections being established at the same time, so that cold start does not flood the server */
+  static const int32_t MAX_CONCURRENT_CONNECTS= 4;
+  /* Background threads add a connection when the pool has fewer idle ones than that, and still can grow */
+  static const int32_t IDLE_REFILL_THRESHOLD= 1;
+  /* Connection given back to the pool more recently, is left for the thread, that gave it back, if possible */
+  static const int64_t AFFINITY_WINDOW_NANOS= 10000000;
+
+  /* Idle connection slot. Padded, so that threads using different slots do not share cache lines */
+  struct IdleSlot
+  {
+    std::atomic<MariaDbPooledConnection*> item;
+    /* Time connection has been put to the slot. Is not synchronized with the item, and is only a hint */
+    std::atomic<int64_t> releasedAt;
+    char padding[64 - sizeof(std::atomic<MariaDbPooledConnection*>) - sizeof(std::atomic<int64_t>)];
+  };
+
+  std::atomic<int32_t> poolState;
+  /* Unique id of the pool, identifying it in threads' slot affinity */
+  const uint64_t generation;
+  /* Given to the pool connections. Weak, as the pool may be gone while connection is still in use */
+  std::weak_ptr<Pool> self;
 
   std::shared_ptr<UrlParser> urlParser;
   const Shared::Options options;
-  std::atomic<int32_t> pendingRequestNumber ; /*new std::atomic<int32_t>()*/
-  std::atomic<int32_t> totalConnection ; /*new std::atomic<int32_t>()*/
-  const std::deque<std::unique_ptr<MariaDbPooledConnection>>idleConnections;
-  const ThreadPoolExecutor* connectionAppender;
-  const std::vector<Runnable> connectionAppenderQueue;
+  const int32_t maxPoolSize;
+  const int32_t minPoolSize;
+  /* Number of threads waiting for a connection */
+  std::atomic<int32_t> pendingRequestNumber;
+  /* Number of physical connections, idle, in use, and being created */
+  std::atomic<int32_t> totalConnection;
+  /* Number of connections being established. They are counted in totalConnection as well */
+  std::atomic<int32_t> connectingCount;
+  const int32_t maxConnecting;
+  std::atomic<int32_t> idleCount;
+  std::unique_ptr<IdleSlot[]> idleConnections;
+
+  /* Waiting for a connection. Taken only when there is nothing to take without waiting */
+  std::mutex waitLock;
+  std::condition_variable connectionAvailable;
+
+  std::mutex houseKeepingLock;
+  std::condition_variable houseKeepingWakeUp;
+  std::thread houseKeeper;
+
+  /* Threads adding connections ahead of demand - at start, and when pool runs low on idle connections */
+  std::mutex appenderLock;
+  std::condition_variable appenderWakeUp;
+  std::vector<std::thread> connectionAppender;
+
   const SQLString poolTag;
-  const ScheduledThreadPoolExecutor* poolExecutor;
-  const ScheduledFuture* scheduledFuture;
-  GlobalStateInfo globalInfo;
   int32_t maxIdleTime;
-  int64_t timeToConnectNanos;
-  int64_t connectionTime ; /*0*/
 
-public:
-  Pool(std::shared_ptr<UrlParser>& _urlParser, int32_t poolIndex, std::shared_ptr<ScheduledThreadPoolExecutor>& poolExecutor) : urlParser(_urlParser) {}
+  std::atomic<uint64_t> connectionsCreated;
+  std::atomic<uint64_t> connectionsFailed;
+  std::atomic<uint64_t> validationsFailed;
+  std::atomic<uint64_t> connectionTimeouts;
+  /* Time getConnection has waited for the connection, in microseconds */
+  Histogram checkoutWaitTime;
+  /* Time connections closed by the pool have existed, in milliseconds */
+  Histogram connectionLifetime;
 
-private:
+  Pool(const Pool&)= delete;
+  Pool& operator=(const Pool&)= delete;
+
+  Pool(std::shared_ptr<UrlParser>& urlParser, int32_t poolIndex);
+
+  void houseKeeping();
+  void appendConnections();
   void addConnectionRequest();
+  bool needConnection() const;
   void removeIdleTimeoutConnection();
-  void addConnection();
-  MariaDbPooledConnection& getIdleConnection();
-  MariaDbPooledConnection& getIdleConnection(int64_t timeout, TimeUnit timeUnit);
-  void silentCloseConnection(MariaDbPooledConnection& item);
-  void silentAbortConnection(MariaDbPooledConnection& item);
-  MariaDbPooledConnection& createPoolConnection(MariaDbConnection* connection);
+  bool addConnection();
+  void restoreIdleConnection(int32_t slot, MariaDbPooledConnection* item, int64_t releasedAt);
+  bool reserveConnection();
+  bool canConnect() const;
+  MariaDbPooledConnection* pollIdleConnection();
+  bool isAffineThread() const;
+  MariaDbPooledConnection* takeIdleConnection(int32_t slot);
+  bool putIdleConnection(int32_t slot, MariaDbPooledConnection* item, int64_t releasedAt);
+  void pushIdleConnection(MariaDbPooledConnection* item);
+  MariaDbPooledConnection* getIdleConnection(int64_t timeoutMs);
+  bool validate(MariaDbPooledConnection* item);
+  void silentCloseConnection(MariaDbPooledConnection* item);
+  void notifyWaiter();
+  MariaDbPooledConnection* createPoolConnection();
+  SQLString generatePoolTag(int32_t poolIndex);
 
 public:
+  static Shared::Pool newInstance(std::shared_ptr<UrlParser>& urlParser, int32_t poolIndex);
+  ~Pool();
+
   MariaDbConnection* getConnection();
-  MariaDbConnection* getConnection(SQLString& username, SQLString& password);
+  MariaDbConnection* getConnection(const SQLString& username, const SQLString& password);
+  void releaseConnection(MariaDbPooledConnection* item);
 
-private:
-  SQLString generatePoolTag(int32_t poolIndex);
-public:
   std::shared_ptr<UrlParser>& getUrlParser() { return urlParser; }
-  void close() {}
-private:
-  void closeAll(ExecutorService connectionRemover, std::list<MariaDbPooledConnection>collection);
-  void initializePoolGlobalState(MariaDbConnection& connection);
-public:
-  SQLString getPoolTag();
-  bool equals(sql::Object* obj);
-  int64_t hashCode();
-  GlobalStateInfo getGlobalInfo();
-  int64_t getActiveConnections();
-  int64_t getTotalConnections();
-  int64_t getIdleConnections();
-  int64_t getConnectionRequests();
-
-private:
-  void registerJmx();
-  void unRegisterJmx();
-public:
-  std::vector<int64_t>testGetConnectionIdleThreadIds();
-  void resetStaticGlobal();
+  void close();
+
+  const SQLString& getPoolTag() const;
+  int64_t getActiveConnections() const;
+  int64_t getTotalConnections() const;
+  int64_t getIdleConnections() const;
+  int64_t getConnectionRequests() const;
+  uint64_t getConnectionsCreated() const;
+  uint64_t getConnectionsFailed() const;
+  uint64_t getValidationsFailed() const;
+  uint64_t getConnectionTimeouts() const;
+  const Histogram& getCheckoutWaitTime() const;
+  const Histogram& getConnectionLifetime() const;
 };
 
 }
@@ -25,12 +25,9 @@ namespace sql
 namespace mariadb
 {
   std::atomic<int32_t> Pools::poolIndex;
-  std::shared_ptr<ScheduledThreadPoolExecutor> Pools::poolExecutor;
   /* TODO: change to std::unordered_map */
   HashMap<UrlParser, Shared::Pool> Pools::poolMap;
-
-  //const std::map<UrlParser&, Pool>poolMap;// =new ConcurrentHashMap<>();
-  /* ScheduledThreadPoolExecutor* Pools::poolExecutor= NULL; */
+  std::mutex Pools::mapLock;
 
   /**
     * Get existing pool for a configuration. Create it if doesn't exists.
@@ -40,25 +37,15 @@ namespace mariadb
     */
   Shared::Pool Pools::retrievePool(std::shared_ptr<UrlParser>& urlParser)
   {
+    std::lock_guard<std::mutex> localScopeLock(mapLock);
     auto cit= poolMap.find(*urlParser);
+
     if (cit == poolMap.end())
     {
-      //synchronized(poolMap)
-      {
-        cit= poolMap.find(*urlParser);
+      Shared::Pool pool(Pool::newInstance(urlParser, ++poolIndex));
+      poolMap.insert(*urlParser, pool);
 
-        if (cit == poolMap.end())
-        {
-          if (!poolExecutor)
-          {
-            poolExecutor.reset(new ScheduledThreadPoolExecutor()); //1, new MariaDbThreadFactory("MariaDbPool-maxTimeoutIdle-checker"));
-          }
-          Shared::Pool pool(new Pool(urlParser, ++poolIndex, poolExecutor));
-          poolMap.insert(*urlParser, pool);
-
-          return pool;
-        }
-      }
+      return pool;
     }
 
     return cit->second;
@@ -71,36 +58,25 @@ namespace mariadb
     */
   void Pools::remove(Pool &pool)
   {
-    if (poolMap.find(*pool.getUrlParser()) != poolMap.end())
-    {
-      //synchronized(poolMap)
-      {
-        if (poolMap.find(*pool.getUrlParser()) != poolMap.end())
-        {
-          poolMap.remove(*pool.getUrlParser());
-          shutdownExecutor();
-        }
-      }
-    }
+    std::lock_guard<std::mutex> localScopeLock(mapLock);
+    poolMap.remove(*pool.getUrlParser());
   }
 
   /** Close all pools. */
   void Pools::close()
   {
-    //synchronized(poolMap)
+    std::lock_guard<std::mutex> localScopeLock(mapLock);
+
+    for (auto it : poolMap)
     {
-      for (auto it : poolMap)
-      {
-        try {
-          it.second->close();
-        }
-        catch (std::exception&) {
+      try {
+        it.second->close();
+      }
+      catch (std::exception&) {
 
-        }
       }
-      shutdownExecutor();
-      poolMap.clear();
     }
+    poolMap.clear();
   }
 
   /**
@@ -114,43 +90,23 @@ namespace mariadb
     {
       return;
     }
-    //synchronized(poolMap)
+    std::lock_guard<std::mutex> localScopeLock(mapLock);
+
+    for (auto it : poolMap)
     {
-      for (auto it : poolMap)
+      if (poolName.compare(it.second->getUrlParser()->getOptions()->poolName) == 0)
       {
-        if (poolName.compare(it.second->getUrlParser()->getOptions()->poolName) == 0)
+        try
         {
-          try
-          {
-            it.second->close();
-          }
-          catch (std::exception&)
-          {
-          }
-          poolMap.remove(*it.second->getUrlParser());
-          return;
+          it.second->close();
         }
-      }
-
-      if (poolMap.empty())
-      {
-        shutdownExecutor();
+        catch (std::exception&)
+        {
+        }
+        poolMap.remove(*it.second->getUrlParser());
+        return;
       }
     }
   }
-
-  void Pools::shutdownExecutor()
-  {
-    poolExecutor->shutdown();
-    try
-    {
-      poolExecutor->awaitTermination(10, TimeUnit::SECONDS);
-    }
-    catch (std::exception&)
-    {
-    }
-    poolExecutor= NULL;
-  }
-
 }
-}
\ No newline at end of file
+}
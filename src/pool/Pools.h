@@ -25,6 +25,7 @@
 #include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 
 #include "UrlParser.h"
 #include "Pool.h"
@@ -33,18 +34,6 @@ namespace sql
 {
 namespace mariadb
 {
-//class Pool;
-
-/*Stub to enable build */
-class ScheduledThreadPoolExecutor
-{
-public:
-  //ScheduledThreadPoolExecutor(int32_t, MariaDbThreadFactory*) {}
-  void shutdown() {}
-  void awaitTermination(int32_t time, enum TimeUnit unit) {}
-};
-
-
 template <class HASHABLEKEY, class VT> class HashMap
 {
   std::map<int64_t, VT> realMap;
@@ -113,16 +102,13 @@ class Pools
 {
     static std::atomic<int32_t> poolIndex ; /*new std::atomic<int32_t>()*/
     static HashMap<UrlParser,Shared::Pool> poolMap; /*new ConcurrentHashMap<>()*/
-    static std::shared_ptr<ScheduledThreadPoolExecutor> poolExecutor; /*NULL*/
+    static std::mutex mapLock;
 
   public:
     static Shared::Pool retrievePool(std::shared_ptr<UrlParser>& urlParser);
     static void remove(Pool& pool);
     static void close();
     static void close(const SQLString& poolName);
-
-  private:
-    static void shutdownExecutor();
 };
 
 }
@@ -31,6 +31,8 @@ namespace mariadb
 {
 namespace capi
 {
+  const unsigned long BinRowProtocolCapi::INITIAL_BUFFER_LENGTH;
+
   /**
     * Constructor.
     *
@@ -62,9 +64,15 @@ namespace capi
        if (bind.back().buffer_type == MYSQL_TYPE_VARCHAR) {
          bind.back().buffer_type= MYSQL_TYPE_STRING;
        }
-       bind.back().buffer_length= static_cast<unsigned long>(columnInfo->getColumnType().binarySize() != 0 ?
-                                                         columnInfo->getColumnType().binarySize() :
-                                                         getLengthMaxFieldSize());
+       if (columnInfo->getColumnType().binarySize() != 0) {
+         bind.back().buffer_length= static_cast<unsigned long>(columnInfo->getColumnType().binarySize());
+       }
+       else {
+         // Not allocating max column length, that can be up to 4G for LONGTEXT/LONGBLOB. Bigger values are
+         // fetched separately in fetchNext()
+         bind.back().buffer_length= std::min(static_cast<unsigned long>(getLengthMaxFieldSize()), INITIAL_BUFFER_LENGTH);
+         growableColumns.push_back(static_cast<uint32_t>(bind.size() - 1));
+       }
        bind.back().buffer=        new uint8_t[bind.back().buffer_length];
        bind.back().length=        &bind.back().length_value;
        bind.back().is_null=       &bind.back().is_null_value;
@@ -73,6 +81,79 @@ namespace capi
      if (mysql_stmt_bind_result(stmt, bind.data())) {
        throwStmtError(stmt);
      }
+     initConverters();
+  }
+
+  /**
+    * Select converters for each column. Types, which values are read directly from the buffer, get specialized
+    * converters, other types use generic getters.
+    */
+  void BinRowProtocolCapi::initConverters()
+  {
+    converters.reserve(columnInformation.size());
+
+    for (auto& columnInfo : columnInformation) {
+      ColumnConverters<BinRowProtocolCapi> columnConverters= {
+        &BinRowProtocolCapi::getIntGeneric,
+        &BinRowProtocolCapi::getLongGeneric,
+        &BinRowProtocolCapi::getDoubleGeneric };
+      bool isSigned= columnInfo->isSigned();
+
+      switch (columnInfo->getColumnType().getType()) {
+      case MYSQL_TYPE_TINY:
+        if (isSigned) {
+          columnConverters= { &BinRowProtocolCapi::getIntFromBinary<int8_t>, &BinRowProtocolCapi::getLongFromBinary<int8_t>,
+            &BinRowProtocolCapi::getDoubleFromBinary<int8_t> };
+        }
+        else {
+          columnConverters= { &BinRowProtocolCapi::getIntFromBinary<uint8_t>, &BinRowProtocolCapi::getLongFromBinary<uint8_t>,
+            &BinRowProtocolCapi::getDoubleFromBinary<uint8_t> };
+        }
+        break;
+      case MYSQL_TYPE_SHORT:
+      case MYSQL_TYPE_YEAR:
+        if (isSigned) {
+          columnConverters= { &BinRowProtocolCapi::getIntFromBinary<int16_t>, &BinRowProtocolCapi::getLongFromBinary<int16_t>,
+            &BinRowProtocolCapi::getDoubleFromBinary<int16_t> };
+        }
+        else {
+          columnConverters= { &BinRowProtocolCapi::getIntFromBinary<uint16_t>, &BinRowProtocolCapi::getLongFromBinary<uint16_t>,
+            &BinRowProtocolCapi::getDoubleFromBinary<uint16_t> };
+        }
+        break;
+      case MYSQL_TYPE_LONG:
+      case MYSQL_TYPE_INT24:
+        if (isSigned) {
+          columnConverters.getInt= &BinRowProtocolCapi::getIntFromBinary<int32_t>;
+          columnConverters.getLong= &BinRowProtocolCapi::getLongFromBinary<int32_t>;
+          columnConverters.getDouble= &BinRowProtocolCapi::getDoubleFromBinary<int32_t>;
+        }
+        else {
+          // getInt needs range check
+          columnConverters.getLong= &BinRowProtocolCapi::getLongFromBinary<uint32_t>;
+          columnConverters.getDouble= &BinRowProtocolCapi::getDoubleFromBinary<uint32_t>;
+        }
+        break;
+      case MYSQL_TYPE_LONGLONG:
+        if (isSigned) {
+          columnConverters.getLong= &BinRowProtocolCapi::getLongFromBinary<int64_t>;
+          columnConverters.getDouble= &BinRowProtocolCapi::getDoubleFromBinary<int64_t>;
+        }
+        else {
+          columnConverters.getDouble= &BinRowProtocolCapi::getDoubleFromBinary<uint64_t>;
+        }
+        break;
+      case MYSQL_TYPE_FLOAT:
+        columnConverters.getDouble= &BinRowProtocolCapi::getDoubleFromBinary<float>;
+        break;
+      case MYSQL_TYPE_DOUBLE:
+        columnConverters.getDouble= &BinRowProtocolCapi::getDoubleFromBinary<double>;
+        break;
+      default:
+        break;
+      }
+      converters.push_back(columnConverters);
+    }
   }
 
 
@@ -94,9 +175,22 @@ namespace capi
   void BinRowProtocolCapi::setPosition(int32_t newIndex)
   {
     index= newIndex;
+    pos= 0;
+
+    // Row stored by the result set. Getters read values only via fieldBuf, thus it works same way as bind buffers
+    if (buf != nullptr) {
+      fieldBuf.wrap(buf[index].arr, buf[index].size());
+      length= static_cast<uint32_t>(fieldBuf.size());
+      this->lastValueNull= buf[index].arr == nullptr ? BIT_LAST_FIELD_NULL : BIT_LAST_FIELD_NOT_NULL;
+      return;
+    }
     length= bind[index].length_value;
+    // Value cut to the max field size
+    if (length > bind[index].buffer_length) {
+      length= maxFieldSize > 0 && static_cast<unsigned long>(maxFieldSize) < bind[index].buffer_length ?
+        maxFieldSize : static_cast<uint32_t>(bind[index].buffer_length);
+    }
     fieldBuf.wrap(static_cast<char*>(bind[index].buffer), length);
-    pos= 0;
 
     this->lastValueNull= bind[index].is_null_value ? BIT_LAST_FIELD_NULL : BIT_LAST_FIELD_NOT_NULL;
   }
@@ -104,7 +198,81 @@ namespace capi
 
   int32_t BinRowProtocolCapi::fetchNext()
   {
-    return mysql_stmt_fetch(stmt);
+    int32_t rc= mysql_stmt_fetch(stmt);
+
+    // Truncation may be not reported, if the connection has MYSQL_REPORT_DATA_TRUNCATION off, thus checking lengths anyway
+    if (rc == 0 || rc == MYSQL_DATA_TRUNCATED) {
+      fetchTruncatedColumns();
+      rc= 0;
+    }
+    return rc;
+  }
+
+  /**
+    * Fetches values, that did not fit the column's buffer, growing the buffer to the value length(or to the max field
+    * size, if it is set). Grown buffers are re-bound, so following rows of similar size do not need extra fetches.
+    */
+  void BinRowProtocolCapi::fetchTruncatedColumns()
+  {
+    bool rebind= false;
+
+    for (uint32_t i : growableColumns) {
+      MYSQL_BIND& columnBind= bind[i];
+
+      if (columnBind.is_null_value) {
+        continue;
+      }
+      unsigned long required= columnBind.length_value;
+      if (maxFieldSize > 0 && required > maxFieldSize) {
+        required= maxFieldSize;
+      }
+      if (required <= columnBind.buffer_length) {
+        continue;
+      }
+      delete[] static_cast<uint8_t*>(columnBind.buffer);
+      // +1 to give C/C room for terminating null
+      columnBind.buffer_length= required + 1;
+      columnBind.buffer= new uint8_t[columnBind.buffer_length];
+      rebind= true;
+
+      if (mysql_stmt_fetch_column(stmt, &columnBind, i, 0)) {
+        throwStmtError(stmt);
+      }
+    }
+
+    if (rebind && mysql_stmt_bind_result(stmt, bind.data())) {
+      throwStmtError(stmt);
+    }
+  }
+
+
+  /**
+    * Get raw value of the column from the bind buffer. For fixed length types that is the whole buffer, i.e. the
+    * value in the form getters expect it. Values of variable length types, that did not fit the buffer, are cut to
+    * the max field size - the buffer is one byte longer to give room for the terminating null.
+    *
+    * @param columnIndex index of the column (0 is first)
+    * @param len [out] value length
+    * @return pointer to the value or NULL if the value is NULL
+    */
+  const char* BinRowProtocolCapi::getRawValue(int32_t columnIndex, std::size_t& len)
+  {
+    const MYSQL_BIND& columnBind= bind[columnIndex];
+
+    if (columnBind.is_null_value) {
+      len= 0;
+      return nullptr;
+    }
+    len= columnBind.buffer_length;
+    if (columnInformation[columnIndex]->getColumnType().binarySize() == 0) {
+      if (columnBind.length_value <= len) {
+        len= columnBind.length_value;
+      }
+      else if (maxFieldSize > 0 && maxFieldSize < len) {
+        len= maxFieldSize;
+      }
+    }
+    return static_cast<const char*>(columnBind.buffer);
   }
 
 
@@ -115,6 +283,98 @@ namespace capi
   }
 
 
+  /**
+    * Append current row values to the columnar batch, reading numeric and character columns
+    * directly from the result bind buffers.
+    *
+    * @param batch batch to fill
+    * @param rowIndex index of the row in the batch
+    * @param columnInformation column information
+    */
+  void BinRowProtocolCapi::appendToBatch(ColumnBatch& batch, std::size_t rowIndex, const std::vector<Shared::ColumnDefinition>& columnInformation)
+  {
+    // Row stored by the result set
+    if (buf != nullptr) {
+      RowProtocol::appendToBatch(batch, rowIndex, columnInformation);
+      return;
+    }
+    for (std::size_t i= 0; i < batch.columns.size(); ++i) {
+      ColumnBatch::Column& column= batch.columns[i];
+      MYSQL_BIND& columnBind= bind[i];
+
+      if (columnBind.is_null_value) {
+        appendNullToBatch(column, rowIndex);
+        continue;
+      }
+
+      switch (columnBind.buffer_type) {
+      case MYSQL_TYPE_TINY:
+        if (column.kind == ColumnBatch::INT64) {
+          column.longs.push_back(column.isUnsigned ? *static_cast<uint8_t*>(columnBind.buffer) : *static_cast<int8_t*>(columnBind.buffer));
+          continue;
+        }
+        break;
+      case MYSQL_TYPE_SHORT:
+      case MYSQL_TYPE_YEAR:
+        if (column.kind == ColumnBatch::INT64) {
+          column.longs.push_back(column.isUnsigned ? *static_cast<uint16_t*>(columnBind.buffer) : *static_cast<int16_t*>(columnBind.buffer));
+          continue;
+        }
+        break;
+      case MYSQL_TYPE_LONG:
+      case MYSQL_TYPE_INT24:
+        if (column.kind == ColumnBatch::INT64) {
+          column.longs.push_back(column.isUnsigned ? *static_cast<uint32_t*>(columnBind.buffer) : *static_cast<int32_t*>(columnBind.buffer));
+          continue;
+        }
+        break;
+      case MYSQL_TYPE_LONGLONG:
+        if (column.kind == ColumnBatch::INT64) {
+          column.longs.push_back(*static_cast<int64_t*>(columnBind.buffer));
+          continue;
+        }
+        break;
+      case MYSQL_TYPE_FLOAT:
+        if (column.kind == ColumnBatch::DOUBLE) {
+          column.doubles.push_back(*static_cast<float*>(columnBind.buffer));
+          continue;
+        }
+        break;
+      case MYSQL_TYPE_DOUBLE:
+        if (column.kind == ColumnBatch::DOUBLE) {
+          column.doubles.push_back(*static_cast<double*>(columnBind.buffer));
+          continue;
+        }
+        break;
+      case MYSQL_TYPE_STRING:
+      case MYSQL_TYPE_VAR_STRING:
+      case MYSQL_TYPE_TINY_BLOB:
+      case MYSQL_TYPE_MEDIUM_BLOB:
+      case MYSQL_TYPE_LONG_BLOB:
+      case MYSQL_TYPE_BLOB:
+      case MYSQL_TYPE_JSON:
+      case MYSQL_TYPE_ENUM:
+      case MYSQL_TYPE_SET:
+      case MYSQL_TYPE_GEOMETRY:
+        if (column.kind == ColumnBatch::STRING) {
+          std::size_t len= std::min(columnBind.length_value, columnBind.buffer_length);
+          if (maxFieldSize != 0 && maxFieldSize < len) {
+            len= maxFieldSize;
+          }
+          appendStringToBatch(column, static_cast<const char*>(columnBind.buffer), len);
+          continue;
+        }
+        break;
+      default:
+        break;
+      }
+      // Everything else, like BIT, temporal and decimal types, goes the regular way
+      setPosition(static_cast<int32_t>(i));
+      appendValueToBatch(column, rowIndex, columnInformation[i].get());
+    }
+  }
+
+
   SQLString* BinRowProtocolCapi::convertToString(const char* asChar, ColumnDefinition* columnInfo)
   {
     if ((lastValueNull & BIT_LAST_FIELD_NULL)!=0) {
@@ -198,12 +458,45 @@ namespace capi
     */
   std::unique_ptr<SQLString> BinRowProtocolCapi::getInternalString(ColumnDefinition* columnInfo, Calendar* cal, TimeZone* timeZone)
   {
-    const char* asChar= static_cast<char*>(bind[index].buffer);
+    const char* asChar= fieldBuf.arr;
     std::unique_ptr<SQLString> result(convertToString(asChar, columnInfo));
 
     return std::move(result);
   }
 
+  /**
+    * Get string value pointer and length from raw binary format. Character and binary column values are returned
+    * without copying.
+    *
+    * @param columnInfo column information
+    * @param len [out] value length
+    * @return pointer to the value or NULL if the value is NULL
+    */
+  const char* BinRowProtocolCapi::getInternalStringView(ColumnDefinition* columnInfo, std::size_t& len)
+  {
+    if (lastValueWasNull()) {
+      len= 0;
+      return nullptr;
+    }
+
+    switch (columnInfo->getColumnType().getType()) {
+    case MYSQL_TYPE_STRING:
+    case MYSQL_TYPE_VAR_STRING:
+    case MYSQL_TYPE_VARCHAR:
+    case MYSQL_TYPE_TINY_BLOB:
+    case MYSQL_TYPE_MEDIUM_BLOB:
+    case MYSQL_TYPE_LONG_BLOB:
+    case MYSQL_TYPE_BLOB:
+    case MYSQL_TYPE_JSON:
+    case MYSQL_TYPE_ENUM:
+    case MYSQL_TYPE_SET:
+      len= std::min<std::size_t>(getLengthMaxFieldSize(), fieldBuf.size());
+      return fieldBuf.arr;
+    default:
+      return RowProtocol::getInternalStringView(columnInfo, len);
+    }
+  }
+
   /**
     * Get int from raw binary format.
     *
@@ -212,6 +505,70 @@ namespace capi
     * @throws SQLException if column is not numeric or is not in Integer bounds.
     */
   int32_t BinRowProtocolCapi::getInternalInt(ColumnDefinition* columnInfo)
+  {
+    if (lastValueWasNull()) {
+      return 0;
+    }
+    return (this->*converters[index].getInt)(columnInfo);
+  }
+
+  /**
+    * Get long from raw binary format.
+    *
+    * @param columnInfo column information
+    * @return long value
+    * @throws SQLException if column is not numeric or is not in Long bounds (for big unsigned
+    *     values)
+    */
+  int64_t BinRowProtocolCapi::getInternalLong(ColumnDefinition* columnInfo)
+  {
+    if (lastValueWasNull()) {
+      return 0;
+    }
+    return (this->*converters[index].getLong)(columnInfo);
+  }
+
+  /**
+    * Get double from raw binary format.
+    *
+    * @param columnInfo column information
+    * @return double value
+    * @throws SQLException if column is not numeric or is not in Double bounds (unsigned columns).
+    */
+  long double BinRowProtocolCapi::getInternalDouble(ColumnDefinition* columnInfo)
+  {
+    if (lastValueWasNull()) {
+      return 0;
+    }
+    return (this->*converters[index].getDouble)(columnInfo);
+  }
+
+  /* Specialized converters for types, that do not need conversion or range check. The value is not NULL */
+  template <typename T> int32_t BinRowProtocolCapi::getIntFromBinary(ColumnDefinition*)
+  {
+    return static_cast<int32_t>(*reinterpret_cast<const T*>(fieldBuf.arr));
+  }
+
+
+  template <typename T> int64_t BinRowProtocolCapi::getLongFromBinary(ColumnDefinition*)
+  {
+    return static_cast<int64_t>(*reinterpret_cast<const T*>(fieldBuf.arr));
+  }
+
+
+  template <typename T> long double BinRowProtocolCapi::getDoubleFromBinary(ColumnDefinition*)
+  {
+    return static_cast<long double>(*reinterpret_cast<const T*>(fieldBuf.arr));
+  }
+
+  /**
+    * Get int from raw binary format for any type.
+    *
+    * @param columnInfo column information
+    * @return int value
+    * @throws SQLException if column is not numeric or is not in Integer bounds.
+    */
+  int32_t BinRowProtocolCapi::getIntGeneric(ColumnDefinition* columnInfo)
   {
     if (lastValueWasNull()) {
       return 0;
@@ -233,10 +590,10 @@ namespace capi
     case MYSQL_TYPE_LONG:
     case MYSQL_TYPE_INT24:
       if (columnInfo->isSigned()) {
-        return *static_cast<int32_t*>(bind[index].buffer);
+        return *reinterpret_cast<int32_t*>(fieldBuf.arr);
       }
       else {
-        value= *static_cast<uint32_t*>(bind[index].buffer);
+        value= *reinterpret_cast<uint32_t*>(fieldBuf.arr);
       }
       break;
     case MYSQL_TYPE_LONGLONG:
@@ -256,13 +613,13 @@ namespace capi
     case MYSQL_TYPE_VARCHAR:
     case MYSQL_TYPE_STRING:
       try {
-        value = std::stoll(static_cast<char*>(bind[index].buffer));
+        value = std::stoll(fieldBuf.arr);
       }
       // Common parent for std::invalid_argument and std::out_of_range
       catch (std::logic_error&) {
 
         throw SQLException(
-          "Out of range value for column '" + columnInfo->getName() + "' : value " + sql::SQLString(static_cast<char*>(bind[index].buffer), length),
+          "Out of range value for column '" + columnInfo->getName() + "' : value " + sql::SQLString(fieldBuf.arr, length),
           "22003",
           1264);
       }
@@ -277,14 +634,14 @@ namespace capi
   }
 
   /**
-    * Get long from raw binary format.
+    * Get long from raw binary format for any type.
     *
     * @param columnInfo column information
     * @return long value
     * @throws SQLException if column is not numeric or is not in Long bounds (for big unsigned
     *     values)
     */
-  int64_t BinRowProtocolCapi::getInternalLong(ColumnDefinition* columnInfo)
+  int64_t BinRowProtocolCapi::getLongGeneric(ColumnDefinition* columnInfo)
   {
     if (lastValueWasNull()) {
       return 0;
@@ -316,12 +673,12 @@ namespace capi
       }
       case MYSQL_TYPE_LONGLONG:
       {
-        value = *static_cast<uint64_t*>(bind[index].buffer);
+        value = *reinterpret_cast<uint64_t*>(fieldBuf.arr);
 
         if (columnInfo->isSigned()) {
           return value;
         }
-        uint64_t unsignedValue = *static_cast<uint64_t*>(bind[index].buffer);
+        uint64_t unsignedValue = *reinterpret_cast<uint64_t*>(fieldBuf.arr);
 
         if (unsignedValue > static_cast<uint64_t>(INT64_MAX)) {
           throw SQLException(
@@ -376,7 +733,7 @@ namespace capi
       case MYSQL_TYPE_VAR_STRING:
       case MYSQL_TYPE_VARCHAR:
       case MYSQL_TYPE_STRING:
-        return std::stoll(static_cast<char*>(bind[index].buffer));
+        return std::stoll(fieldBuf.arr);
       default:
         throw SQLException(
           "getLong not available for data field type "
@@ -425,7 +782,7 @@ namespace capi
     }
     case MYSQL_TYPE_LONGLONG:
     {
-      value = *static_cast<int64_t*>(bind[index].buffer);
+      value = *reinterpret_cast<int64_t*>(fieldBuf.arr);
 
       break;
     }
@@ -471,7 +828,7 @@ namespace capi
     case MYSQL_TYPE_VARCHAR:
     case MYSQL_TYPE_STRING:
     {
-      char* charValue = static_cast<char*>(bind[index].buffer);
+      char* charValue = fieldBuf.arr;
       try {
         return sql::mariadb::stoull(charValue);
       }
@@ -538,14 +895,14 @@ namespace capi
     case MYSQL_TYPE_LONGLONG:
     {
       if (columnInfo->isSigned()) {
-        return static_cast<float>(*static_cast<int64_t*>(bind[index].buffer));
+        return static_cast<float>(*reinterpret_cast<int64_t*>(fieldBuf.arr));
       }
-      uint64_t unsignedValue= *static_cast<uint64_t*>(bind[index].buffer);
+      uint64_t unsignedValue= *reinterpret_cast<uint64_t*>(fieldBuf.arr);
 
       return static_cast<float>(unsignedValue);
     }
     case MYSQL_TYPE_FLOAT:
-      return *static_cast<float*>(bind[index].buffer);
+      return *reinterpret_cast<float*>(fieldBuf.arr);
     case MYSQL_TYPE_DOUBLE:
       return static_cast<float>(getInternalDouble(columnInfo));
     case MYSQL_TYPE_NEWDECIMAL:
@@ -555,7 +912,7 @@ namespace capi
     case MYSQL_TYPE_DECIMAL:
       try {
         char* end;
-        return std::strtof(static_cast<char*>(bind[index].buffer), &end);
+        return std::strtof(fieldBuf.arr, &end);
         // if (errno == ERANGE) ?
       }
       // Common parent for std::invalid_argument and std::out_of_range
@@ -576,13 +933,13 @@ namespace capi
   }
 
   /**
-    * Get double from raw binary format.
+    * Get double from raw binary format for any type.
     *
     * @param columnInfo column information
     * @return double value
     * @throws SQLException if column is not numeric or is not in Double bounds (unsigned columns).
     */
-  long double BinRowProtocolCapi::getInternalDouble(ColumnDefinition* columnInfo)
+  long double BinRowProtocolCapi::getDoubleGeneric(ColumnDefinition* columnInfo)
   {
     if (lastValueWasNull()) {
       return 0;
@@ -601,21 +958,21 @@ namespace capi
     case MYSQL_TYPE_LONGLONG:
     {
       if (columnInfo->isSigned()) {
-        return static_cast<long double>(*static_cast<int64_t*>(bind[index].buffer));
+        return static_cast<long double>(*reinterpret_cast<int64_t*>(fieldBuf.arr));
       }
-      return static_cast<long double>(*static_cast<uint64_t*>(bind[index].buffer));
+      return static_cast<long double>(*reinterpret_cast<uint64_t*>(fieldBuf.arr));
     }
     case MYSQL_TYPE_FLOAT:
       return getInternalFloat(columnInfo);
     case MYSQL_TYPE_DOUBLE:
-      return *static_cast<double*>(bind[index].buffer);
+      return *reinterpret_cast<double*>(fieldBuf.arr);
     case MYSQL_TYPE_NEWDECIMAL:
     case MYSQL_TYPE_VAR_STRING:
     case MYSQL_TYPE_VARCHAR:
     case MYSQL_TYPE_STRING:
     case MYSQL_TYPE_DECIMAL:
       try {
-        return std::stold(static_cast<char*>(bind[index].buffer));
+        return std::stold(fieldBuf.arr);
       }
       // Common parent for std::invalid_argument and std::out_of_range
       catch (std::logic_error& nfe) {
@@ -665,7 +1022,7 @@ namespace capi
     {
       if (length > 0)
       {
-        const char *asChar= static_cast<char*>(bind[index].buffer), *ptr= asChar, *end= asChar + strlen(asChar);
+        const char *asChar= fieldBuf.arr, *ptr= asChar, *end= asChar + strlen(asChar);
         if (*ptr == '+' || *ptr == '-') {
           ++ptr;
         }
@@ -764,7 +1121,7 @@ namespace capi
     case MYSQL_TYPE_DATETIME:
     case MYSQL_TYPE_DATE:
     {
-      MYSQL_TIME* mt= static_cast<MYSQL_TIME*>(bind[index].buffer);
+      MYSQL_TIME* mt= reinterpret_cast<MYSQL_TIME*>(fieldBuf.arr);
 
       if (isNullTimeStruct(mt, MYSQL_TYPE_DATE)) {
         lastValueNull |= BIT_LAST_ZERO_DATE;
@@ -777,7 +1134,7 @@ namespace capi
       throw SQLException("Cannot read Date using a Types::TIME field");
     case MYSQL_TYPE_STRING:
     {
-      SQLString rawValue(static_cast<char*>(bind[index].buffer));
+      SQLString rawValue(fieldBuf.arr);
 
       if (rawValue.compare(nullDate) == 0) {
         lastValueNull |= BIT_LAST_ZERO_DATE;
@@ -788,7 +1145,7 @@ namespace capi
     }
     case MYSQL_TYPE_YEAR:
     {
-      int32_t year = *static_cast<int16_t*>(bind[index].buffer);
+      int32_t year = *reinterpret_cast<int16_t*>(fieldBuf.arr);
       if (length == 2 && columnInfo->getLength() == 2) {
         if (year < 70) {
           year += 2000;
@@ -841,14 +1198,14 @@ namespace capi
     case MYSQL_TYPE_TIMESTAMP:
     case MYSQL_TYPE_DATETIME:
     {
-      MYSQL_TIME* mt= static_cast<MYSQL_TIME*>(bind[index].buffer);
+      MYSQL_TIME* mt= reinterpret_cast<MYSQL_TIME*>(fieldBuf.arr);
       return std::unique_ptr<Time>(new Time(makeStringFromTimeStruct(mt, MYSQL_TYPE_TIME, columnInfo->getDecimals())));
     }
     case MYSQL_TYPE_DATE:
       throw SQLException("Cannot read Time using a Types::DATE field");
     case MYSQL_TYPE_STRING:
     {
-      SQLString rawValue(static_cast<char*>(bind[index].buffer));
+      SQLString rawValue(fieldBuf.arr);
 
       /*if (rawValue.compare(*nullTime) == 0 || rawValue.compare("00:00:00") == 0) {
         lastValueNull |= BIT_LAST_ZERO_DATE;
@@ -895,7 +1252,7 @@ namespace capi
     case MYSQL_TYPE_DATETIME:
     case MYSQL_TYPE_DATE:
     {
-      MYSQL_TIME* mt= static_cast<MYSQL_TIME*>(bind[index].buffer);
+      MYSQL_TIME* mt= reinterpret_cast<MYSQL_TIME*>(fieldBuf.arr);
 
       if (isNullTimeStruct(mt, MYSQL_TYPE_TIMESTAMP)) {
         lastValueNull |= BIT_LAST_ZERO_DATE;
@@ -914,7 +1271,7 @@ namespace capi
     case MYSQL_TYPE_VAR_STRING:
     case MYSQL_TYPE_STRING:
     {
-      SQLString rawValue(static_cast<char*>(bind[index].buffer));
+      SQLString rawValue(fieldBuf.arr);
 
       if (rawValue.compare(*nullTs) == 0 || rawValue.compare("00:00:00") == 0) {
         lastValueNull |= BIT_LAST_ZERO_DATE;
@@ -972,7 +1329,7 @@ namespace capi
       return getInternalLong(columnInfo) != 0;
     }
     default:
-      return convertStringToBoolean(static_cast<char*>(bind[index].buffer), * bind[index].length);
+      return convertStringToBoolean(fieldBuf.arr, length);
     }
   }
 
@@ -1021,7 +1378,7 @@ namespace capi
     case MYSQL_TYPE_VARCHAR:
     case MYSQL_TYPE_STRING:
     {
-      value= std::stoll(static_cast<char*>(bind[index].buffer));
+      value= std::stoll(fieldBuf.arr);
       break;
     }
     default:
@@ -1056,7 +1413,7 @@ namespace capi
       break;
     case MYSQL_TYPE_SHORT:
     case MYSQL_TYPE_YEAR:
-      return *static_cast<int16_t*>(bind[index].buffer);
+      return *reinterpret_cast<int16_t*>(fieldBuf.arr);
     case MYSQL_TYPE_LONG:
     case MYSQL_TYPE_INT24:
       value= getInternalMediumInt(columnInfo);
@@ -1078,7 +1435,7 @@ namespace capi
     case MYSQL_TYPE_VARCHAR:
     case MYSQL_TYPE_STRING:
     {
-      value= std::stoll(static_cast<char*>(bind[index].buffer));
+      value= std::stoll(fieldBuf.arr);
       break;
     }
     default:
@@ -1102,7 +1459,7 @@ namespace capi
     if (lastValueWasNull()) {
       return "";
     }
-    MYSQL_TIME* ts= static_cast<MYSQL_TIME*>(bind[index].buffer);
+    MYSQL_TIME* ts= reinterpret_cast<MYSQL_TIME*>(fieldBuf.arr);
     return makeStringFromTimeStruct(ts, MYSQL_TYPE_TIME, columnInfo->getDecimals());
   }
 
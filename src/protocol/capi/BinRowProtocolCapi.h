@@ -41,9 +41,23 @@ class BinRowProtocolCapi : public RowProtocol {
   int32_t columnInformationLength;
   MYSQL_STMT* stmt;
   std::vector<MYSQL_BIND> bind;
+  /* Indexes of variable length columns, which buffers can be too small for the fetched value */
+  std::vector<uint32_t> growableColumns;
+  std::vector<ColumnConverters<BinRowProtocolCapi>> converters;
 
   SQLString * convertToString(const char * asChar, ColumnDefinition * columnInfo);
+  void fetchTruncatedColumns();
+  void initConverters();
+
+  int32_t getIntGeneric(ColumnDefinition* columnInfo);
+  int64_t getLongGeneric(ColumnDefinition* columnInfo);
+  long double getDoubleGeneric(ColumnDefinition* columnInfo);
+  template <typename T> int32_t getIntFromBinary(ColumnDefinition* columnInfo);
+  template <typename T> int64_t getLongFromBinary(ColumnDefinition* columnInfo);
+  template <typename T> long double getDoubleFromBinary(ColumnDefinition* columnInfo);
 public:
+  /* Initial buffer length for variable length columns. Buffers grow, if bigger values are fetched */
+  static const unsigned long INITIAL_BUFFER_LENGTH= 4096;
 
   BinRowProtocolCapi(
     std::vector<Shared::ColumnDefinition>& columnInformation,
@@ -65,9 +79,11 @@ public:
   BigInteger getInternalBigInteger(ColumnDefinition* columnInfo);
 #endif
   int32_t fetchNext();
+  const char* getRawValue(int32_t columnIndex, std::size_t& len);
   void installCursorAtPosition(int32_t rowPtr);
 
   std::unique_ptr<SQLString> getInternalString(ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr);
+  const char* getInternalStringView(ColumnDefinition* columnInfo, std::size_t& len);
   Date getInternalDate(ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr);
   std::unique_ptr<Time> getInternalTime(ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr);
   std::unique_ptr<Timestamp> getInternalTimestamp( ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr);
@@ -86,6 +102,7 @@ public:
 
 
   bool isBinaryEncoded();
+  void appendToBatch(ColumnBatch& batch, std::size_t rowIndex, const std::vector<Shared::ColumnDefinition>& columnInformation);
   };
 
 }
@@ -29,6 +29,7 @@
 #include "ExceptionFactory.h"
 #include "util/Utils.h"
 #include "util/LogQueryTool.h"
+#include "util/ServerPrepareStatementCache.h"
 
 namespace sql
 {
@@ -62,6 +63,7 @@ namespace capi
     , username(_urlParser->getUsername())
     , globalInfo(globalInfo)
     , connection(NULL, &mysql_close)
+    , maxAllowedPacket(0x01000000)
     , currentHost(localhost, 3306)
     , explicitClosed(false)
     , majorVersion(0)
@@ -70,11 +72,14 @@ namespace capi
   {
     urlParser->auroraPipelineQuirks();
     if (options->cachePrepStmts && options->useServerPrepStmts){
-      serverPrepareStatementCache= NULL;
-        //ServerPrepareStatementCache.newInstance(options->prepStmtCacheSize,this);
+      serverPrepareStatementCache.reset(ServerPrepareStatementCache::newInstance(options->prepStmtCacheSize, this));
     }
   }
 
+  ConnectProtocol::~ConnectProtocol()
+  {
+  }
+
   void ConnectProtocol::closeSocket()
   {
     try {
@@ -343,7 +348,7 @@ namespace capi
   void ConnectProtocol::cleanMemory()
   {
     if (options->cachePrepStmts && options->useServerPrepStmts && serverPrepareStatementCache){
-      //serverPrepareStatementCache.clear();
+      serverPrepareStatementCache->clear();
     }
     if (options->enablePacketDebug){
       //traceCache->clearMemory();
@@ -630,13 +635,13 @@ namespace capi
           additionalData(serverData);
         }
 
-        std::size_t maxAllowedPacket= static_cast<std::size_t>(std::stoi(StringImp::get(serverData["max_allowed_packet"])));
+        maxAllowedPacket= static_cast<std::size_t>(std::stoll(StringImp::get(serverData["max_allowed_packet"])));
         mysql_optionsv(connection.get(), MYSQL_OPT_MAX_ALLOWED_PACKET, &maxAllowedPacket);
         autoIncrementIncrement= std::stoi(StringImp::get(serverData["auto_increment_increment"]));
         loadCalendar(serverData["time_zone"],serverData["system_time_zone"]);
 
       }else {
-        size_t maxAllowedPacket= static_cast<size_t>(globalInfo->getMaxAllowedPacket());
+        maxAllowedPacket= static_cast<size_t>(globalInfo->getMaxAllowedPacket());
         mysql_optionsv(connection.get(), MYSQL_OPT_MAX_ALLOWED_PACKET, &maxAllowedPacket);
         autoIncrementIncrement= globalInfo->getAutoIncrementIncrement();
         loadCalendar(globalInfo->getTimeZone(), globalInfo->getSystemTimeZone());
@@ -1321,7 +1326,7 @@ namespace capi
 
   ServerPrepareStatementCache* ConnectProtocol::prepareStatementCache()
   {
-    return serverPrepareStatementCache;
+    return serverPrepareStatementCache.get();
   }
 
   /**
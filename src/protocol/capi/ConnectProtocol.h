@@ -61,7 +61,7 @@ namespace capi
     std::shared_ptr<UrlParser> urlParser;
     Shared::Options options;
     Shared::ExceptionFactory exceptionFactory;
-    virtual ~ConnectProtocol() {}
+    virtual ~ConnectProtocol();
   private:
     const SQLString username;
     //const LruTraceCache traceCache; /*new LruTraceCache()*/
@@ -75,6 +75,8 @@ namespace capi
 
   protected:
     int32_t autoIncrementIncrement;
+    /* Server's max_allowed_packet. Batches are split into commands not exceeding it */
+    std::size_t maxAllowedPacket;
 
     bool readOnly; /*false*/
     FailoverProxy* proxy;
@@ -82,7 +84,7 @@ namespace capi
     bool explicitClosed; /*false*/
     SQLString database;
     int64_t serverThreadId;
-    ServerPrepareStatementCache* serverPrepareStatementCache;
+    std::unique_ptr<ServerPrepareStatementCache> serverPrepareStatementCache;
     bool eofDeprecated; /*false*/
     int64_t serverCapabilities;
     int32_t socketTimeout;
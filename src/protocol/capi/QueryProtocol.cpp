@@ -32,10 +32,19 @@
 #include "SqlStates.h"
 #include "com/capi/ColumnDefinitionCapi.h"
 #include "ExceptionFactory.h"
+#include "StringImp.h"
 #include "util/ServerStatus.h"
+#include "parameters/ParameterArray.h"
 //I guess eventually it should go from here
 #include "com/Packet.h"
 
+#ifdef _WIN32
+# include <winsock2.h>
+#else
+# include <poll.h>
+# include <sys/socket.h>
+#endif
+
 namespace sql
 {
 namespace mariadb
@@ -70,8 +79,8 @@ namespace capi
     : super(urlParser,globalInfo,lock)
     , logQuery(new LogQueryTool(options))
     , activeFutureTask(nullptr)
-    , statementIdToRelease(nullptr)
     , maxRows(0)
+    , interrupted(false)
   {
     if (!urlParser->getOptions()->galeraAllowedState.empty())
     {
@@ -89,8 +98,9 @@ namespace capi
         throw SQLException("Connection reset failed");
       }
 
+      // Server has deallocated all prepared statements
       if (options->cachePrepStmts && options->useServerPrepStmts){
-        //serverPrepareStatementCache->clear();
+        serverPrepareStatementCache->clear();
       }
 
     }catch (SQLException& sqlException){
@@ -330,7 +340,64 @@ namespace capi
   }
 
   /**
-   * Execute clientPrepareQuery batch.
+   * Returns length of the length-encoded integer, prefixing value of given length in the binary protocol.
+   */
+  std::size_t lengthEncodedSize(std::size_t length)
+  {
+    if (length < 251) {
+      return 1;
+    }
+    if (length < 0x10000) {
+      return 3;
+    }
+    if (length < 0x1000000) {
+      return 4;
+    }
+    return 9;
+  }
+
+  /**
+   * Returns number of rows, starting from the offset, which can be sent in one COM_STMT_BULK_EXECUTE packet
+   * without exceeding max_allowed_packet. The packet contains the statement id, flags and types of parameters,
+   * followed by the indicator byte and the value of each parameter of each row. At least one row is always taken -
+   * if it alone does not fit, the server reports the error.
+   *
+   * @param offset index of the first row of the chunk
+   * @param rowCount number of rows in the batch
+   * @param parameterCount number of parameters
+   * @param maxPacketLength server's max_allowed_packet
+   * @param valueLength function returning binary length of the value of the row and parameter, or -1 for NULL
+   * @return number of rows in the chunk
+   */
+  template <class ValueLength>
+  std::size_t bulkChunkSize(std::size_t offset, std::size_t rowCount, std::size_t parameterCount,
+    std::size_t maxPacketLength, ValueLength valueLength)
+  {
+    // command, statement id, flags and 2 bytes of type of each parameter
+    std::size_t packetLength= 1 + 4 + 2 + 2*parameterCount;
+    std::size_t row= offset;
+
+    while (row < rowCount) {
+      std::size_t rowLength= parameterCount;
+
+      for (std::size_t i= 0; i < parameterCount; ++i) {
+        int64_t length= valueLength(row, i);
+        if (length >= 0) {
+          rowLength+= lengthEncodedSize(static_cast<std::size_t>(length)) + static_cast<std::size_t>(length);
+        }
+      }
+      if (row > offset && packetLength + rowLength > maxPacketLength) {
+        break;
+      }
+      packetLength+= rowLength;
+      ++row;
+    }
+    return row - offset;
+  }
+
+  /**
+   * Execute clientPrepareQuery batch with bulk protocol. Rows are sent in chunks, each fitting into
+   * max_allowed_packet.
    *
    * @param results results
    * @param sql sql command
@@ -353,26 +420,28 @@ namespace capi
     // **************************************************************************************
 
     SQLString sql(origSql);
-    std::vector<Shared::ParameterHolder> initParameters= parametersList.front();
-    size_t parameterCount= initParameters.size();
-    std::vector<int16_t> types;
-    types.reserve(parameterCount);
-
-    for (size_t i= 0;i < parameterCount; i++) {
-      types.push_back(initParameters[i]->getColumnType().getType());
-    }
-
+    size_t parameterCount= parametersList.front().size();
+    // Type of the parameter is taken from the first row, where it is not NULL. NULL is compatible with any type
+    std::vector<int16_t> types(parameterCount, ColumnType::_NULL.getType());
 
     for (auto& parameters :parametersList){
       for (size_t i= 0;i <parameterCount; i++){
-        if (parameters[i]->getColumnType().getType() != types[i]) {
+        if (parameters[i]->isNullData()) {
+          continue;
+        }
+        int16_t type= parameters[i]->getColumnType().getType();
+
+        if (types[i] == ColumnType::_NULL.getType()) {
+          types[i]= type;
+        }
+        else if (type != types[i]) {
           return false;
         }
       }
     }
 
 
-    if ((sql.toLowerCase().find_first_of("select") != std::string::npos)){
+    if ((StringImp::get(sql.toLowerCase()).find("select") != std::string::npos)){
       return false;
     }
 
@@ -397,31 +466,50 @@ namespace capi
         return false;
       }
 
-      unsigned int bulkArrSize= static_cast<unsigned int>(parametersList.size());
+      // The batch is sent in chunks not exceeding max_allowed_packet. Each chunk adds its update count, and
+      // being rewritten, they are merged by CmdInformationBatch
+      const std::size_t rowCount= parametersList.size();
+      std::size_t offset= 0;
 
-      mysql_stmt_attr_set(statementId, STMT_ATTR_ARRAY_SIZE, (const void*)&bulkArrSize);
-      auto firstParameters= parametersList.front();
+      do {
+        std::size_t chunkSize= bulkChunkSize(offset, rowCount, parameterCount, maxAllowedPacket,
+          [&parametersList](std::size_t row, std::size_t i) {
+            ParameterHolder* param= parametersList[row][i].get();
+            return param->isNullData() ? -1 : static_cast<int64_t>(param->getValueBinLen());
+          });
+        unsigned int bulkArrSize= static_cast<unsigned int>(chunkSize);
 
-      serverPrepareResult->bindParameters(parametersList);
-      mysql_stmt_execute(statementId);
+        mysql_stmt_attr_set(statementId, STMT_ATTR_ARRAY_SIZE, (const void*)&bulkArrSize);
 
-      try {
-        getResult(results.get());
-      }catch (SQLException& sqle){
-        if (sqle.getSQLState().compare("HY000") == 0 && sqle.getErrorCode()==1295){
-          // query contain commands that cannot be handled by BULK protocol
-          // clear error and special error code, so it won't leak anywhere
-          // and wouldn't be misinterpreted as an additional update count
-          results->getCmdInformation()->reset();
-          return false;
-        }
-        if (exception.getMessage().empty()){
-          exception= logQuery->exceptionWithQuery(sql, sqle, explicitClosed);
-          if (!options->continueBatchOnError){
-            throw exception;
+        tmpServerPrepareResult->bindParameters(parametersList, offset, chunkSize);
+        mysql_stmt_execute(statementId);
+
+        // The statement may be cached and re-used for single executions - array size has to be reset
+        bulkArrSize= 0;
+        mysql_stmt_attr_set(statementId, STMT_ATTR_ARRAY_SIZE, (const void*)&bulkArrSize);
+
+        try {
+          getResult(results.get(), tmpServerPrepareResult);
+        }catch (SQLException& sqle){
+          if (offset == 0 && sqle.getSQLState().compare("HY000") == 0 && sqle.getErrorCode()==1295){
+            // query contain commands that cannot be handled by BULK protocol
+            // clear error and special error code, so it won't leak anywhere
+            // and wouldn't be misinterpreted as an additional update count
+            results->getCmdInformation()->reset();
+            if (!serverPrepareResult) {
+              releasePrepareStatement(tmpServerPrepareResult);
+            }
+            return false;
+          }
+          if (exception.getMessage().empty()){
+            exception= logQuery->exceptionWithQuery(sql, sqle, explicitClosed);
+            if (!options->continueBatchOnError){
+              throw exception;
+            }
           }
         }
-      }
+        offset+= chunkSize;
+      } while (offset < rowCount);
 
       if (!exception.getMessage().empty()){
         throw exception;
@@ -468,15 +556,71 @@ namespace capi
     cmdPrologue();
     initializeBatchReader();
 
-    SQLString sql;
+    executeBatchPipeline(results, parametersList.size(),
+      [clientPrepareResult, &parametersList](SQLString& sql, std::size_t i) {
+        assemblePreparedQueryForExec(sql, clientPrepareResult, parametersList[i], -1);
+      });
+  }
 
-    for (auto& parameters : parametersList)
-    {
-      sql.clear();
+  /**
+   * Send queries without waiting for their results, up to useBatchMultiSendNumber queries at once, and then
+   * read all their results. Server executes queries, following the failed one in the same window, regardless of
+   * continueBatchOnError value. Each failure is registered in the results, thus update counts correspond to queries.
+   *
+   * @param results results
+   * @param queryCount number of queries in the batch
+   * @param assembleQuery functor, that writes query with given index to the string
+   * @throws SQLException first error of the batch, or connection error
+   */
+  void QueryProtocol::executeBatchPipeline(
+      Shared::Results& results,
+      std::size_t queryCount,
+      const std::function<void(SQLString&, std::size_t)>& assembleQuery)
+  {
+    const std::size_t windowSize= static_cast<std::size_t>(std::max(options->useBatchMultiSendNumber, 1));
+    std::vector<SQLString> window(std::min(windowSize, queryCount));
+    SQLException exception;
+    bool exceptionSet= false;
 
-      assemblePreparedQueryForExec(sql, clientPrepareResult, parameters, -1);
-      realQuery(sql);
-      getResult(results.get());
+    for (std::size_t windowStart= 0; windowStart < queryCount; windowStart+= windowSize) {
+      std::size_t windowEnd= std::min(windowStart + windowSize, queryCount), sent= windowStart;
+
+      for (; sent < windowEnd; ++sent) {
+        SQLString& sql= window[sent - windowStart];
+        sql.clear();
+        assembleQuery(sql, sent);
+
+        if (capi::mysql_send_query(connection.get(), sql.c_str(), static_cast<unsigned long>(sql.length())) != 0) {
+          break;
+        }
+      }
+
+      // Results have to be read for all sent queries, even if some of them have failed
+      for (std::size_t i= windowStart; i < sent; ++i) {
+        try {
+          capi::mysql_read_query_result(connection.get());
+          getResult(results.get());
+        }
+        catch (SQLException& sqle) {
+          if (!exceptionSet) {
+            exception= logQuery->exceptionWithQuery(window[i - windowStart], sqle, explicitClosed);
+            exceptionSet= true;
+          }
+        }
+      }
+
+      if (sent < windowEnd) {
+        SQLException sendError(mysql_error(connection.get()), mysql_sqlstate(connection.get()), mysql_errno(connection.get()));
+        throw logQuery->exceptionWithQuery(window[sent - windowStart], sendError, explicitClosed);
+      }
+      if (exceptionSet && !options->continueBatchOnError) {
+        throw exception;
+      }
+    }
+    stopIfInterrupted();
+
+    if (exceptionSet) {
+      throw exception;
     }
   }
 
@@ -529,7 +673,8 @@ namespace capi
 
     if (!options->useBatchMultiSend){
 
-      SQLException* exception= NULL;
+      SQLException exception;
+      bool exceptionSet= false;
 
       for (auto& sql : queries){
 
@@ -539,15 +684,17 @@ namespace capi
           getResult(results.get());
 
         }catch (SQLException& sqlException){
-          if (!exception){
-            *exception= logQuery->exceptionWithQuery(sql, sqlException, explicitClosed);
+          if (!exceptionSet){
+            exception= logQuery->exceptionWithQuery(sql, sqlException, explicitClosed);
+            exceptionSet= true;
             if (!options->continueBatchOnError){
               throw exception;
             }
           }
         }catch (std::runtime_error& e){
-          if (!exception){
-            *exception= handleIoException(e);
+          if (!exceptionSet){
+            exception= handleIoException(e);
+            exceptionSet= true;
             if (!options->continueBatchOnError){
               throw exception;
             }
@@ -556,18 +703,17 @@ namespace capi
       }
       stopIfInterrupted();
 
-      if (exception){
-        throw *exception;
+      if (exceptionSet){
+        throw exception;
       }
       return;
     }
     initializeBatchReader();
 
-    for (auto& query : queries)
-    {
-      realQuery(query);
-      getResult(results.get());
-    }
+    executeBatchPipeline(results, queries.size(),
+      [&queries](SQLString& sql, std::size_t i) {
+        sql.append(queries[i]);
+      });
   }
 
 
@@ -577,12 +723,16 @@ namespace capi
     cmdPrologue();
     std::lock_guard<std::mutex> localScopeLock(*lock);
 
+    forceReleaseWaitingPrepareStatement();
+
+    const bool cacheable= options->cachePrepStmts && options->useServerPrepStmts
+      && sql.length() < static_cast<size_t>(options->prepStmtCacheSqlLimit);
     //try {
-    if (options->cachePrepStmts && options->useServerPrepStmts){
+    if (cacheable){
 
       ServerPrepareResult* pr= serverPrepareStatementCache->get(database+"-"+sql);
 
-      if (pr && pr->incrementShareCounter()){
+      if (pr){
         return pr;
       }
     }
@@ -609,18 +759,8 @@ namespace capi
 
     ServerPrepareResult *res= new ServerPrepareResult(sql, stmtId, this);
 
-    if (getOptions()->cachePrepStmts
-      && getOptions()->useServerPrepStmts
-      && sql.length() < static_cast<size_t>(getOptions()->prepStmtCacheSqlLimit)) {
-      SQLString key(getDatabase() + "-" + sql);
-
-      ServerPrepareResult* cachedServerPrepareResult= addPrepareInCache(key, res);
-
-      if (cachedServerPrepareResult != NULL)
-      {
-        delete res;
-        res= cachedServerPrepareResult;
-      }
+    if (cacheable) {
+      addPrepareInCache(database + "-" + sql, res);
     }
 
     return res;
@@ -631,20 +771,29 @@ namespace capi
   }
 
 
-  bool checkRemainingSize(int64_t newQueryLen)
+  /**
+   * Checks if the query of given length still fits into one COM_QUERY packet.
+   *
+   * @param newQueryLen length of the query
+   * @param maxPacketLength server's max_allowed_packet
+   * @return true if query can be sent
+   */
+  bool checkRemainingSize(std::size_t newQueryLen, std::size_t maxPacketLength)
   {
-    return newQueryLen < MAX_PACKET_LENGTH;
+    // The packet also contains the command byte
+    return newQueryLen < maxPacketLength;
   }
 
 
-  size_t assembleBatchAggregateSemiColonQuery(SQLString& sql, const SQLString &firstSql, const std::vector<SQLString>& queries, size_t currentIndex)
+  size_t assembleBatchAggregateSemiColonQuery(SQLString& sql, const SQLString &firstSql, const std::vector<SQLString>& queries,
+    size_t currentIndex, std::size_t maxPacketLength)
   {
     sql.append(firstSql);
 
     // add query with ";"
     while (currentIndex < queries.size()) {
 
-      if (checkRemainingSize(sql.length() + queries[currentIndex].length() + 1)) {
+      if (!checkRemainingSize(sql.length() + queries[currentIndex].length() + 1, maxPacketLength)) {
         break;
       }
       sql.append(';').append(queries[currentIndex]);
@@ -678,7 +827,7 @@ namespace capi
 
         firstSql= queries[currentIndex++];
 
-        currentIndex= assembleBatchAggregateSemiColonQuery(sql, firstSql, queries, currentIndex);
+        currentIndex= assembleBatchAggregateSemiColonQuery(sql, firstSql, queries, currentIndex, maxAllowedPacket);
         realQuery(sql);
         sql.clear(); // clear is not supposed to release memory
 
@@ -704,9 +853,30 @@ namespace capi
   }
 
 
+  /**
+  * Returns approximate length of the row's parameters values in the text protocol.
+  *
+  * @param parameters parameters of the row
+  * @return length, or -1 if it can't be known before the value is read (streams)
+  */
+  int64_t approximateTextRowLength(const std::vector<Shared::ParameterHolder>& parameters)
+  {
+    int64_t rowLength= 0;
+
+    for (auto& parameter : parameters) {
+      int64_t paramSize= parameter->getApproximateTextProtocolLength();
+      if (paramSize == -1) {
+        return -1;
+      }
+      rowLength+= paramSize;
+    }
+    return rowLength;
+  }
+
   /**
   * Client side PreparedStatement.executeBatch values rewritten (concatenate value params according
-  * to max_allowed_packet)
+  * to max_allowed_packet). The first row is always written, following rows - while the query fits into
+  * max_allowed_packet. Row with parameter of unknown length starts new query.
   *
   * @param pos query string
   * @param queryParts query parts
@@ -714,6 +884,7 @@ namespace capi
   * @param paramCount parameter pos
   * @param parameterList parameter list
   * @param rewriteValues is query rewritable by adding values
+  * @param maxPacketLength server's max_allowed_packet
   * @return current index
   * @throws IOException if connection fail
   */
@@ -722,11 +893,11 @@ namespace capi
     std::size_t currentIndex,
     std::size_t paramCount,
     std::vector<std::vector<Shared::ParameterHolder>> &parameterList,
-    bool rewriteValues)
-
+    bool rewriteValues,
+    std::size_t maxPacketLength)
   {
     std::size_t index= currentIndex;
-    std::vector<Shared::ParameterHolder> &parameters= parameterList[index++];
+    std::vector<Shared::ParameterHolder>* parameters= &parameterList[index++];
 
     const SQLString &firstPart= queryParts[0];
     const SQLString &secondPart= queryParts[1];
@@ -742,58 +913,30 @@ namespace capi
       }
 
       for (size_t i= 0; i < paramCount; i++) {
-        parameters[i]->writeTo(pos);
+        (*parameters)[i]->writeTo(pos);
         pos.append(queryParts[i +2]);
       }
       pos.append(queryParts[paramCount +2]);
 
 
-      while (index <parameterList.size()) {
-        parameters= parameterList[index];
+      while (index < parameterList.size()) {
+        parameters= &parameterList[index];
 
+        int64_t parameterLength= approximateTextRowLength(*parameters);
 
-        int64_t parameterLength= 0;
-        bool knownParameterSize= true;
-        for (auto& parameter : parameters) {
-          int64_t paramSize= parameter->getApproximateTextProtocolLength();
-          if (paramSize == -1) {
-            knownParameterSize= false;
-            break;
-          }
-          parameterLength+= paramSize;
-        }
-
-        if (knownParameterSize) {
-
-
-          if (checkRemainingSize(pos.length() + staticLength + parameterLength)) {
-            pos.append(';');
-            pos.append(firstPart);
-            pos.append(secondPart);
-            for (size_t i= 0; i <paramCount; i++) {
-              parameters[i]->writeTo(pos);
-              pos.append(queryParts[i + 2]);
-            }
-            pos.append(queryParts[paramCount +2]);
-            index++;
-          }
-          else {
-            break;
-          }
-        }
-        else {
-
-          pos.append(';');
-          pos.append(firstPart);
-          pos.append(secondPart);
-          for (size_t i= 0; i < paramCount; i++) {
-            parameters[i]->writeTo(pos);
-            pos.append(queryParts[i +2]);
-          }
-          pos.append(queryParts[paramCount +2]);
-          index++;
+        if (parameterLength == -1
+          || !checkRemainingSize(pos.length() + staticLength + static_cast<std::size_t>(parameterLength), maxPacketLength)) {
           break;
         }
+        pos.append(';');
+        pos.append(firstPart);
+        pos.append(secondPart);
+        for (size_t i= 0; i <paramCount; i++) {
+          (*parameters)[i]->writeTo(pos);
+          pos.append(queryParts[i + 2]);
+        }
+        pos.append(queryParts[paramCount +2]);
+        index++;
       }
 
     }
@@ -804,54 +947,29 @@ namespace capi
       size_t intermediatePartLength= queryParts[1].length();
 
       for (size_t i= 0; i <paramCount; i++) {
-        parameters[i]->writeTo(pos);
+        (*parameters)[i]->writeTo(pos);
         pos.append(queryParts[i +2]);
         intermediatePartLength +=queryParts[i +2].length();
       }
 
-      while (index <parameterList.size()) {
-        parameters= parameterList[index];
-
-
-        int64_t parameterLength= 0;
-        bool knownParameterSize= true;
-        for (auto& parameter : parameters) {
-          int64_t paramSize= parameter->getApproximateTextProtocolLength();
-          if (paramSize == -1) {
-            knownParameterSize= false;
-            break;
-          }
-          parameterLength +=paramSize;
-        }
-
-        if (knownParameterSize) {
-
+      while (index < parameterList.size()) {
+        parameters= &parameterList[index];
 
-          if (checkRemainingSize(pos.length() + 1 + parameterLength + intermediatePartLength + lastPartLength)) {
-            pos.append(',');
-            pos.append(secondPart);
+        int64_t parameterLength= approximateTextRowLength(*parameters);
 
-            for (size_t i= 0; i <paramCount; i++) {
-              parameters[i]->writeTo(pos);
-              pos.append(queryParts[i + 2]);
-            }
-            index++;
-          }
-          else {
-            break;
-          }
+        if (parameterLength == -1
+          || !checkRemainingSize(pos.length() + 1 + static_cast<std::size_t>(parameterLength) + intermediatePartLength + lastPartLength,
+            maxPacketLength)) {
+          break;
         }
-        else {
-          pos.append(',');
-          pos.append(secondPart);
+        pos.append(',');
+        pos.append(secondPart);
 
-          for (size_t i= 0; i <paramCount; i++) {
-            parameters[i]->writeTo(pos);
-            pos.append(queryParts[i +2]);
-          }
-          index++;
-          break;
+        for (size_t i= 0; i <paramCount; i++) {
+          (*parameters)[i]->writeTo(pos);
+          pos.append(queryParts[i + 2]);
         }
+        index++;
       }
       pos.append(queryParts[paramCount +2]);
     }
@@ -878,12 +996,23 @@ namespace capi
     //std::vector<ParameterHolder>::const_iterator parameters;
     std::size_t currentIndex= 0;
     std::size_t totalParameterList= parameterList.size();
+    SQLString& sql= rewriteBuffer;
+
+    // Allocating the buffer once for the whole batch, or for the max_allowed_packet size query
+    int64_t rowLength= approximateTextRowLength(parameterList.front());
+    if (rowLength >= 0) {
+      std::size_t staticLength= 1;
+      for (auto& queryPart : prepareResult->getQueryParts()) {
+        staticLength+= queryPart.length();
+      }
+      sql.reserve(std::min((staticLength + static_cast<std::size_t>(rowLength))*totalParameterList, maxAllowedPacket));
+    }
 
     try {
-      SQLString sql;
       do {
         sql.clear();
-        rewriteQuery(sql, prepareResult->getQueryParts(), currentIndex, prepareResult->getParamCount(), parameterList, rewriteValues);
+        currentIndex= rewriteQuery(sql, prepareResult->getQueryParts(), currentIndex, prepareResult->getParamCount(), parameterList,
+          rewriteValues, maxAllowedPacket);
         realQuery(sql);
         getResult(results.get());
 
@@ -896,19 +1025,36 @@ namespace capi
       } while (currentIndex < totalParameterList);
 
     }catch (SQLException& sqlEx){
+      releaseRewriteBuffer();
       throw logQuery->exceptionWithQuery(sqlEx,prepareResult);
     }catch (std::runtime_error& e){
+      releaseRewriteBuffer();
       throw handleIoException(e);
     }/* TODO: something with the finally was once here */ {
+      releaseRewriteBuffer();
       results->setRewritten(rewriteValues);
     }
   }
 
   /**
-   * Execute Prepare if needed, and execute COM_STMT_EXECUTE queries in batch.
+   * Empties the buffer of rewritten queries. Its memory is kept for next batches, unless it has grown too big to be
+   * held by idle connection.
+   */
+  void QueryProtocol::releaseRewriteBuffer()
+  {
+    std::string& buffer= StringImp::get(rewriteBuffer);
+
+    buffer.clear();
+    if (buffer.capacity() > MAX_KEPT_REWRITE_BUFFER) {
+      std::string().swap(buffer);
+    }
+  }
+
+  /**
+   * Execute COM_STMT_EXECUTE queries in batch, with bulk protocol if possible.
    *
    * @param mustExecuteOnMaster must normally be executed on master connection
-   * @param serverPrepareResult prepare result. can be null if not prepared.
+   * @param serverPrepareResult prepare result. The batch is not executed here if it is null.
    * @param results execution results
    * @param sql sql query if needed to be prepared
    * @param parametersList parameter list
@@ -934,32 +1080,112 @@ namespace capi
       return true;
     }
 
-    if (!options->useBatchMultiSend){
+    if (!options->useBatchMultiSend || serverPrepareResult == nullptr){
       return false;
     }
     initializeBatchReader();
 
-    capi::MYSQL_STMT *stmt= nullptr;
+    // Connector/C cannot send COM_STMT_EXECUTE without reading its result, thus rows are executed one by one. They
+    // still use binary protocol - inlining values into text queries would change how they are converted
+    SQLException exception;
+    bool exceptionSet= false;
 
-    if (serverPrepareResult == nullptr)
-    {
-      serverPrepareResult= prepare(sql, true);
+    for (auto& parameters : parametersList) {
+      const int32_t statNumber= results->getCurrentStatNumber();
+
+      try {
+        serverPrepareResult->resetParameterTypeHeader();
+        executePreparedQuery(mustExecuteOnMaster, serverPrepareResult, results, parameters);
+      }
+      catch (SQLException& sqle) {
+        // Failed execution is not always registered in results, but update counts have to correspond to rows
+        if (results->getCurrentStatNumber() == statNumber) {
+          results->addStatsError(false);
+        }
+        if (!options->continueBatchOnError || !isConnected() || isInterrupted()) {
+          throw;
+        }
+        if (!exceptionSet) {
+          exception= sqle;
+          exceptionSet= true;
+        }
+      }
     }
+    stopIfInterrupted();
 
-    stmt= serverPrepareResult->getStatementId();
+    if (exceptionSet) {
+      throw exception;
+    }
+    return true;
+  }
 
-    std::size_t totalExecutionNumber= parametersList.size();
-    //std::size_t parameterCount= serverPrepareResult->getParameters().size();
 
-    for (auto& paramset : parametersList)
-    {
-      executePreparedQuery(true, serverPrepareResult, results, paramset);
+  /**
+   * Execute prepared statement for all rows of the batch with bulk protocol, using parameters values bound
+   * by array setters. Values are sent directly from application's arrays, in chunks fitting into max_allowed_packet.
+   *
+   * @param serverPrepareResult prepare result
+   * @param results execution results
+   * @param parameterArrays values of each parameter for all rows
+   * @param rowCount number of rows in the batch
+   * @return false if bulk execution is not possible, and the batch has to be executed in other way
+   * @throws SQLException if parameter error or connection error occur.
+   */
+  bool QueryProtocol::executeBulkArrays(
+      ServerPrepareResult* serverPrepareResult,
+      Shared::Results& results,
+      const std::vector<ParameterArray>& parameterArrays,
+      std::size_t rowCount)
+  {
+    if (!options->useBulkStmts
+        || results->getAutoGeneratedKeys() != Statement::NO_GENERATED_KEYS
+        || !versionGreaterOrEqual(10,2,7)
+        || !serverPrepareResult->getColumns().empty()){
+      return false;
     }
 
-    //TODO:!!! what to do with serverPrepareResult here? delete? leaking otherwise. but I don't think we can do that here
-    delete serverPrepareResult;
+    cmdPrologue();
 
-    return true;
+    capi::MYSQL_STMT* statementId= serverPrepareResult->getStatementId();
+    std::size_t offset= 0;
+
+    try {
+      do {
+        std::size_t chunkSize= bulkChunkSize(offset, rowCount, parameterArrays.size(), maxAllowedPacket,
+          [&parameterArrays](std::size_t row, std::size_t i) {
+            const ParameterArray& parameterArray= parameterArrays[i];
+            return parameterArray.isNull(row) ? -1 : static_cast<int64_t>(parameterArray.valueLength(row));
+          });
+        unsigned int bulkArrSize= static_cast<unsigned int>(chunkSize);
+
+        mysql_stmt_attr_set(statementId, STMT_ATTR_ARRAY_SIZE, (const void*)&bulkArrSize);
+
+        serverPrepareResult->bindParameters(parameterArrays, offset, chunkSize);
+        mysql_stmt_execute(statementId);
+
+        // The statement may be re-used for single executions - array size has to be reset
+        bulkArrSize= 0;
+        mysql_stmt_attr_set(statementId, STMT_ATTR_ARRAY_SIZE, (const void*)&bulkArrSize);
+
+        try {
+          getResult(results.get(), serverPrepareResult);
+        }catch (SQLException& sqle){
+          if (offset == 0 && sqle.getSQLState().compare("HY000") == 0 && sqle.getErrorCode()==1295){
+            // query contain commands that cannot be handled by BULK protocol
+            results->getCmdInformation()->reset();
+            return false;
+          }
+          throw logQuery->exceptionWithQuery(serverPrepareResult->getSql(), sqle, explicitClosed);
+        }
+        offset+= chunkSize;
+      } while (offset < rowCount);
+
+      results->setRewritten(true);
+      return true;
+
+    }catch (std::runtime_error& e){
+      throw handleIoException(e);
+    }
   }
 
 
@@ -1033,6 +1259,11 @@ namespace capi
    */
   bool QueryProtocol::forceReleasePrepareStatement(MYSQL_STMT* statementId)
   {
+    if (!connected) {
+      // Handle is not valid on the server anymore, only its memory has to be freed
+      mysql_stmt_close(statementId);
+      return true;
+    }
 
     if (lock->try_lock()) {
       checkClose();
@@ -1049,23 +1280,39 @@ namespace capi
       return true;
 
     }else {
-      statementIdToRelease= statementId;
+      std::lock_guard<std::mutex> localScopeLock(statementIdToReleaseLock);
+      statementIdToRelease.push_back(statementId);
     }
 
     return false;
   }
 
+  /**
+   * Queues prepared statement to be deallocated by the next prepare, or on close. Used, where the lock may
+   * be already held by the caller, and can't be taken again.
+   *
+   * @param statementId prepared statement handle to release
+   */
+  void QueryProtocol::deferReleasePrepareStatement(MYSQL_STMT* statementId)
+  {
+    std::lock_guard<std::mutex> localScopeLock(statementIdToReleaseLock);
+    statementIdToRelease.push_back(statementId);
+  }
+
   /**
    * Force release of prepare statement that are not used. This permit to deallocate a statement
-   * that cannot be release due to multi-thread use.
+   * that cannot be release due to multi-thread use. Lock has to be set.
    *
    * @throws SQLException if connection occur
    */
   void QueryProtocol::forceReleaseWaitingPrepareStatement()
   {
-    if (statementIdToRelease != NULL && forceReleasePrepareStatement(statementIdToRelease)){
-      statementIdToRelease= NULL;
+    std::lock_guard<std::mutex> localScopeLock(statementIdToReleaseLock);
+
+    for (auto statementId : statementIdToRelease) {
+      mysql_stmt_close(statementId);
     }
+    statementIdToRelease.clear();
   }
 
 
@@ -1085,6 +1332,60 @@ namespace capi
   }
 
 
+  /**
+    * Checks without blocking and without a round trip, if the server has closed the idle connection. Only hang up,
+    * error, or end of stream on the socket are taken as the proof. Anything else, including data to read and
+    * failed poll, does not tell if the connection is usable, and the caller has to check it with isValid. For TLS
+    * connections socket state tells nothing - TLS layer may have records to read, e.g. TLS 1.3 session tickets.
+    *
+    * @return true if the connection is closed for sure
+    */
+  bool QueryProtocol::isClosedByServer()
+  {
+    if (!connected) {
+      return true;
+    }
+    if (activeStreamingResult || mysql_get_ssl_cipher(connection.get()) != nullptr) {
+      return false;
+    }
+    my_socket socket= mysql_get_socket(connection.get());
+#ifdef _WIN32
+    WSAPOLLFD pfd;
+    pfd.fd= socket;
+    pfd.events= POLLRDNORM;
+    pfd.revents= 0;
+
+    if (WSAPoll(&pfd, 1, 0) <= 0) {
+      return false;
+    }
+    if ((pfd.revents & (POLLHUP | POLLERR)) != 0) {
+      return true;
+    }
+    if ((pfd.revents & POLLRDNORM) != 0) {
+      char peek;
+      return recv(socket, &peek, 1, MSG_PEEK) == 0;
+    }
+#else
+    struct pollfd pfd;
+    pfd.fd= socket;
+    pfd.events= POLLIN;
+    pfd.revents= 0;
+
+    if (poll(&pfd, 1, 0) <= 0) {
+      return false;
+    }
+    if ((pfd.revents & (POLLHUP | POLLERR)) != 0) {
+      return true;
+    }
+    if ((pfd.revents & POLLIN) != 0) {
+      char peek;
+      return recv(socket, &peek, 1, MSG_PEEK | MSG_DONTWAIT) == 0;
+    }
+#endif
+    return false;
+  }
+
+
   bool QueryProtocol::isValid(int32_t timeout)
   {
 
@@ -1225,6 +1526,14 @@ namespace capi
   }
 
 
+  void QueryProtocol::close()
+  {
+    super::close();
+    // Connection is closed, and the handles only have to be freed
+    forceReleaseWaitingPrepareStatement();
+  }
+
+
   void QueryProtocol::closeExplicit()
   {
     this->explicitClosed= true;
@@ -1238,9 +1547,11 @@ namespace capi
 
     serverPrepareResult->decrementShareCounter();
 
-
+    // Cached statement is deallocated by the cache, when it's evicted
     if (serverPrepareResult->canBeDeallocate()){
-      forceReleasePrepareStatement(serverPrepareResult->getStatementId());
+      capi::MYSQL_STMT* statementId= serverPrepareResult->getStatementId();
+      delete serverPrepareResult;
+      forceReleasePrepareStatement(statementId);
     }
   }
 
@@ -1814,7 +2125,7 @@ namespace capi
           if (maxSizeError){
             return SQLTransientConnectionException(
                 "Could not send query: query size is >= to max_allowed_packet ("
-                +/*writer.getMaxAllowedPacket()*/std::to_string(MAX_PACKET_LENGTH)
+                +std::to_string(maxAllowedPacket)
                 +")"
                 +getTraces(),
                 UNDEFINED_SQLSTATE.getSqlState(), 0,
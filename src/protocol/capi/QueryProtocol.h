@@ -22,7 +22,9 @@
 #define _ABSTRACTQUERYPROTOCOL_H_
 
 #include <istream>
+#include <functional>
 #include <vector>
+#include <atomic>
 
 #include "Consts.h"
 
@@ -51,10 +53,18 @@ namespace capi
     int32_t transactionIsolationLevel; /*0*/
     std::unique_ptr<std::istream> localInfileInputStream;
     int64_t maxRows;
-    /*volatile*/
-    MYSQL_STMT* statementIdToRelease; /*-1*/
+    /* Statements, that could not be deallocated while the connection was used. Closed on the next prepare */
+    std::vector<MYSQL_STMT*> statementIdToRelease;
+    std::mutex statementIdToReleaseLock;
     FutureTask* activeFutureTask;
-    bool interrupted;
+    /* Set by the query timeout timer, thus from other thread */
+    std::atomic<bool> interrupted;
+    /* Buffer for queries of rewritten batches, reused by all batches of the connection */
+    SQLString rewriteBuffer;
+    /* Bigger buffer is freed after the batch */
+    static const std::size_t MAX_KEPT_REWRITE_BUFFER= 1024*1024;
+
+    void releaseRewriteBuffer();
 
   protected:
     QueryProtocol(std::shared_ptr<UrlParser>& urlParser, GlobalStateInfo* globalInfo, Shared::mutex& lock);
@@ -104,6 +114,10 @@ namespace capi
       Shared::Results& results,
       ClientPrepareResult* clientPrepareResult,
       std::vector<std::vector<Shared::ParameterHolder>>& parametersList);
+    void executeBatchPipeline(
+      Shared::Results& results,
+      std::size_t queryCount,
+      const std::function<void(SQLString&, std::size_t)>& assembleQuery);
 
   public:
     void executeBatchStmt(bool mustExecuteOnMaster, Shared::Results& results, const std::vector<SQLString>& queries);
@@ -132,6 +146,12 @@ namespace capi
       std::vector<std::vector<Shared::ParameterHolder>>& parametersList,
       bool hasLongData);
 
+    bool executeBulkArrays(
+      ServerPrepareResult* serverPrepareResult,
+      Shared::Results& results,
+      const std::vector<ParameterArray>& parameterArrays,
+      std::size_t rowCount);
+
     void executePreparedQuery(
       bool mustExecuteOnMaster,
       ServerPrepareResult* serverPrepareResult,
@@ -139,15 +159,18 @@ namespace capi
       std::vector<Shared::ParameterHolder>& parameters);
     void rollback();
     bool forceReleasePrepareStatement(capi::MYSQL_STMT* statementId);
+    void deferReleasePrepareStatement(capi::MYSQL_STMT* statementId);
     void forceReleaseWaitingPrepareStatement();
     bool ping();
     bool isValid(int32_t timeout);
+    bool isClosedByServer();
     SQLString getCatalog();
     void setCatalog(const SQLString& database);
     void resetDatabase();
     void cancelCurrentQuery();
     bool getAutocommit();
     bool inTransaction();
+    void close();
     void closeExplicit();
     void releasePrepareStatement(ServerPrepareResult* serverPrepareResult);
     int64_t getMaxRows();
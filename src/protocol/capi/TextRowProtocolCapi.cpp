@@ -19,6 +19,9 @@
 
 
 #include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 #include "TextRowProtocolCapi.h"
 
@@ -32,6 +35,91 @@ namespace mariadb
 {
 namespace capi
 {
+  /**
+   * Parses count decimal digits.
+   *
+   * @param str string to parse
+   * @param count number of digits to parse
+   * @param value [out] parsed value
+   * @return false if any of characters is not a digit
+   */
+  static bool parseDigits(const char* str, std::size_t count, int32_t& value)
+  {
+    uint32_t digits= 0, result= 0;
+
+    for (std::size_t i= 0; i < count; ++i) {
+      uint32_t digit= static_cast<uint8_t>(str[i]) - '0';
+      // Any non-digit makes it >9 due to unsigned wraparound
+      digits|= (digit > 9);
+      result= result*10 + digit;
+    }
+    value= static_cast<int32_t>(result);
+    return digits == 0;
+  }
+
+  /**
+   * Checks if the string starts with the time in [-]HH[H]:MM:SS[.f...] format.
+   *
+   * @param str string to check
+   * @param len string length
+   * @return length of the time part, or 0 if string does not start with the time
+   */
+  static std::size_t timeLength(const char* str, std::size_t len)
+  {
+    std::size_t offset= (len > 0 && str[0] == '-') ? 1 : 0;
+    std::size_t hourDigits= 2;
+    int32_t dummy;
+
+    if (len > offset + 2 && str[offset + 2] != ':') {
+      hourDigits= 3;
+    }
+    if (len < offset + hourDigits + 6
+      || !parseDigits(str + offset, hourDigits, dummy)
+      || str[offset + hourDigits] != ':'
+      || !parseDigits(str + offset + hourDigits + 1, 2, dummy)
+      || str[offset + hourDigits + 3] != ':'
+      || !parseDigits(str + offset + hourDigits + 4, 2, dummy)) {
+      return 0;
+    }
+    offset+= hourDigits + 6;
+
+    if (offset + 1 < len && str[offset] == '.' && parseDigits(str + offset + 1, 1, dummy)) {
+      ++offset;
+      while (offset < len && parseDigits(str + offset, 1, dummy)) {
+        ++offset;
+      }
+    }
+    return offset;
+  }
+
+  /**
+   * Checks if the string is the date in [-]YYYY-MM-DD format, optionally followed by the time.
+   *
+   * @param str string to check
+   * @param len string length
+   * @return length of the date part, or 0 if string is not a date
+   */
+  static std::size_t dateLength(const char* str, std::size_t len)
+  {
+    std::size_t offset= (len > 0 && str[0] == '-') ? 1 : 0;
+    int32_t dummy;
+
+    if (len < offset + 10
+      || !parseDigits(str + offset, 4, dummy)
+      || str[offset + 4] != '-'
+      || !parseDigits(str + offset + 5, 2, dummy)
+      || str[offset + 7] != '-'
+      || !parseDigits(str + offset + 8, 2, dummy)) {
+      return 0;
+    }
+    std::size_t dateLen= offset + 10;
+
+    if (len == dateLen
+      || (str[dateLen] == ' ' && timeLength(str + dateLen + 1, len - dateLen - 1) == len - dateLen - 1)) {
+      return dateLen;
+    }
+    return 0;
+  }
 
 /**
  * Constructor.
@@ -39,15 +127,79 @@ namespace capi
  * @param maxFieldSize max field size
  * @param options connection options
  */
-  TextRowProtocolCapi::TextRowProtocolCapi(int32_t maxFieldSize, Shared::Options options, MYSQL_RES* capiTextResults)
+  TextRowProtocolCapi::TextRowProtocolCapi(const std::vector<Shared::ColumnDefinition>& columnInformation, int32_t maxFieldSize,
+    Shared::Options options, MYSQL_RES* capiTextResults)
+    : TextRowProtocolCapi(columnInformation, maxFieldSize, options,
+        capiTextResults != nullptr ? std::shared_ptr<MYSQL_RES>(capiTextResults, &mysql_free_result) : std::shared_ptr<MYSQL_RES>())
+ {
+ }
+
+  /**
+    * Constructor of the decoder, that shares the result with other decoders. Each decoder keeps its own current row,
+    * thus they may be used in different threads, as long as they do not fetch at the same time.
+    *
+    * @param columnInformation column information
+    * @param maxFieldSize max field size
+    * @param options connection options
+    * @param capiTextResults shared result
+    */
+  TextRowProtocolCapi::TextRowProtocolCapi(const std::vector<Shared::ColumnDefinition>& columnInformation, int32_t maxFieldSize,
+    Shared::Options options, const std::shared_ptr<MYSQL_RES>& capiTextResults)
     : RowProtocol(maxFieldSize, options)
-    , capiResults(capiTextResults, &mysql_free_result)
+    , capiResults(capiTextResults)
     , rowData(nullptr)
     , lengthArr(nullptr)
  {
-    if (capiTextResults != nullptr) {
-      fieldBuf= txtFieldBuf;
-    }
+   initConverters(columnInformation);
+ }
+
+ /**
+  * Select converters for each column. Integer and floating point types get converters parsing the text value in place,
+  * other types use generic getters.
+  *
+  * @param columnInformation column information
+  */
+ void TextRowProtocolCapi::initConverters(const std::vector<Shared::ColumnDefinition>& columnInformation)
+ {
+   converters.reserve(columnInformation.size());
+
+   for (auto& columnInfo : columnInformation) {
+     ColumnConverters<TextRowProtocolCapi> columnConverters= {
+       &TextRowProtocolCapi::getIntGeneric,
+       &TextRowProtocolCapi::getLongGeneric,
+       &TextRowProtocolCapi::getDoubleGeneric };
+
+     switch (columnInfo->getColumnType().getType()) {
+     case MYSQL_TYPE_LONG:
+       if (!columnInfo->isSigned()) {
+         // getInt needs range check
+         columnConverters.getLong= &TextRowProtocolCapi::getLongFromText;
+         columnConverters.getDouble= &TextRowProtocolCapi::getDoubleFromText;
+         break;
+       }
+       /* fall through */
+     case MYSQL_TYPE_TINY:
+     case MYSQL_TYPE_SHORT:
+     case MYSQL_TYPE_YEAR:
+     case MYSQL_TYPE_INT24:
+       columnConverters= { &TextRowProtocolCapi::getIntFromText, &TextRowProtocolCapi::getLongFromText,
+         &TextRowProtocolCapi::getDoubleFromText };
+       break;
+     case MYSQL_TYPE_LONGLONG:
+       columnConverters.getLong= &TextRowProtocolCapi::getLongFromText;
+       columnConverters.getDouble= &TextRowProtocolCapi::getDoubleFromText;
+       break;
+     case MYSQL_TYPE_FLOAT:
+     case MYSQL_TYPE_DOUBLE:
+     case MYSQL_TYPE_DECIMAL:
+     case MYSQL_TYPE_NEWDECIMAL:
+       columnConverters.getDouble= &TextRowProtocolCapi::getDoubleFromText;
+       break;
+     default:
+       break;
+     }
+     converters.push_back(columnConverters);
+   }
  }
 
  /**
@@ -61,17 +213,18 @@ namespace capi
 
    pos= 0;
 
-   if (rowData) {
-     this->lastValueNull= (rowData[index] == nullptr ? BIT_LAST_FIELD_NULL : BIT_LAST_FIELD_NOT_NULL);
-     length= lengthArr[newIndex];
-     fieldBuf.wrap(rowData[index], length);
-   }
-   else if (buf != nullptr)
+   // Stored rows take precedence - streamed rows are stored, while rowData is the last row read from the server
+   if (buf != nullptr)
    {
+     fieldBuf.wrap(buf[index].arr, buf[index].size());
      this->lastValueNull= fieldBuf ? BIT_LAST_FIELD_NOT_NULL : BIT_LAST_FIELD_NULL;
-     fieldBuf= (*buf)[index];
      length= static_cast<uint32_t>(fieldBuf.size());
    }
+   else if (rowData) {
+     this->lastValueNull= (rowData[index] == nullptr ? BIT_LAST_FIELD_NULL : BIT_LAST_FIELD_NOT_NULL);
+     length= lengthArr[newIndex];
+     fieldBuf.wrap(rowData[index], length);
+   }
    else {
      // TODO: we need some good assert above instead of this
      throw std::runtime_error("Internal error in the TextRow class - data buffers are NULLs");
@@ -161,6 +314,41 @@ namespace capi
  }
 
 
+ /**
+  * Get String value pointer and length from raw text format. Values, which text form needs no conversion,
+  * are returned without copying.
+  *
+  * @param columnInfo column information
+  * @param len [out] value length
+  * @return pointer to the value or NULL if the value is NULL
+  */
+ const char* TextRowProtocolCapi::getInternalStringView(ColumnDefinition* columnInfo, std::size_t& len)
+ {
+   if (lastValueWasNull()) {
+     len= 0;
+     return nullptr;
+   }
+
+   switch (columnInfo->getColumnType().getType()) {
+   case MYSQL_TYPE_BIT:
+   case MYSQL_TYPE_DOUBLE:
+   case MYSQL_TYPE_FLOAT:
+   case MYSQL_TYPE_TIME:
+   case MYSQL_TYPE_DATE:
+   case MYSQL_TYPE_YEAR:
+   case MYSQL_TYPE_TIMESTAMP:
+   case MYSQL_TYPE_DATETIME:
+   case MYSQL_TYPE_NEWDECIMAL:
+   case MYSQL_TYPE_DECIMAL:
+   case MYSQL_TYPE_NULL:
+     return RowProtocol::getInternalStringView(columnInfo, len);
+   default:
+     len= getLengthMaxFieldSize();
+     return fieldBuf.arr + pos;
+   }
+ }
+
+
  Date TextRowProtocolCapi::getInternalDate(ColumnDefinition* columnInfo, Calendar* cal, TimeZone* timeZone)
  {
    if (lastValueWasNull()) {
@@ -170,7 +358,7 @@ namespace capi
    switch (columnInfo->getColumnType().getType()) {
    case MYSQL_TYPE_DATE:
    {
-     std::vector<int32_t> datePart{ 0, 0, 0 };
+     int32_t datePart[]= { 0, 0, 0 };
      int32_t partIdx= 0;
      for (uint32_t begin= pos; begin < pos + length; begin++) {
        int8_t b= fieldBuf[begin];
@@ -178,7 +366,7 @@ namespace capi
          partIdx++;
          continue;
        }
-       if (b <'0'|| b >'9') {
+       if (b <'0'|| b >'9' || partIdx > 2) {
          throw SQLException(
            "cannot parse data in date string '"
            + SQLString(fieldBuf, length)
@@ -224,10 +412,10 @@ namespace capi
    }
    default:
    {
-     std::string str(fieldBuf.arr + pos, length);
-     if (std::regex_match(str, dateRegex))
+     std::size_t dateLen= dateLength(fieldBuf.arr + pos, length);
+     if (dateLen > 0)
      {
-       return str.substr(0, 10 + (str.at(0) == '-' ? 1 : 0));
+       return Date(fieldBuf.arr + pos, dateLen);
      }
      else {
        throw SQLException("Could not get object as Date", "S1009");
@@ -268,31 +456,12 @@ namespace capi
 
    }
    else {
-     std::string raw(fieldBuf.arr + pos, length);
-     std::smatch matcher;
-
-     if (!std::regex_search(raw, matcher, timeRegex)) {
-       throw SQLException("Time format \""+raw +"\" incorrect, must be HH:mm:ss");
-     }
-     bool negate= !matcher[1].str().empty();
-
-     int32_t hour= std::stoi(matcher[2]);
-     int32_t minutes= std::stoi(matcher[3]);
-     int32_t seconds= std::stoi(matcher[4]);
-     std::string parts(matcher[5].str());
-     int32_t nanoseconds= 0;
+     std::size_t timeLen= timeLength(fieldBuf.arr + pos, length);
 
-     if (parts.length() > 1)
-     {
-       size_t digitsCnt= parts.length() - 1;
-       nanoseconds= std::stoi(parts.substr(1, std::min(digitsCnt, (size_t)9U)));
-
-       while (digitsCnt++ < 9) {
-         nanoseconds*= 10;
-       }
+     if (timeLen == 0) {
+       throw SQLException("Time format \"" + SQLString(fieldBuf.arr + pos, length) + "\" incorrect, must be HH:mm:ss");
      }
-
-     return std::unique_ptr<Time>(new Time(matcher[0].str()));
+     return std::unique_ptr<Time>(new Time(fieldBuf.arr + pos, timeLen));
    }
  }
 
@@ -321,10 +490,34 @@ namespace capi
    case MYSQL_TYPE_STRING:
    {
      int32_t nanoBegin= -1;
-     std::vector<int32_t> timestampsPart{ 0,0,0,0,0,0,0 };
+     int32_t timestampsPart[]= { 0,0,0,0,0,0,0 };
      int32_t partIdx= 0;
-
-     for (uint32_t begin= pos; begin <pos +length; begin++) {
+     const char* str= fieldBuf.arr + pos;
+
+     // Fast path for the fixed YYYY-MM-DD HH:MM:SS format, that server sends
+     if (length >= 19 && str[4] == '-' && str[7] == '-' && str[10] == ' ' && str[13] == ':' && str[16] == ':'
+       && parseDigits(str, 4, timestampsPart[0]) && parseDigits(str + 5, 2, timestampsPart[1])
+       && parseDigits(str + 8, 2, timestampsPart[2]) && parseDigits(str + 11, 2, timestampsPart[3])
+       && parseDigits(str + 14, 2, timestampsPart[4]) && parseDigits(str + 17, 2, timestampsPart[5])) {
+       partIdx= 5;
+       if (length > 19 && str[19] == '.') {
+         partIdx= 6;
+         nanoBegin= pos + 19;
+         if (length - 20 > 6 || !parseDigits(str + 20, length - 20, timestampsPart[6])) {
+           throw SQLException(
+             "cannot parse data in timestamp string '"
+             + SQLString(fieldBuf.arr + pos, length)
+             +"'");
+         }
+       }
+       else if (length > 19) {
+         throw SQLException(
+           "cannot parse data in timestamp string '"
+           + SQLString(fieldBuf.arr + pos, length)
+           +"'");
+       }
+     }
+     else for (uint32_t begin= pos; begin <pos +length; begin++) {
        int8_t b= fieldBuf[begin];
        if (b == '-'||b == ' '||b == ':') {
          partIdx++;
@@ -335,7 +528,7 @@ namespace capi
          nanoBegin= begin;
          continue;
        }
-       if (b <'0' || b >'9') {
+       if (b <'0' || b >'9' || partIdx > 6) {
          throw SQLException(
            "cannot parse data in timestamp string '"
            + SQLString(fieldBuf.arr + pos, length)
@@ -363,21 +556,16 @@ namespace capi
        }
      }
 
-     std::ostringstream timestamp;
-     std::string nanosStr(std::to_string(timestampsPart[6]));
+     // Max is 11 digits of year, 5x(separator + 2 digits), point, 9 digits of nanos and terminating null
+     char timestamp[40];
+     int32_t tsLen= std::snprintf(timestamp, sizeof(timestamp), "%d-%02d-%02d %02d:%02d:%02d",
+       timestampsPart[0], timestampsPart[1], timestampsPart[2], timestampsPart[3], timestampsPart[4], timestampsPart[5]);
 
-     timestamp << timestampsPart[0] << "-";
-     timestamp << (timestampsPart[1] < 10 ? "0" : "") << timestampsPart[1] << "-";
-     timestamp << (timestampsPart[2] < 10 ? "0" : "") << timestampsPart[2] << " ";
-     timestamp << (timestampsPart[3] < 10 ? "0" : "") << timestampsPart[3] << ":";
-     timestamp << (timestampsPart[4] < 10 ? "0" : "") << timestampsPart[4] << ":";
-     timestamp << (timestampsPart[5] < 10 ? "0" : "") << timestampsPart[5];
-     
      if (timestampsPart[6] > 0) {
-       timestamp << "." << (nanosStr.length() < 9 ? std::string(9 - nanosStr.length(), '0') : "") << nanosStr;
+       tsLen+= std::snprintf(timestamp + tsLen, sizeof(timestamp) - tsLen, ".%09d", timestampsPart[6]);
      }
 
-     return std::unique_ptr<Timestamp>(new Timestamp(timestamp.str()));
+     return std::unique_ptr<Timestamp>(new Timestamp(timestamp, tsLen));
    }
    case MYSQL_TYPE_TIME:
    {
@@ -711,20 +899,132 @@ namespace capi
    if (lastValueWasNull()) {
      return 0;
    }
-   int64_t value= getInternalLong(columnInfo);
+   return (this->*converters[index].getInt)(columnInfo);
+ }
+
+ /**
+  * Get long from raw text format.
+  *
+  * @param columnInfo column information
+  * @return long value
+  * @throws SQLException if column type doesn't permit conversion or not in Long range (unsigned)
+  */
+ int64_t TextRowProtocolCapi::getInternalLong(ColumnDefinition* columnInfo)
+ {
+   if (lastValueWasNull()) {
+     return 0;
+   }
+   return (this->*converters[index].getLong)(columnInfo);
+ }
+
+ /**
+  * Get double from raw text format.
+  *
+  * @param columnInfo column information
+  * @return double value
+  * @throws SQLException if column type doesn't permit conversion or not in Double range (unsigned)
+  */
+ long double TextRowProtocolCapi::getInternalDouble(ColumnDefinition* columnInfo)
+ {
+   if (lastValueWasNull()) {
+     return 0;
+   }
+   return (this->*converters[index].getDouble)(columnInfo);
+ }
+
+ /**
+  * Get int from integer column, which values are always in Integer range. The value is not NULL.
+  *
+  * @param columnInfo column information
+  * @return int value
+  */
+ int32_t TextRowProtocolCapi::getIntFromText(ColumnDefinition* columnInfo)
+ {
+   return static_cast<int32_t>(getLongFromText(columnInfo));
+ }
+
+ /**
+  * Get long from integer column, parsing the text value in place. Values, that may be out of Long range, are left
+  * to the generic getter. The value is not NULL.
+  *
+  * @param columnInfo column information
+  * @return long value
+  */
+ int64_t TextRowProtocolCapi::getLongFromText(ColumnDefinition* columnInfo)
+ {
+   const char* current= fieldBuf.arr + pos, *end= current + length;
+   bool negative= (current < end && *current == '-');
+
+   if (negative) {
+     ++current;
+   }
+   // 18 digits always fit int64_t
+   if (current == end || end - current > 18) {
+     return getLongGeneric(columnInfo);
+   }
+
+   int64_t value= 0;
+   while (current < end) {
+     if (*current < '0' || *current > '9') {
+       return getLongGeneric(columnInfo);
+     }
+     value= value*10 + (*current - '0');
+     ++current;
+   }
+   return negative ? -value : value;
+ }
+
+ /**
+  * Get double from numeric column, parsing the text value without allocations. The value is not NULL.
+  *
+  * @param columnInfo column information
+  * @return double value
+  */
+ long double TextRowProtocolCapi::getDoubleFromText(ColumnDefinition* columnInfo)
+ {
+   char value[64];
+
+   if (length >= sizeof(value)) {
+     return getDoubleGeneric(columnInfo);
+   }
+   std::memcpy(value, fieldBuf.arr + pos, length);
+   value[length]= '\0';
+
+   char* end;
+   long double result= std::strtold(value, &end);
+
+   if (end == value) {
+     return getDoubleGeneric(columnInfo);
+   }
+   return result;
+ }
+
+ /**
+  * Get int from raw text format for any type.
+  *
+  * @param columnInfo column information
+  * @return int value
+  * @throws SQLException if column type doesn't permit conversion or not in Integer range
+  */
+ int32_t TextRowProtocolCapi::getIntGeneric(ColumnDefinition* columnInfo)
+ {
+   if (lastValueWasNull()) {
+     return 0;
+   }
+   int64_t value= getLongGeneric(columnInfo);
    rangeCheck("int32_t", INT32_MIN, INT32_MAX, value, columnInfo);
 
    return static_cast<int32_t>(value);
  }
 
  /**
-  * Get long from raw text format.
+  * Get long from raw text format for any type.
   *
   * @param columnInfo column information
   * @return long value
   * @throws SQLException if column type doesn't permit conversion or not in Long range (unsigned)
   */
- int64_t TextRowProtocolCapi::getInternalLong(ColumnDefinition* columnInfo)
+ int64_t TextRowProtocolCapi::getLongGeneric(ColumnDefinition* columnInfo)
  {
    if (lastValueWasNull()) {
      return 0;
@@ -899,13 +1199,13 @@ namespace capi
  }
 
  /**
-  * Get double from raw text format.
+  * Get double from raw text format for any type.
   *
   * @param columnInfo column information
   * @return double value
   * @throws SQLException if column type doesn't permit conversion or not in Double range (unsigned)
   */
- long double TextRowProtocolCapi::getInternalDouble(ColumnDefinition* columnInfo)
+ long double TextRowProtocolCapi::getDoubleGeneric(ColumnDefinition* columnInfo)
  {
    if (lastValueWasNull()) {
      return 0;
@@ -1052,6 +1352,20 @@ namespace capi
  }
 
 
+ /**
+  * Get raw value of the column of the last fetched row.
+  *
+  * @param columnIndex index of the column (0 is first)
+  * @param len [out] value length
+  * @return pointer to the value or NULL if the value is NULL
+  */
+ const char* TextRowProtocolCapi::getRawValue(int32_t columnIndex, std::size_t& len)
+ {
+   len= lengthArr[columnIndex];
+   return rowData[columnIndex];
+ }
+
+
  void TextRowProtocolCapi::installCursorAtPosition(int32_t rowPtr)
  {
    mysql_data_seek(capiResults.get(), static_cast<unsigned long long>(rowPtr)  + 1);
@@ -1059,6 +1373,79 @@ namespace capi
 
  }
 
+ /**
+  * Append current row values to the columnar batch, parsing integer and floating point columns
+  * directly from the row data, and copying character and binary columns to the batch arena.
+  *
+  * @param batch batch to fill
+  * @param rowIndex index of the row in the batch
+  * @param columnInformation column information
+  */
+ void TextRowProtocolCapi::appendToBatch(ColumnBatch& batch, std::size_t rowIndex, const std::vector<Shared::ColumnDefinition>& columnInformation)
+ {
+   // Row constructed from data or stored by the result set, not fetched from the server
+   if (rowData == nullptr || buf != nullptr) {
+     RowProtocol::appendToBatch(batch, rowIndex, columnInformation);
+     return;
+   }
+
+   for (std::size_t i= 0; i < batch.columns.size(); ++i) {
+     ColumnBatch::Column& column= batch.columns[i];
+     const char* value= rowData[i];
+
+     if (value == nullptr) {
+       appendNullToBatch(column, rowIndex);
+       continue;
+     }
+     ColumnDefinition* columnInfo= columnInformation[i].get();
+     int32_t type= columnInfo->getColumnType().getType();
+
+     switch (column.kind) {
+     case ColumnBatch::INT64:
+       if (type == MYSQL_TYPE_BIT) {
+         setPosition(static_cast<int32_t>(i));
+         column.longs.push_back(parseBit());
+       }
+       else if (column.isUnsigned) {
+         column.longs.push_back(static_cast<int64_t>(std::strtoull(value, nullptr, 10)));
+       }
+       else {
+         column.longs.push_back(std::strtoll(value, nullptr, 10));
+       }
+       break;
+     case ColumnBatch::DOUBLE:
+       column.doubles.push_back(std::strtod(value, nullptr));
+       break;
+     default:
+       switch (type) {
+       case MYSQL_TYPE_STRING:
+       case MYSQL_TYPE_VAR_STRING:
+       case MYSQL_TYPE_VARCHAR:
+       case MYSQL_TYPE_TINY_BLOB:
+       case MYSQL_TYPE_MEDIUM_BLOB:
+       case MYSQL_TYPE_LONG_BLOB:
+       case MYSQL_TYPE_BLOB:
+       case MYSQL_TYPE_JSON:
+       case MYSQL_TYPE_ENUM:
+       case MYSQL_TYPE_SET:
+       case MYSQL_TYPE_GEOMETRY:
+       {
+         std::size_t len= lengthArr[i];
+         if (maxFieldSize != 0 && maxFieldSize < len) {
+           len= maxFieldSize;
+         }
+         appendStringToBatch(column, value, len);
+         break;
+       }
+       default:
+         setPosition(static_cast<int32_t>(i));
+         appendValueToBatch(column, rowIndex, columnInfo);
+       }
+     }
+   }
+ }
+
+
 #ifdef JDBC_SPECIFIC_TYPES_IMPLEMENTED
  /**
  * Get BigInteger format from raw text format.
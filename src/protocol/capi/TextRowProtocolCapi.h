@@ -35,13 +35,26 @@ namespace capi
 
 class TextRowProtocolCapi  : public RowProtocol {
 
-  std::unique_ptr<MYSQL_RES, decltype(&mysql_free_result)> capiResults;
+  /* Shared by the decoders of the same result */
+  std::shared_ptr<MYSQL_RES> capiResults;
   MYSQL_ROW  rowData;
   unsigned long* lengthArr;
-  sql::bytes txtFieldBuf;
+  std::vector<ColumnConverters<TextRowProtocolCapi>> converters;
+
+  void initConverters(const std::vector<Shared::ColumnDefinition>& columnInformation);
+
+  int32_t getIntGeneric(ColumnDefinition* columnInfo);
+  int64_t getLongGeneric(ColumnDefinition* columnInfo);
+  long double getDoubleGeneric(ColumnDefinition* columnInfo);
+  int32_t getIntFromText(ColumnDefinition* columnInfo);
+  int64_t getLongFromText(ColumnDefinition* columnInfo);
+  long double getDoubleFromText(ColumnDefinition* columnInfo);
 
 public:
-  TextRowProtocolCapi(int32_t maxFieldSize, Shared::Options options, MYSQL_RES* capiTextResults);
+  TextRowProtocolCapi(const std::vector<Shared::ColumnDefinition>& columnInformation, int32_t maxFieldSize, Shared::Options options,
+    MYSQL_RES* capiTextResults);
+  TextRowProtocolCapi(const std::vector<Shared::ColumnDefinition>& columnInformation, int32_t maxFieldSize, Shared::Options options,
+    const std::shared_ptr<MYSQL_RES>& capiTextResults);
   ~TextRowProtocolCapi() {}
 
   void setPosition(int32_t newIndex);
@@ -55,12 +68,14 @@ public:
   BigInteger getInternalBigInteger(ColumnDefinition* columnInfo);
 #endif
   int32_t fetchNext();
+  const char* getRawValue(int32_t columnIndex, std::size_t& len);
   void installCursorAtPosition(int32_t rowPtr);
 
   Date getInternalDate(ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr);
   std::unique_ptr<Time> getInternalTime(ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr);
   std::unique_ptr<Timestamp> getInternalTimestamp( ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr);
   std::unique_ptr<SQLString> getInternalString(ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr);
+  const char* getInternalStringView(ColumnDefinition* columnInfo, std::size_t& len);
   int32_t getInternalInt(ColumnDefinition* columnInfo);
   int64_t getInternalLong(ColumnDefinition* columnInfo);
   uint64_t getInternalULong(ColumnDefinition* columnInfo);
@@ -74,6 +89,7 @@ public:
   SQLString getInternalTimeString(ColumnDefinition* columnInfo);
 
   bool isBinaryEncoded();
+  void appendToBatch(ColumnBatch& batch, std::size_t rowIndex, const std::vector<Shared::ColumnDefinition>& columnInformation);
   };
 
 }
@@ -19,6 +19,7 @@
 
 
 #include "ClientPrepareResult.h"
+#include "SqlClassification.h"
 
 namespace sql
 {
@@ -154,7 +155,7 @@ namespace mariadb
       case '?':
         if (state == LexState::Normal) {
           partList.push_back(
-            queryString.substr(lastParameterPosition, i)/*.getBytes(StandardCharsets.UTF_8)*/);
+            queryString.substr(lastParameterPosition, i - lastParameterPosition)/*.getBytes(StandardCharsets.UTF_8)*/);
           lastParameterPosition= i +1;
         }
         break;
@@ -363,8 +364,7 @@ namespace mariadb
 
     int32_t isInParenthesis= 0;
     bool skipChar= false;
-    bool isFirstChar= true;
-    bool isInsert= false;
+    bool isInsert= SqlClassification(queryString, noBackslashEscapes).getType() == SqlClassification::STMT_INSERT;
     bool semicolon= false;
     bool hasParam= false;
 
@@ -575,13 +575,6 @@ namespace mariadb
         }
         break;
       default:
-        if (state == LexState::Normal &&isFirstChar &&((int8_t)car >=40)) {
-          if (car == 'I'||car == 'i') {
-            isInsert= true;
-          }
-          isFirstChar= false;
-        }
-
         if (state == LexState::Normal &&semicolon &&((int8_t)car >=40)) {
           reWritablePrepare= false;
           multipleQueriesPrepare= true;
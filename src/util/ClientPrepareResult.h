@@ -44,7 +44,8 @@ class ClientPrepareResult : public PrepareResult
   Backtick
   };
 
-  const SQLString& sql;
+  /* Results are shared by statements via ClientPrepareResultCache, thus query has to be a copy */
+  const SQLString sql;
   const std::vector<SQLString> queryParts;
   bool rewriteType;
   uint32_t paramCount;
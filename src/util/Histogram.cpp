@@ -0,0 +1,146 @@
+/************************************************************************************
+   Copyright (C) 2020 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include "Histogram.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  const uint32_t Histogram::SUB_BUCKET_BITS;
+  const uint32_t Histogram::SUB_BUCKETS;
+  const uint32_t Histogram::BUCKETS;
+
+  Histogram::Histogram()
+  {
+    reset();
+  }
+
+  /**
+    * Values below 2*SUB_BUCKETS have own buckets. For bigger values, the position of the most significant bit
+    * selects the group of SUB_BUCKETS buckets, and SUB_BUCKET_BITS bits following it select the bucket in the group.
+    */
+  uint32_t Histogram::bucketIndex(uint64_t value)
+  {
+    if (value < 2*SUB_BUCKETS) {
+      return static_cast<uint32_t>(value);
+    }
+
+    uint32_t msb= 0;
+    for (uint32_t shift= 32; shift > 0; shift>>= 1) {
+      if ((value >> (msb + shift)) != 0) {
+        msb+= shift;
+      }
+    }
+    const uint32_t shift= msb - SUB_BUCKET_BITS;
+
+    return (shift + 1)*SUB_BUCKETS + static_cast<uint32_t>((value >> shift) - SUB_BUCKETS);
+  }
+
+
+  uint64_t Histogram::highestValueInBucket(uint32_t index)
+  {
+    if (index < 2*SUB_BUCKETS) {
+      return index;
+    }
+    const uint32_t shift= index/SUB_BUCKETS - 1;
+    const uint64_t subBucket= index % SUB_BUCKETS + SUB_BUCKETS;
+
+    return ((subBucket + 1) << shift) - 1;
+  }
+
+
+  void Histogram::record(uint64_t value)
+  {
+    counts[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    totalCount.fetch_add(1, std::memory_order_relaxed);
+    totalSum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t currentMax= maxValue.load(std::memory_order_relaxed);
+    while (value > currentMax && !maxValue.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {
+    }
+  }
+
+
+  uint64_t Histogram::getCount() const
+  {
+    return totalCount.load(std::memory_order_relaxed);
+  }
+
+
+  uint64_t Histogram::getMax() const
+  {
+    return maxValue.load(std::memory_order_relaxed);
+  }
+
+
+  uint64_t Histogram::getMean() const
+  {
+    uint64_t count= getCount();
+    return count > 0 ? totalSum.load(std::memory_order_relaxed)/count : 0;
+  }
+
+  /**
+    * Value, that given percent of recorded values do not exceed. Within precision of the histogram, and never
+    * exceeding the maximum recorded value.
+    *
+    * @param percentile percentile, 0 to 100
+    * @return value at the percentile, or 0 if nothing has been recorded
+    */
+  uint64_t Histogram::getValueAtPercentile(double percentile) const
+  {
+    uint64_t count= getCount();
+    if (count == 0) {
+      return 0;
+    }
+    if (percentile > 100.0) {
+      percentile= 100.0;
+    }
+
+    uint64_t target= static_cast<uint64_t>(percentile/100.0*static_cast<double>(count) + 0.5);
+    if (target == 0) {
+      target= 1;
+    }
+
+    uint64_t seen= 0;
+    for (uint32_t i= 0; i < BUCKETS; ++i) {
+      seen+= counts[i].load(std::memory_order_relaxed);
+      if (seen >= target) {
+        uint64_t value= highestValueInBucket(i);
+        uint64_t currentMax= getMax();
+        return value < currentMax ? value : currentMax;
+      }
+    }
+    return getMax();
+  }
+
+
+  void Histogram::reset()
+  {
+    for (auto& count : counts) {
+      count.store(0, std::memory_order_relaxed);
+    }
+    totalCount.store(0);
+    totalSum.store(0);
+    maxValue.store(0);
+  }
+}
+}
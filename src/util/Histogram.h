@@ -0,0 +1,69 @@
+/************************************************************************************
+   Copyright (C) 2020 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#ifndef _HISTOGRAM_H_
+#define _HISTOGRAM_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace sql
+{
+namespace mariadb
+{
+
+/**
+  * Histogram of non-negative integer values in the manner of HdrHistogram. Values are counted in log-linear
+  * buckets: values below 2*SUB_BUCKETS exactly, bigger ones with the relative error below 1/SUB_BUCKETS. Recording
+  * is lock-free, and does not allocate, so it can be done by any number of threads at the same time. Readings,
+  * that are taken while values are recorded, are not exact snapshot, but are still good for monitoring.
+  */
+class Histogram final
+{
+  static const uint32_t SUB_BUCKET_BITS= 5;
+  static const uint32_t SUB_BUCKETS= 1 << SUB_BUCKET_BITS;
+  static const uint32_t BUCKETS= (64 - SUB_BUCKET_BITS + 1)*SUB_BUCKETS;
+
+  std::atomic<uint64_t> counts[BUCKETS];
+  std::atomic<uint64_t> totalCount;
+  std::atomic<uint64_t> totalSum;
+  std::atomic<uint64_t> maxValue;
+
+  Histogram(const Histogram&)= delete;
+  Histogram& operator=(const Histogram&)= delete;
+
+  static uint32_t bucketIndex(uint64_t value);
+  static uint64_t highestValueInBucket(uint32_t index);
+
+public:
+  Histogram();
+
+  void record(uint64_t value);
+  uint64_t getCount() const;
+  uint64_t getMax() const;
+  uint64_t getMean() const;
+  uint64_t getValueAtPercentile(double percentile) const;
+  void reset();
+};
+
+}
+}
+#endif
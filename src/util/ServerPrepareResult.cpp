@@ -22,7 +22,9 @@
 
 #include "ColumnType.h"
 #include "ColumnDefinition.h"
+#include "com/ColumnNameMap.h"
 #include "parameters/ParameterHolder.h"
+#include "parameters/ParameterArray.h"
 
 #include "com/capi/ColumnDefinitionCapi.h"
 
@@ -47,12 +49,15 @@ namespace mariadb
     std::vector<Shared::ColumnDefinition>& _parameters,
     Protocol* _unProxiedProtocol)
 
-    : sql(_sql)
-    , statementId(_statementId)
-    , columns(_columns)
+    : columns(_columns)
     , parameters(_parameters)
-    , unProxiedProtocol(_unProxiedProtocol)
+    , sql(_sql)
+    , inCache(false)
+    , statementId(_statementId)
     , metadata(mysql_stmt_result_metadata(statementId), &capi::mysql_free_result)
+    , unProxiedProtocol(_unProxiedProtocol)
+    , shareCounter(1)
+    , isBeingDeallocate(false)
   {
   }
 
@@ -70,9 +75,12 @@ namespace mariadb
     capi::MYSQL_STMT* _statementId,
     Protocol* _unProxiedProtocol)
     : sql(_sql)
+    , inCache(false)
     , statementId(_statementId)
-    , unProxiedProtocol(_unProxiedProtocol)
     , metadata(mysql_stmt_result_metadata(statementId), &capi::mysql_free_result)
+    , unProxiedProtocol(_unProxiedProtocol)
+    , shareCounter(1)
+    , isBeingDeallocate(false)
   {
     columns.reserve(mysql_stmt_field_count(statementId));
 
@@ -99,6 +107,9 @@ namespace mariadb
         columns[i].reset(new capi::ColumnDefinitionCapi(mysql_fetch_field_direct(metadata.get(), i)));
       }
     }
+    // Result sets, that are already created, keep the old index
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    columnNameMap.reset();
   }
 
 
@@ -203,6 +214,21 @@ namespace mariadb
     return columns;
   }
 
+  /**
+    * Get case-insensitive column label index for this statement's columns. The index is built once, and shared
+    * by all result sets of the statement.
+    *
+    * @return column name map
+    */
+  Shared::ColumnNameMap ServerPrepareResult::getColumnNameMap()
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    if (!columnNameMap) {
+      columnNameMap.reset(new ColumnNameMap(columns));
+    }
+    return columnNameMap;
+  }
+
   const std::vector<Shared::ColumnDefinition>& ServerPrepareResult::getParameters() const
   {
     return parameters;
@@ -275,18 +301,170 @@ namespace mariadb
   }
 
 
-  void ServerPrepareResult::bindParameters(std::vector<std::vector<Shared::ParameterHolder>>& paramValue)
+  /**
+    * Returns size of the value of the fixed length type, as Connector/C expects it in the array binding,
+    * or 0 if values of the type have to be passed as array of pointers.
+    */
+  std::size_t fixedLengthTypeSize(capi::enum_field_types type)
+  {
+    switch (type) {
+    case capi::MYSQL_TYPE_TINY:
+      return 1;
+    case capi::MYSQL_TYPE_SHORT:
+    case capi::MYSQL_TYPE_YEAR:
+      return 2;
+    case capi::MYSQL_TYPE_LONG:
+    case capi::MYSQL_TYPE_INT24:
+    case capi::MYSQL_TYPE_FLOAT:
+      return 4;
+    case capi::MYSQL_TYPE_LONGLONG:
+    case capi::MYSQL_TYPE_DOUBLE:
+      return 8;
+    default:
+      return 0;
+    }
+  }
+
+  /**
+    * Binds all rows of the batch for the array(bulk) execution. Column-wise binding is used - for each parameter
+    * values of all rows are put into one array, and NULLs are marked in the indicator array. Bind type is taken
+    * from the first row, where the parameter is not NULL. The caller has to make sure, that types of not NULL
+    * values do not change across rows, and set STMT_ATTR_ARRAY_SIZE.
+    *
+    * @param paramValue rows of parameters values
+    * @param offset index of the first row to bind
+    * @param rowCount number of rows to bind
+    */
+  void ServerPrepareResult::bindParameters(std::vector<std::vector<Shared::ParameterHolder>>& paramValue,
+    std::size_t offset, std::size_t rowCount)
+  {
+    if (rowCount == 0) {
+      return;
+    }
+
+    arrayData.resize(parameters.size());
+    arrayPtr.resize(parameters.size());
+    arrayLength.resize(parameters.size());
+    arrayIndicator.resize(parameters.size());
+
+    for (size_t i= 0; i < parameters.size(); ++i)
+    {
+      auto& bind= paramBind[i];
+      auto& indicator= arrayIndicator[i];
+      std::size_t typeRow= offset;
+
+      while (typeRow + 1 < offset + rowCount && paramValue[typeRow][i]->isNullData()) {
+        ++typeRow;
+      }
+      initBindStruct(bind, *paramValue[typeRow][i]);
+
+      indicator.assign(rowCount, STMT_INDICATOR_NONE);
+      bind.u.indicator= indicator.data();
+
+      const std::size_t valueSize= fixedLengthTypeSize(bind.buffer_type);
+
+      if (valueSize > 0) {
+        auto& data= arrayData[i];
+        data.resize(rowCount*valueSize);
+
+        for (std::size_t row= 0; row < rowCount; ++row) {
+          ParameterHolder* param= paramValue[offset + row][i].get();
+
+          if (param->isNullData()) {
+            indicator[row]= STMT_INDICATOR_NULL;
+            continue;
+          }
+          if (param->isUnsigned()) {
+            bind.is_unsigned= '\1';
+          }
+          std::memcpy(data.data() + row*valueSize, param->getValuePtr(), std::min<std::size_t>(valueSize, param->getValueBinLen()));
+        }
+        bind.buffer= data.data();
+        bind.buffer_length= static_cast<unsigned long>(valueSize);
+      }
+      else {
+        auto& ptr= arrayPtr[i];
+        auto& length= arrayLength[i];
+        ptr.assign(rowCount, nullptr);
+        length.assign(rowCount, 0);
+
+        for (std::size_t row= 0; row < rowCount; ++row) {
+          ParameterHolder* param= paramValue[offset + row][i].get();
+
+          if (param->isNullData()) {
+            indicator[row]= STMT_INDICATOR_NULL;
+            continue;
+          }
+          ptr[row]= param->getValuePtr();
+          length[row]= param->getValueBinLen();
+        }
+        bind.buffer= ptr.data();
+        bind.length= length.data();
+      }
+    }
+    capi::mysql_stmt_bind_param(statementId, paramBind.data());
+  }
+
+  /**
+    * Binds application's arrays of parameters values for the array(bulk) execution. Arrays of fixed length values
+    * are passed to Connector/C as is, for strings arrays of pointers and lengths are built. The caller has to set
+    * STMT_ATTR_ARRAY_SIZE.
+    *
+    * @param parameterArrays values of each parameter for all rows
+    * @param offset index of the first row to bind
+    * @param rowCount number of rows to bind
+    */
+  void ServerPrepareResult::bindParameters(const std::vector<ParameterArray>& parameterArrays, std::size_t offset,
+    std::size_t rowCount)
   {
-    for (auto& paramRow : paramValue)
+    arrayPtr.resize(parameters.size());
+    arrayLength.resize(parameters.size());
+    arrayIndicator.resize(parameters.size());
+
+    for (size_t i= 0; i < parameters.size(); ++i)
     {
-      uint32_t i= 0;
-      for (auto& bind : paramBind)
-      {
-        std::memset(&bind, 0, sizeof(capi::MYSQL_BIND));
-        initBindStruct(bind, *paramRow[i]);
-
-        bindParamValue(bind, paramRow[i]);
-        ++i;
+      auto& bind= paramBind[i];
+      auto& indicator= arrayIndicator[i];
+      const ParameterArray& parameterArray= parameterArrays[i];
+
+      std::memset(&bind, 0, sizeof(bind));
+      bind.buffer_type= static_cast<capi::enum_field_types>(parameterArray.columnType->getType());
+      bind.is_null= &bind.is_null_value;
+
+      indicator.assign(rowCount, STMT_INDICATOR_NONE);
+      bind.u.indicator= indicator.data();
+
+      const std::size_t valueSize= fixedLengthTypeSize(bind.buffer_type);
+
+      if (valueSize > 0) {
+        if (parameterArray.nulls != nullptr) {
+          for (std::size_t row= 0; row < rowCount; ++row) {
+            if (parameterArray.nulls[offset + row]) {
+              indicator[row]= STMT_INDICATOR_NULL;
+            }
+          }
+        }
+        bind.buffer= const_cast<int8_t*>(static_cast<const int8_t*>(parameterArray.values) + offset*valueSize);
+        bind.buffer_length= static_cast<unsigned long>(valueSize);
+      }
+      else {
+        const char* const* values= static_cast<const char* const*>(parameterArray.values) + offset;
+        const std::size_t* lengths= parameterArray.lengths + offset;
+        auto& ptr= arrayPtr[i];
+        auto& length= arrayLength[i];
+        ptr.assign(rowCount, nullptr);
+        length.assign(rowCount, 0);
+
+        for (std::size_t row= 0; row < rowCount; ++row) {
+          if (values[row] == nullptr) {
+            indicator[row]= STMT_INDICATOR_NULL;
+            continue;
+          }
+          ptr[row]= const_cast<char*>(values[row]);
+          length[row]= static_cast<unsigned long>(lengths[row]);
+        }
+        bind.buffer= ptr.data();
+        bind.length= length.data();
       }
     }
     capi::mysql_stmt_bind_param(statementId, paramBind.data());
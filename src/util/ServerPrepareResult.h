@@ -40,16 +40,25 @@ namespace capi
 class ColumnDefinition;
 class ColumnType;
 class ParameterHolder;
+struct ParameterArray;
 
 class ServerPrepareResult  : public PrepareResult {
 
   std::vector<Shared::ColumnDefinition> columns;
   std::vector<Shared::ColumnDefinition> parameters;
+  /* Column label index, shared by all result sets of this statement. Built on first request */
+  Shared::ColumnNameMap columnNameMap;
   const SQLString sql;
   std::atomic_bool inCache ; /*new std::atomic_bool()*/
   capi::MYSQL_STMT* statementId;
   std::unique_ptr<capi::MYSQL_RES, decltype(&capi::mysql_free_result)> metadata;
   std::vector<capi::MYSQL_BIND> paramBind;
+  /* Column-wise arrays for the bulk execution. Values of fixed length types are copied into contiguous
+     per-parameter buffers, for other types arrays of pointers and lengths are passed */
+  std::vector<std::vector<int8_t>> arrayData;
+  std::vector<std::vector<void*>> arrayPtr;
+  std::vector<std::vector<unsigned long>> arrayLength;
+  std::vector<std::vector<char>> arrayIndicator;
   Protocol* unProxiedProtocol;
   volatile int32_t shareCounter; /*1*/
   volatile bool isBeingDeallocate;
@@ -83,11 +92,13 @@ public:
   capi::MYSQL_STMT* getStatementId();
   const std::vector<Shared::ColumnDefinition>& getColumns() const;
   const std::vector<Shared::ColumnDefinition>& getParameters() const;
+  Shared::ColumnNameMap getColumnNameMap();
   Protocol* getUnProxiedProtocol();
   const SQLString& getSql() const;
   const std::vector<capi::MYSQL_BIND>& getParameterTypeHeader() const;
   void bindParameters(std::vector<Shared::ParameterHolder>& parameters);
-  void bindParameters(std::vector<std::vector<Shared::ParameterHolder>>& parameters);
+  void bindParameters(std::vector<std::vector<Shared::ParameterHolder>>& parameters, std::size_t offset, std::size_t rowCount);
+  void bindParameters(const std::vector<ParameterArray>& parameterArrays, std::size_t offset, std::size_t rowCount);
   };
 }
 }
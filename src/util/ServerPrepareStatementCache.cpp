@@ -27,78 +27,146 @@ namespace sql
 namespace mariadb
 {
 
-  ServerPrepareStatementCache::ServerPrepareStatementCache(uint32_t size, Shared::Protocol& protocol)
+  ServerPrepareStatementCache::ServerPrepareStatementCache(uint32_t size, Protocol* protocol)
     : maxSize(size)
     , protocol(protocol)
+    , hits(0)
+    , misses(0)
+    , evictions(0)
   {
   }
 
-  ServerPrepareStatementCache* ServerPrepareStatementCache::newInstance(uint32_t size, Shared::Protocol& protocol)
+  ServerPrepareStatementCache* ServerPrepareStatementCache::newInstance(uint32_t size, Protocol* protocol)
   {
     return new ServerPrepareStatementCache(size, protocol);
   }
 
-  bool ServerPrepareStatementCache::removeEldestEntry(value_type eldest)
+  /**
+   * Marks the statement as not cached, and deallocates it if it is not used by any PreparedStatement. Otherwise it
+   * is deallocated when the last one is closed. Cache is modified with the protocol lock held, thus the handle is
+   * only queued for release, which happens on the next prepare or on close.
+   *
+   * @param serverPrepareResult statement removed from the cache
+   */
+  void ServerPrepareStatementCache::release(ServerPrepareResult* serverPrepareResult)
   {
-    bool mustBeRemoved= cache.size() > maxSize;
+    serverPrepareResult->setRemoveFromCache();
+    if (serverPrepareResult->canBeDeallocate()) {
+      protocol->deferReleasePrepareStatement(serverPrepareResult->getStatementId());
+      delete serverPrepareResult;
+    }
+  }
 
-    if (mustBeRemoved){
-      ServerPrepareResult* serverPrepareResult= eldest.second;
-      serverPrepareResult->setRemoveFromCache();
-      if (serverPrepareResult->canBeDeallocate()) {
-        try {
-          protocol->forceReleasePrepareStatement(serverPrepareResult->getStatementId());
-        }catch (SQLException&){
+  /* Evicts least recently used entries, while the cache exceeds its size. Lock has to be set */
+  void ServerPrepareStatementCache::removeEldestEntry()
+  {
+    while (cache.size() > maxSize) {
+      ServerPrepareResult* eldest= lru.back().second;
 
-        }
-      }
+      cache.erase(lru.back().first);
+      lru.pop_back();
+      ++evictions;
+      release(eldest);
     }
-    return mustBeRemoved;
   }
 
   /**
-   * Associates the specified value with the specified key in this map. If the map previously
-   * contained a mapping for the key, the existing cached prepared result shared counter will be
-   * incremented.
+   * Associates the specified value with the specified key in this map, if there is no such mapping yet. The
+   * least recently used entries are evicted, if the cache gets bigger than its size.
    *
    * @param key key
    * @param result new prepare result.
-   * @return the previous value associated with key if not been deallocate, or null if there was no
-   *     mapping for key.
+   * @return always null. Cached statement of the same query, if it exists, is being used by other statement,
+   *     and thus the result is not cached.
    */
   ServerPrepareResult* ServerPrepareStatementCache::put(const SQLString& key, ServerPrepareResult* result)
   {
     std::lock_guard<std::mutex> localScopeLock(lock);
 
-    iterator cachedServerPrepareResult= cache.find(StringImp::get(key));
-
-    if (cachedServerPrepareResult != cache.end() && cachedServerPrepareResult->second->incrementShareCounter()){
-      return cachedServerPrepareResult->second;
+    if (cache.find(StringImp::get(key)) != cache.end()) {
+      return nullptr;
     }
 
     result->setAddToCache();
-    cache.emplace(StringImp::get(key), result);
+    lru.emplace_front(StringImp::get(key), result);
+    cache.emplace(StringImp::get(key), lru.begin());
+
+    removeEldestEntry();
 
     return nullptr;
   }
 
-
-  /* Calls have to be guarded*/
+  /**
+   * Returns cached statement of the query, if it is not used by other PreparedStatement, and increments its share
+   * counter. Found entry becomes the most recently used.
+   *
+   * @param key key
+   * @return cached statement or null
+   */
   ServerPrepareResult* ServerPrepareStatementCache::get(const SQLString& key)
   {
+    std::lock_guard<std::mutex> localScopeLock(lock);
 
-    iterator cachedServerPrepareResult= cache.find(StringImp::get(key));
+    auto cachedServerPrepareResult= cache.find(StringImp::get(key));
 
-    if (cachedServerPrepareResult != cache.end() && cachedServerPrepareResult->second->incrementShareCounter()){
-      return cachedServerPrepareResult->second;
-    }
+    if (cachedServerPrepareResult != cache.end()) {
+      ServerPrepareResult* serverPrepareResult= cachedServerPrepareResult->second->second;
 
+      // Result sets are read from the statement handle - it can't be shared by open statements
+      if (serverPrepareResult->getShareCounter() == 0 && serverPrepareResult->incrementShareCounter()) {
+        lru.splice(lru.begin(), lru, cachedServerPrepareResult->second);
+        ++hits;
+        return serverPrepareResult;
+      }
+    }
+    ++misses;
     return nullptr;
   }
+
+  /**
+   * Removes all entries from the cache. Used on connection close and reset, since server deallocates all
+   * statements of the connection then.
+   */
+  void ServerPrepareStatementCache::clear()
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+
+    for (auto& entry : lru) {
+      release(entry.second);
+    }
+    lru.clear();
+    cache.clear();
+  }
+
+  std::size_t ServerPrepareStatementCache::size()
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    return cache.size();
+  }
+
+  uint64_t ServerPrepareStatementCache::getHitCount()
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    return hits;
+  }
+
+  uint64_t ServerPrepareStatementCache::getMissCount()
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    return misses;
+  }
+
+  uint64_t ServerPrepareStatementCache::getEvictionCount()
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    return evictions;
+  }
+
   SQLString ServerPrepareStatementCache::toString()
   {
+    std::lock_guard<std::mutex> localScopeLock(lock);
     SQLString stringBuilder("ServerPrepareStatementCache.map[");
-    for (auto& entry :this->cache){
+    for (auto& entry :this->lru){
       stringBuilder
         .append("\n")
         .append(entry.first)
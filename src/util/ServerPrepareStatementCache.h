@@ -21,6 +21,7 @@
 #ifndef _SERVERPREPARESTATEMENTCACHE_H_
 #define _SERVERPREPARESTATEMENTCACHE_H_
 
+#include <list>
 #include <unordered_map>
 #include <mutex>
 
@@ -31,20 +32,36 @@ namespace sql
 namespace mariadb
 {
 
-
+/**
+  * LRU cache of server prepared statements of the connection. Statement, that is not used by any PreparedStatement
+  * object, can be taken from the cache by the next prepare of the same query. Entries exceeding the cache size are
+  * evicted, and their server handles are deallocated as soon as they are not used.
+  */
 class ServerPrepareStatementCache final {
+  typedef std::list<std::pair<std::string, ServerPrepareResult*>> LruList;
+
   std::mutex lock;
   uint32_t maxSize;
-  const Shared::Protocol protocol;
-  ServerPrepareStatementCache(uint32_t size, Shared::Protocol& protocol);
-  std::unordered_map<std::string, ServerPrepareResult*> cache;
-  typedef std::unordered_map<std::string, ServerPrepareResult*>::iterator iterator;
+  Protocol* protocol;
+  /* Entries in the order of use, the most recently used first */
+  LruList lru;
+  std::unordered_map<std::string, LruList::iterator> cache;
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+
+  ServerPrepareStatementCache(uint32_t size, Protocol* protocol);
+  void removeEldestEntry();
+  void release(ServerPrepareResult* serverPrepareResult);
 public:
-  typedef std::unordered_map<std::string, ServerPrepareResult*>::value_type value_type;
-  static ServerPrepareStatementCache* newInstance(uint32_t size, Shared::Protocol& protocol);
-  bool removeEldestEntry(value_type eldest);
+  static ServerPrepareStatementCache* newInstance(uint32_t size, Protocol* protocol);
   /*synchronized*/ ServerPrepareResult* put(const SQLString& key, ServerPrepareResult* result);
   /*synchronized*/ ServerPrepareResult* get(const SQLString& key);
+  void clear();
+  std::size_t size();
+  uint64_t getHitCount();
+  uint64_t getMissCount();
+  uint64_t getEvictionCount();
   SQLString toString();
   };
 }
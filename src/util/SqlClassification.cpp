@@ -0,0 +1,306 @@
+/************************************************************************************
+   Copyright (C) 2020 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include <cctype>
+#include <cstring>
+
+#include "SqlClassification.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  static bool isIdentifierChar(char c)
+  {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$' || (c & 0x80) != 0;
+  }
+
+  /**
+    * Skips whitespaces and comments.
+    *
+    * @return position of the first character, that is not a whitespace and not in a comment
+    */
+  static std::size_t skipWhitespacesAndComments(const char* query, std::size_t length, std::size_t pos)
+  {
+    while (pos < length) {
+      char c= query[pos];
+
+      if (std::isspace(static_cast<unsigned char>(c))) {
+        ++pos;
+      }
+      else if (c == '/' && pos + 1 < length && query[pos + 1] == '*') {
+        const char* end= std::strstr(query + pos + 2, "*/");
+        if (end == nullptr) {
+          return length;
+        }
+        pos= end - query + 2;
+      }
+      else if (c == '#' || (c == '-' && pos + 1 < length && query[pos + 1] == '-'
+        && (pos + 2 == length || std::isspace(static_cast<unsigned char>(query[pos + 2]))))) {
+        while (pos < length && query[pos] != '\n') {
+          ++pos;
+        }
+      }
+      else {
+        break;
+      }
+    }
+    return pos;
+  }
+
+  /**
+    * Checks if the word at the position is the keyword, case insensitive, followed by not identifier character.
+    */
+  static bool isKeyword(const char* query, std::size_t length, std::size_t pos, const char* keyword)
+  {
+    std::size_t keywordLength= std::strlen(keyword);
+
+    if (pos + keywordLength > length) {
+      return false;
+    }
+    for (std::size_t i= 0; i < keywordLength; ++i) {
+      if (std::toupper(static_cast<unsigned char>(query[pos + i])) != keyword[i]) {
+        return false;
+      }
+    }
+    return pos + keywordLength == length || !isIdentifierChar(query[pos + keywordLength]);
+  }
+
+  /**
+    * Skips string or quoted identifier, starting at the position.
+    *
+    * @return position after the closing quote
+    */
+  static std::size_t skipQuoted(const char* query, std::size_t length, std::size_t pos, bool noBackslashEscapes)
+  {
+    char quote= query[pos++];
+
+    while (pos < length) {
+      char c= query[pos++];
+      if (c == '\\' && quote != '`' && !noBackslashEscapes) {
+        ++pos;
+      }
+      else if (c == quote) {
+        break;
+      }
+    }
+    return pos;
+  }
+
+  static const struct {
+    const char* keyword;
+    SqlClassification::StatementType type;
+  } keywords[]= {
+    { "SELECT", SqlClassification::STMT_SELECT },
+    { "INSERT", SqlClassification::STMT_INSERT },
+    { "UPDATE", SqlClassification::STMT_UPDATE },
+    { "DELETE", SqlClassification::STMT_DELETE },
+    { "REPLACE", SqlClassification::STMT_REPLACE },
+    { "DO", SqlClassification::STMT_DO },
+    { "CALL", SqlClassification::STMT_CALL }
+  };
+
+  /**
+    * Classifies the query.
+    *
+    * @param sql query
+    * @param noBackslashEscapes is NO_BACKSLASH_ESCAPES sql mode on
+    */
+  SqlClassification::SqlClassification(const SQLString& sql, bool noBackslashEscapes)
+    : type(STMT_OTHER)
+    , keywordPos(0)
+    , callEscape(false)
+    , escapeSequence(false)
+  {
+    const char* query= sql.c_str();
+    const std::size_t length= sql.length();
+    std::size_t pos= skipWhitespacesAndComments(query, length, 0);
+
+    if (pos < length && query[pos] == '{') {
+      callEscape= true;
+      escapeSequence= true;
+      pos= skipWhitespacesAndComments(query, length, pos + 1);
+    }
+    // {?= call ...}
+    if (callEscape && pos < length && query[pos] == '?') {
+      pos= skipWhitespacesAndComments(query, length, pos + 1);
+      if (pos < length && query[pos] == '=') {
+        pos= skipWhitespacesAndComments(query, length, pos + 1);
+      }
+    }
+    keywordPos= pos;
+
+    for (auto& keyword : keywords) {
+      if (isKeyword(query, length, pos, keyword.keyword)) {
+        type= keyword.type;
+        break;
+      }
+    }
+
+    // Rest of the query is only scanned for escape sequences
+    while (!escapeSequence && pos < length) {
+      switch (query[pos]) {
+      case '\'':
+      case '"':
+      case '`':
+        pos= skipQuoted(query, length, pos, noBackslashEscapes);
+        break;
+      case '/':
+      case '#':
+      case '-':
+      {
+        std::size_t afterComment= skipWhitespacesAndComments(query, length, pos);
+        pos= afterComment > pos ? afterComment : pos + 1;
+        break;
+      }
+      case '{':
+        escapeSequence= true;
+        break;
+      default:
+        ++pos;
+      }
+    }
+  }
+
+  /**
+    * Checks if the query can be executed with server side prepare.
+    */
+  bool SqlClassification::isPreparable() const
+  {
+    return type != STMT_OTHER;
+  }
+
+  /**
+    * Parses callable statement query of the form {[?=]call [database.]procedure[(arg1,..,argn)]}. Braces are
+    * optional, comments are allowed around the keyword and in the end of the query.
+    *
+    * @param sql query
+    * @param noBackslashEscapes is NO_BACKSLASH_ESCAPES sql mode on
+    * @param parts parsed parts of the query
+    * @return false if the query does not have callable statement syntax
+    */
+  bool SqlClassification::parseCallable(const SQLString& sql, bool noBackslashEscapes, CallableParts& parts)
+  {
+    const char* query= sql.c_str();
+    const std::size_t length= sql.length();
+    std::size_t pos= skipWhitespacesAndComments(query, length, 0);
+
+    if (pos < length && query[pos] == '{') {
+      pos= skipWhitespacesAndComments(query, length, pos + 1);
+    }
+    const std::size_t queryStart= pos;
+
+    parts.isFunction= false;
+    if (pos < length && query[pos] == '?') {
+      pos= skipWhitespacesAndComments(query, length, pos + 1);
+      if (pos >= length || query[pos] != '=') {
+        return false;
+      }
+      parts.isFunction= true;
+      pos= skipWhitespacesAndComments(query, length, pos + 1);
+    }
+
+    if (!isKeyword(query, length, pos, "CALL")) {
+      return false;
+    }
+    pos= skipWhitespacesAndComments(query, length, pos + 4);
+
+    const std::size_t nameStart= pos;
+    std::size_t nameEnd[2]= { 0, 0 };
+    std::size_t nameStartPos[2]= { pos, 0 };
+    int32_t nameCount= 0;
+
+    while (nameCount < 2) {
+      nameStartPos[nameCount]= pos;
+      if (pos < length && query[pos] == '`') {
+        pos= skipQuoted(query, length, pos, true);
+      }
+      else {
+        while (pos < length && std::strchr("`{}().", query[pos]) == nullptr
+          && !std::isspace(static_cast<unsigned char>(query[pos]))) {
+          ++pos;
+        }
+      }
+      if (pos == nameStartPos[nameCount]) {
+        return false;
+      }
+      nameEnd[nameCount++]= pos;
+
+      if (pos >= length || query[pos] != '.') {
+        break;
+      }
+      ++pos;
+    }
+
+    parts.databaseAndProcedure= sql.substr(nameStart, pos - nameStart);
+    if (nameCount == 2) {
+      parts.database= sql.substr(nameStartPos[0], nameEnd[0] - nameStartPos[0]);
+    }
+    else {
+      parts.database.clear();
+    }
+    parts.procedureName= sql.substr(nameStartPos[nameCount - 1], nameEnd[nameCount - 1] - nameStartPos[nameCount - 1]);
+
+    pos= skipWhitespacesAndComments(query, length, pos);
+    parts.arguments.clear();
+
+    if (pos < length && query[pos] == '(') {
+      std::size_t argumentsStart= pos;
+      int32_t depth= 0;
+
+      while (pos < length) {
+        char c= query[pos];
+        if (c == '\'' || c == '"' || c == '`') {
+          pos= skipQuoted(query, length, pos, noBackslashEscapes);
+          continue;
+        }
+        ++pos;
+        if (c == '(') {
+          ++depth;
+        }
+        else if (c == ')' && --depth == 0) {
+          break;
+        }
+      }
+      if (depth != 0) {
+        return false;
+      }
+      parts.arguments= sql.substr(argumentsStart, pos - argumentsStart);
+    }
+
+    // Trailing comments belong to the query
+    pos= skipWhitespacesAndComments(query, length, pos);
+    std::size_t queryEnd= pos;
+    while (queryEnd > queryStart && std::isspace(static_cast<unsigned char>(query[queryEnd - 1]))) {
+      --queryEnd;
+    }
+    if (pos < length && query[pos] == '}') {
+      pos= skipWhitespacesAndComments(query, length, pos + 1);
+    }
+    if (pos != length) {
+      return false;
+    }
+    parts.query= sql.substr(queryStart, queryEnd - queryStart);
+
+    return true;
+  }
+}
+}
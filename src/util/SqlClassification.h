@@ -0,0 +1,87 @@
+/************************************************************************************
+   Copyright (C) 2020 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#ifndef _SQLCLASSIFICATION_H_
+#define _SQLCLASSIFICATION_H_
+
+#include "Consts.h"
+
+namespace sql
+{
+namespace mariadb
+{
+
+/**
+  * Classification of the query by its leading keyword, made by a hand-written lexer in one pass over the query
+  * instead of regular expressions. Leading whitespaces and comments are skipped, JDBC escape sequences outside of
+  * strings and comments are detected.
+  */
+class SqlClassification
+{
+public:
+  enum StatementType
+  {
+    STMT_OTHER= 0,
+    STMT_SELECT,
+    STMT_INSERT,
+    STMT_UPDATE,
+    STMT_DELETE,
+    STMT_REPLACE,
+    STMT_DO,
+    STMT_CALL
+  };
+
+  /* Parts of callable statement query of the form {[?=]call [database.]procedure[(arg1,..,argn)]} */
+  struct CallableParts
+  {
+    /* Query without braces */
+    SQLString query;
+    bool isFunction= false;
+    SQLString databaseAndProcedure;
+    SQLString database;
+    SQLString procedureName;
+    SQLString arguments;
+  };
+
+private:
+  StatementType type;
+  /* Position of the leading keyword */
+  std::size_t keywordPos;
+  /* Query starts with '{', i.e. is in the call escape syntax */
+  bool callEscape;
+  /* Query contains '{' outside of strings and comments */
+  bool escapeSequence;
+
+public:
+  SqlClassification(const SQLString& sql, bool noBackslashEscapes);
+
+  StatementType getType() const { return type; }
+  std::size_t getKeywordPosition() const { return keywordPos; }
+  bool isCallEscape() const { return callEscape; }
+  bool hasEscapeSequence() const { return escapeSequence; }
+  bool isPreparable() const;
+
+  static bool parseCallable(const SQLString& sql, bool noBackslashEscapes, CallableParts& parts);
+};
+
+}
+}
+#endif
@@ -0,0 +1,268 @@
+/************************************************************************************
+   Copyright (C) 2020 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include <vector>
+
+#include "TimerWheel.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  const uint32_t TimerWheel::TICK_MS;
+  const uint32_t TimerWheel::SLOT_BITS;
+  const uint32_t TimerWheel::SLOTS;
+  const uint32_t TimerWheel::LEVELS;
+  std::atomic<bool> TimerWheel::destroyed(false);
+
+  TimerWheel::Timer::Timer(std::function<void()> _task)
+    : task(_task)
+    , prev(nullptr)
+    , next(nullptr)
+    , expiry(0)
+    , armed(false)
+    , running(false)
+    , used(false)
+  {
+  }
+
+
+  TimerWheel::Timer::~Timer()
+  {
+    disarm();
+  }
+
+  /**
+    * Disarms the timer, same as TimerWheel::disarm, but does not need the wheel, if the timer has never been armed,
+    * or the wheel is already destroyed at exit.
+    */
+  void TimerWheel::Timer::disarm()
+  {
+    if (used && !destroyed.load()) {
+      TimerWheel::getInstance().disarm(*this);
+    }
+  }
+
+
+  TimerWheel::TimerWheel()
+    : stopped(false)
+    , start(std::chrono::steady_clock::now())
+    , currentTick(0)
+    , armedCount(0)
+  {
+    for (auto& level : slots) {
+      for (auto& slot : level) {
+        slot= nullptr;
+      }
+    }
+  }
+
+
+  TimerWheel::~TimerWheel()
+  {
+    {
+      std::lock_guard<std::mutex> localScopeLock(lock);
+      stopped= true;
+    }
+    wakeUp.notify_all();
+    if (worker.joinable()) {
+      worker.join();
+    }
+    destroyed.store(true);
+  }
+
+
+  TimerWheel& TimerWheel::getInstance()
+  {
+    static TimerWheel instance;
+    return instance;
+  }
+
+
+  uint64_t TimerWheel::nowTick() const
+  {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start).count()) / TICK_MS;
+  }
+
+  /**
+    * Links the timer into the slot of the lowest level, which range covers its expiry. Has to be called with the lock.
+    */
+  void TimerWheel::link(Timer& timer)
+  {
+    uint64_t delta= timer.expiry - currentTick;
+    uint32_t level= 0;
+
+    while (level < LEVELS - 1 && delta >= (static_cast<uint64_t>(1) << (SLOT_BITS*(level + 1)))) {
+      ++level;
+    }
+    Timer*& head= slots[level][(timer.expiry >> (SLOT_BITS*level)) & (SLOTS - 1)];
+
+    timer.prev= nullptr;
+    timer.next= head;
+    if (head != nullptr) {
+      head->prev= &timer;
+    }
+    head= &timer;
+  }
+
+  /* Has to be called with the lock */
+  void TimerWheel::unlink(Timer& timer)
+  {
+    if (timer.prev != nullptr) {
+      timer.prev->next= timer.next;
+    }
+    else {
+      // The timer is the head of its slot
+      for (auto& level : slots) {
+        Timer*& head= level[(timer.expiry >> (SLOT_BITS*(&level - slots))) & (SLOTS - 1)];
+        if (head == &timer) {
+          head= timer.next;
+          break;
+        }
+      }
+    }
+    if (timer.next != nullptr) {
+      timer.next->prev= timer.prev;
+    }
+    timer.prev= timer.next= nullptr;
+  }
+
+  /**
+    * Moves timers of the current slot of the level to lower levels. Has to be called with the lock.
+    */
+  void TimerWheel::cascade(uint32_t level)
+  {
+    Timer*& head= slots[level][(currentTick >> (SLOT_BITS*level)) & (SLOTS - 1)];
+    Timer* timer= head;
+
+    head= nullptr;
+    while (timer != nullptr) {
+      Timer* next= timer->next;
+      link(*timer);
+      timer= next;
+    }
+  }
+
+  /**
+    * Arms the timer to run its task after the delay. Timer, that is already armed, is re-armed.
+    *
+    * @param timer timer
+    * @param delayMs delay in milliseconds
+    */
+  void TimerWheel::arm(Timer& timer, uint32_t delayMs)
+  {
+    std::unique_lock<std::mutex> localScopeLock(lock);
+
+    if (timer.armed) {
+      unlink(timer);
+      --armedCount;
+    }
+    if (armedCount == 0) {
+      // The wheel is empty, and can jump to the current time, instead of ticking through the idle period
+      currentTick= nowTick();
+    }
+    timer.expiry= currentTick + (delayMs + TICK_MS - 1) / TICK_MS;
+    if (timer.expiry == currentTick) {
+      ++timer.expiry;
+    }
+    link(timer);
+    timer.armed= true;
+    timer.used= true;
+
+    if (++armedCount == 1) {
+      if (!worker.joinable()) {
+        worker= std::thread(&TimerWheel::run, this);
+      }
+      localScopeLock.unlock();
+      wakeUp.notify_one();
+    }
+  }
+
+  /**
+    * Disarms the timer. If its task is running at the moment, waits for it to finish. Thus, after return the task
+    * is not running, and will not run.
+    *
+    * @param timer timer
+    */
+  void TimerWheel::disarm(Timer& timer)
+  {
+    std::unique_lock<std::mutex> localScopeLock(lock);
+
+    if (timer.armed) {
+      unlink(timer);
+      timer.armed= false;
+      --armedCount;
+    }
+    while (timer.running && worker.get_id() != std::this_thread::get_id()) {
+      taskDone.wait(localScopeLock);
+    }
+  }
+
+
+  void TimerWheel::run()
+  {
+    std::unique_lock<std::mutex> localScopeLock(lock);
+    std::vector<Timer*> expired;
+
+    while (!stopped) {
+      if (armedCount == 0) {
+        wakeUp.wait(localScopeLock);
+        continue;
+      }
+      const uint64_t tick= nowTick();
+
+      while (currentTick < tick && armedCount > 0) {
+        ++currentTick;
+        for (uint32_t level= 1; level < LEVELS
+          && (currentTick & ((static_cast<uint64_t>(1) << (SLOT_BITS*level)) - 1)) == 0; ++level) {
+          cascade(level);
+        }
+        Timer*& head= slots[0][currentTick & (SLOTS - 1)];
+        while (head != nullptr) {
+          Timer* timer= head;
+          unlink(*timer);
+          timer->armed= false;
+          timer->running= true;
+          --armedCount;
+          expired.push_back(timer);
+        }
+      }
+
+      for (Timer* timer : expired) {
+        localScopeLock.unlock();
+        try {
+          timer->task();
+        }
+        catch (...) {
+        }
+        localScopeLock.lock();
+        timer->running= false;
+      }
+      if (!expired.empty()) {
+        expired.clear();
+        taskDone.notify_all();
+      }
+      wakeUp.wait_for(localScopeLock, std::chrono::milliseconds(TICK_MS));
+    }
+  }
+}
+}
@@ -0,0 +1,109 @@
+/************************************************************************************
+   Copyright (C) 2020 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#ifndef _TIMERWHEEL_H_
+#define _TIMERWHEEL_H_
+
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <atomic>
+
+#include "Consts.h"
+
+namespace sql
+{
+namespace mariadb
+{
+
+/**
+  * Process-wide hierarchical timer wheel, serviced by one thread, started when the first timer is armed.
+  * Timers are owned by their users and are linked into wheel slots, thus arming and disarming is O(1) and
+  * does not allocate. Tasks are run by the wheel's thread, and should be short - anything that may block, has to be
+  * handed over to another thread.
+  */
+class TimerWheel final
+{
+public:
+  class Timer
+  {
+    friend class TimerWheel;
+
+    std::function<void()> task;
+    Timer* prev;
+    Timer* next;
+    /* Tick, when the timer expires */
+    uint64_t expiry;
+    bool armed;
+    bool running;
+    /* Set when the timer is armed the first time. Timer, that has never been armed, does not need the wheel */
+    bool used;
+
+    Timer(const Timer&)= delete;
+    Timer& operator=(const Timer&)= delete;
+
+  public:
+    Timer(std::function<void()> task);
+    ~Timer();
+    void disarm();
+  };
+
+private:
+  static const uint32_t TICK_MS= 10;
+  static const uint32_t SLOT_BITS= 8;
+  static const uint32_t SLOTS= 1 << SLOT_BITS;
+  static const uint32_t LEVELS= 4;
+  /* Set when the instance is destroyed at exit, so that timers destroyed after it do not try to use it */
+  static std::atomic<bool> destroyed;
+
+  std::mutex lock;
+  /* Wakes up the thread, when the first timer is armed, or the wheel is stopped */
+  std::condition_variable wakeUp;
+  /* Signals end of a task run, for whoever waits in disarm */
+  std::condition_variable taskDone;
+  std::thread worker;
+  bool stopped;
+  const std::chrono::steady_clock::time_point start;
+  uint64_t currentTick;
+  std::size_t armedCount;
+  /* Heads of lists of timers, in each slot of each level */
+  Timer* slots[LEVELS][SLOTS];
+
+  TimerWheel();
+  uint64_t nowTick() const;
+  void link(Timer& timer);
+  void unlink(Timer& timer);
+  void cascade(uint32_t level);
+  void run();
+
+public:
+  ~TimerWheel();
+  static TimerWheel& getInstance();
+
+  void arm(Timer& timer, uint32_t delayMs);
+  void disarm(Timer& timer);
+};
+
+}
+}
+#endif
@@ -20,6 +20,15 @@
 
 #include <cctype>
 #include <array>
+#include <cstdio>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# ifdef _MSC_VER
+#  include <intrin.h>
+# endif
+# define ESCAPE_WITH_SSE2 1
+#endif
 
 #include "Utils.h"
 
@@ -86,33 +95,194 @@ namespace mariadb
     return replace(escaped, "\\", "\\\\");
   }
 
-  void Utils::escapeData(const char* in, size_t len, bool noBackslashEscapes, SQLString& out)
+#ifdef ESCAPE_WITH_SSE2
+  static inline uint32_t firstSetBit(uint32_t mask)
   {
-    std::string &realOut= StringImp::get(out);
-    out.reserve(out.length() + len + 64);
+# ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<uint32_t>(index);
+# else
+    return static_cast<uint32_t>(__builtin_ctz(mask));
+# endif
+  }
+#endif
+
+  /**
+    * Finds the first character, that has to be escaped. With noBackslashEscapes that is only the quote, otherwise
+    * also backslash, double quote and zero byte. SSE2 is used to check 16 bytes at once, where available.
+    *
+    * @param in start of the data
+    * @param end end of the data
+    * @param noBackslashEscapes is NO_BACKSLASH_ESCAPES sql mode on
+    * @return pointer to the character to escape, or end if there is none
+    */
+  static const char* findCharToEscape(const char* in, const char* end, bool noBackslashEscapes)
+  {
+#ifdef ESCAPE_WITH_SSE2
+    const __m128i quote= _mm_set1_epi8(QUOTE);
 
-    //TODO: can be easily optimized
     if (noBackslashEscapes) {
-      for (size_t i = 0; i < len; i++) {
-        if (QUOTE == in[i]) {
-          realOut.push_back(QUOTE);
+      while (end - in >= 16) {
+        __m128i chunk= _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+        uint32_t mask= static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)));
+        if (mask != 0) {
+          return in + firstSetBit(mask);
         }
-        realOut.push_back(in[i]);
+        in+= 16;
       }
     }
     else {
-      for (size_t i = 0; i < len; i++) {
-        if (in[i] == QUOTE
-          || in[i] == BACKSLASH
-          || in[i] == DBL_QUOTE
-          || in[i] == ZERO_BYTE) {
-          realOut.push_back('\\');
+      const __m128i backslash= _mm_set1_epi8(BACKSLASH);
+      const __m128i dblQuote= _mm_set1_epi8(DBL_QUOTE);
+      const __m128i zeroByte= _mm_set1_epi8(ZERO_BYTE);
+
+      while (end - in >= 16) {
+        __m128i chunk= _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+        __m128i found= _mm_or_si128(
+          _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+          _mm_or_si128(_mm_cmpeq_epi8(chunk, dblQuote), _mm_cmpeq_epi8(chunk, zeroByte)));
+        uint32_t mask= static_cast<uint32_t>(_mm_movemask_epi8(found));
+        if (mask != 0) {
+          return in + firstSetBit(mask);
         }
-        realOut.push_back(in[i]);
+        in+= 16;
+      }
+    }
+#endif
+    if (noBackslashEscapes) {
+      while (in < end && *in != QUOTE) {
+        ++in;
+      }
+    }
+    else {
+      while (in < end && *in != QUOTE && *in != BACKSLASH && *in != DBL_QUOTE && *in != ZERO_BYTE) {
+        ++in;
+      }
+    }
+    return in;
+  }
+
+  /**
+    * Appends data to the string escaping it for the use in the string literal. Spans not requiring escaping are
+    * copied at once.
+    *
+    * @param in data to escape
+    * @param len length of the data
+    * @param noBackslashEscapes is NO_BACKSLASH_ESCAPES sql mode on. Then only quotes are escaped, by doubling them
+    * @param out string to append escaped data to
+    */
+  void Utils::escapeData(const char* in, size_t len, bool noBackslashEscapes, SQLString& out)
+  {
+    std::string &realOut= StringImp::get(out);
+    const char* end= in + len;
+    realOut.reserve(realOut.length() + len + 64);
+
+    while (in < end) {
+      const char* special= findCharToEscape(in, end, noBackslashEscapes);
+
+      realOut.append(in, special - in);
+      if (special == end) {
+        break;
       }
+      realOut.push_back(noBackslashEscapes ? QUOTE : '\\');
+      realOut.push_back(*special);
+      in= special + 1;
     }
   }
 
+  /**
+    * Writes decimal digits of the value backwards, ending at the given position of the buffer.
+    *
+    * @return pointer to the first digit
+    */
+  static char* formatUnsignedBackwards(char* end, uint64_t value)
+  {
+    do {
+      *--end= static_cast<char>('0' + value % 10);
+      value/= 10;
+    } while (value != 0);
+    return end;
+  }
+
+  /**
+    * Appends decimal text of the value to the string without creating temporary strings. Text is the same, that
+    * std::to_string produces.
+    *
+    * @param str string to append to
+    * @param value number
+    */
+  void Utils::appendInteger(SQLString& str, int64_t value)
+  {
+    char buffer[24], *end= buffer + sizeof(buffer);
+    // Negation in unsigned arithmetic is defined for INT64_MIN as well
+    char* begin= formatUnsignedBackwards(end, value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value));
+
+    if (value < 0) {
+      *--begin= '-';
+    }
+    str.append(begin, end - begin);
+  }
+
+
+  void Utils::appendUnsigned(SQLString& str, uint64_t value)
+  {
+    char buffer[24], *end= buffer + sizeof(buffer);
+    char* begin= formatUnsignedBackwards(end, value);
+
+    str.append(begin, end - begin);
+  }
+
+
+  /**
+    * Appends text of the floating point value, that reads back as the same value. That takes 17 significant digits
+    * for double, and 9 for float. std::to_string is not used - its %f loses small values, and produces long text
+    * for big ones.
+    *
+    * @param str string to append to
+    * @param value value
+    * @param digits number of significant digits
+    */
+  void Utils::appendDouble(SQLString& str, double value, int32_t digits)
+  {
+    char buffer[64];
+    int length= std::snprintf(buffer, sizeof(buffer), "%.*g", digits, value);
+
+    if (length < 0 || static_cast<std::size_t>(length) >= sizeof(buffer)) {
+      str.append(std::to_string(value));
+    }
+    else {
+      str.append(buffer, static_cast<std::size_t>(length));
+    }
+  }
+
+  /**
+    * Returns length of the value's text, that appendInteger would append.
+    */
+  std::size_t Utils::integerTextLength(int64_t value)
+  {
+    return (value < 0 ? 1 : 0) + unsignedTextLength(value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value));
+  }
+
+
+  std::size_t Utils::unsignedTextLength(uint64_t value)
+  {
+    std::size_t length= 1;
+
+    while (value >= 10) {
+      value/= 10;
+      ++length;
+    }
+    return length;
+  }
+
+
+  std::size_t Utils::doubleTextLength(double value, int32_t digits)
+  {
+    int length= std::snprintf(nullptr, 0, "%.*g", digits, value);
+    return length > 0 ? static_cast<std::size_t>(length) : 0;
+  }
+
   /**
     * Encrypts a password.
     *
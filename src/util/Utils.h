@@ -58,6 +58,12 @@ public:
 
   static SQLString escapeString(const SQLString& value, bool noBackslashEscapes);
   static void escapeData(const char* in, size_t len, bool noBackslashEscapes, SQLString& out);
+  static void appendInteger(SQLString& str, int64_t value);
+  static void appendUnsigned(SQLString& str, uint64_t value);
+  static void appendDouble(SQLString& str, double value, int32_t digits= 17);
+  static std::size_t integerTextLength(int64_t value);
+  static std::size_t unsignedTextLength(uint64_t value);
+  static std::size_t doubleTextLength(double value, int32_t digits= 17);
   static const char* encryptPassword(const SQLString&& password, const char* seed, SQLString& passwordCharacterEncoding);
 #ifdef THIS_FUNCTION_MAKES_SENSE
   static char* copyWithLength(char* orig,int32_t length);
@@ -3212,5 +3212,206 @@ void connection::bugConCpp21()
 }
 
 
+
+void connection::pool()
+{
+  sql::ConnectOptionsMap opts;
+  opts["hostName"]= url;
+  opts["userName"]= user;
+  opts["password"]= passwd;
+  opts["pool"]= "true";
+  opts["maxPoolSize"]= "1";
+  opts["connectTimeout"]= "1000";
+
+  std::unique_ptr<sql::Connection> first(driver->connect(opts));
+  std::unique_ptr<sql::Statement> st(first->createStatement());
+  std::unique_ptr<sql::ResultSet> rs(st->executeQuery("SELECT CONNECTION_ID()"));
+  ASSERT(rs->next());
+  int64_t connectionId= rs->getLong(1);
+  rs.reset();
+  st.reset();
+
+  first->setAutoCommit(false);
+  first->close();
+  ASSERT(first->isClosed());
+
+  // The same physical connection, but with default state
+  std::unique_ptr<sql::Connection> second(driver->connect(opts));
+  ASSERT(second->getAutoCommit());
+  st.reset(second->createStatement());
+  rs.reset(st->executeQuery("SELECT CONNECTION_ID()"));
+  ASSERT(rs->next());
+  ASSERT_EQUALS(connectionId, rs->getLong(1));
+  rs.reset();
+  st.reset();
+
+  // The only connection is in use
+  time_t start= time(NULL);
+  try
+  {
+    std::unique_ptr<sql::Connection> third(driver->connect(opts));
+    FAIL("Pool has given more connections than maxPoolSize");
+  }
+  catch (sql::SQLException &e)
+  {
+    logMsg("Expected error: " + std::string(e.what()));
+  }
+  ASSERT(time(NULL) - start < 4);
+
+  // Deleting the handle without close gives connection back as well
+  second.reset();
+  first.reset(driver->connect(opts));
+  ASSERT(!first->isClosed());
+  first->close();
+}
+
+
+void connection::poolWarmUp()
+{
+  sql::Properties p;
+  p["user"]=     user;
+  p["password"]= passwd;
+
+  stmt.reset(con->createStatement());
+  res.reset(stmt->executeQuery("SELECT COUNT(*) FROM information_schema.PROCESSLIST"));
+  ASSERT(res->next());
+  int32_t before= res->getInt(1);
+
+  std::unique_ptr<sql::Connection> pooled(driver->connect(url + "?pool=true&maxPoolSize=4&minPoolSize=4", p));
+  ASSERT(pooled.get() != nullptr);
+
+  int32_t opened= 0;
+  for (int32_t i= 0; i < 50 && opened < 4; ++i)
+  {
+    stmt->execute("DO SLEEP(0.1)");
+    res.reset(stmt->executeQuery("SELECT COUNT(*) FROM information_schema.PROCESSLIST"));
+    ASSERT(res->next());
+    opened= res->getInt(1) - before;
+  }
+  ASSERT(opened >= 4);
+  pooled->close();
+}
+
+
+void connection::poolReset()
+{
+  sql::Properties p;
+  p["user"]=     user;
+  p["password"]= passwd;
+
+  const sql::SQLString poolUrl(url + "?pool=true&maxPoolSize=1&useResetConnection=true&poolValidMinDelay=0");
+
+  std::unique_ptr<sql::Connection> pooled(driver->connect(poolUrl, p));
+  std::unique_ptr<sql::Statement> st(pooled->createStatement());
+  st->execute("SET @pool_reset_test=1");
+  std::unique_ptr<sql::ResultSet> rs(st->executeQuery("SELECT CONNECTION_ID()"));
+  ASSERT(rs->next());
+  int64_t connectionId= rs->getLong(1);
+  rs.reset();
+  st.reset();
+  pooled->close();
+
+  pooled.reset(driver->connect(poolUrl, p));
+  st.reset(pooled->createStatement());
+  rs.reset(st->executeQuery("SELECT CONNECTION_ID(), @pool_reset_test IS NULL"));
+  ASSERT(rs->next());
+  ASSERT_EQUALS(connectionId, rs->getLong(1));
+  ASSERT(rs->getBoolean(2));
+  rs.reset();
+  st.reset();
+  pooled->close();
+
+  stmt.reset(con->createStatement());
+  stmt->execute("KILL " + std::to_string(connectionId));
+  stmt->execute("DO SLEEP(0.2)");
+
+  pooled.reset(driver->connect(poolUrl, p));
+  st.reset(pooled->createStatement());
+  rs.reset(st->executeQuery("SELECT CONNECTION_ID()"));
+  ASSERT(rs->next());
+  ASSERT(connectionId != rs->getLong(1));
+  pooled->close();
+}
+
+
+void connection::poolAffinity()
+{
+  sql::Properties p;
+  p["user"]=     user;
+  p["password"]= passwd;
+
+  const sql::SQLString poolUrl(url + "?pool=true&maxPoolSize=3&minPoolSize=3");
+  std::unique_ptr<sql::Connection> first(driver->connect(poolUrl, p));
+  std::unique_ptr<sql::Connection> second(driver->connect(poolUrl, p));
+
+  std::unique_ptr<sql::Statement> st(second->createStatement());
+  std::unique_ptr<sql::ResultSet> rs(st->executeQuery("SELECT CONNECTION_ID()"));
+  ASSERT(rs->next());
+  int64_t connectionId= rs->getLong(1);
+  rs.reset();
+  st.reset();
+
+  first->close();
+  second->close();
+
+  for (int32_t i= 0; i < 10; ++i)
+  {
+    second.reset(driver->connect(poolUrl, p));
+    st.reset(second->createStatement());
+    rs.reset(st->executeQuery("SELECT CONNECTION_ID()"));
+    ASSERT(rs->next());
+    ASSERT_EQUALS(connectionId, rs->getLong(1));
+    rs.reset();
+    st.reset();
+    second->close();
+  }
+}
+
+
+void connection::poolMetrics()
+{
+  sql::Properties p;
+  p["user"]=     user;
+  p["password"]= passwd;
+
+  const sql::SQLString poolUrl(url + "?pool=true&maxPoolSize=1&connectTimeout=500");
+  std::unique_ptr<sql::Connection> pooled(driver->connect(poolUrl, p));
+
+  ASSERT_EQUALS("1", static_cast<std::string>(pooled->getClientOption("poolTotalConnections")));
+  ASSERT_EQUALS("1", static_cast<std::string>(pooled->getClientOption("poolActiveConnections")));
+  ASSERT_EQUALS("0", static_cast<std::string>(pooled->getClientOption("poolIdleConnections")));
+  ASSERT_EQUALS("1", static_cast<std::string>(pooled->getClientOption("poolConnectionsCreated")));
+  ASSERT_EQUALS("1", static_cast<std::string>(pooled->getClientOption("poolCheckoutWaitCount")));
+  ASSERT_EQUALS("0", static_cast<std::string>(pooled->getClientOption("poolConnectionTimeouts")));
+
+  try
+  {
+    std::unique_ptr<sql::Connection> other(driver->connect(poolUrl, p));
+    FAIL("Pool has given more connections than maxPoolSize");
+  }
+  catch (sql::SQLException &)
+  {
+  }
+  ASSERT_EQUALS("1", static_cast<std::string>(pooled->getClientOption("poolConnectionTimeouts")));
+
+  int64_t waitMax= std::stoll(static_cast<std::string>(pooled->getClientOption("poolCheckoutWaitMax")));
+  int64_t waitP99= std::stoll(static_cast<std::string>(pooled->getClientOption("poolCheckoutWaitP99")));
+  ASSERT(waitP99 <= waitMax);
+
+  try
+  {
+    pooled->getClientOption("poolCheckoutWaitP42");
+    FAIL("Unknown statistic name has been accepted");
+  }
+  catch (sql::SQLException &)
+  {
+  }
+
+  // Not a pool connection
+  ASSERT_EQUALS("0", static_cast<std::string>(con->getClientOption("poolTotalConnections")));
+  pooled->close();
+}
+
+
 } /* namespace connection */
 } /* namespace testsuite */
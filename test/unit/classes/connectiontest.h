@@ -86,6 +86,11 @@ public:
   TEST_CASE(tls_version);
   TEST_CASE(cached_sha2_auth);
   TEST_CASE(bugConCpp21);
+  TEST_CASE(pool);
+  TEST_CASE(poolWarmUp);
+  TEST_CASE(poolReset);
+  TEST_CASE(poolAffinity);
+  TEST_CASE(poolMetrics);
   }
 
   /**
@@ -265,6 +270,33 @@ public:
    * URL overrides properties instead of the opposite
    */
   void bugConCpp21();
+
+  /*
+   * Connection pool: closed connection goes back to the pool with its state reset, and waiting for
+   * a connection is limited by connectTimeout
+   */
+  void pool();
+
+  /*
+   * Pool opens minPoolSize connections in the background, without waiting for them to be requested
+   */
+  void poolWarmUp();
+
+  /*
+   * With useResetConnection, connection given back to the pool loses its session state. Connection killed
+   * while idle is not given out by the pool
+   */
+  void poolReset();
+
+  /*
+   * Thread, that gives connection back to the pool, gets the same connection on the next checkout
+   */
+  void poolAffinity();
+
+  /*
+   * Pool gauges, counters and histograms are readable with getClientOption
+   */
+  void poolMetrics();
 };
 
 
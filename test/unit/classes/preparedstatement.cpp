@@ -35,6 +35,7 @@
 #include "Warning.h"
 #include "preparedstatementtest.h"
 #include <stdlib.h>
+#include <cfloat>
 
 #include <memory>
 
@@ -1583,5 +1584,1051 @@ void preparedstatement::executeQuery()
   }
 }
 
+
+void preparedstatement::bulkBatch()
+{
+  logMsg("preparedstatement::bulkBatch() - MySQL_PreparedStatement::executeBatch with useBulkStmts");
+
+  try
+  {
+    sql::ConnectOptionsMap opts;
+    opts["useServerPrepStmts"]= "true";
+    opts["useBulkStmts"]= "true";
+
+    created_objects.clear();
+    con.reset(getConnection(&opts));
+    con->setSchema(db);
+
+    stmt.reset(con->createStatement());
+    stmt->execute("DROP TABLE IF EXISTS test");
+    stmt->execute("CREATE TABLE test(id INT NOT NULL, val BIGINT, label VARCHAR(32))");
+
+    pstmt.reset(con->prepareStatement("INSERT INTO test(id, val, label) VALUES (?, ?, ?)"));
+
+    // Bulk execution reports SUCCESS_NO_INFO for each row, execution row by row - the row's update count
+    const bool bulkSupported= getServerVersion(con) >= 100207;
+    const int32_t rowCount= 100;
+
+    // Batch without NULLs, and batch with NULLs, that must not prevent bulk execution
+    for (int32_t withNulls= 0; withNulls < 2; ++withNulls)
+    {
+      stmt->execute("TRUNCATE TABLE test");
+
+      for (int32_t i= 0; i < rowCount; ++i)
+      {
+        pstmt->setInt(1, i);
+        if (withNulls && i % 3 == 0) {
+          pstmt->setNull(2, sql::DataType::BIGINT);
+          pstmt->setNull(3, sql::DataType::VARCHAR);
+        }
+        else {
+          pstmt->setInt64(2, static_cast<int64_t>(i)*1000000007LL);
+          pstmt->setString(3, "row" + std::to_string(i));
+        }
+        pstmt->addBatch();
+      }
+      std::unique_ptr<sql::Ints> updateCounts(pstmt->executeBatch());
+      ASSERT_EQUALS(static_cast<std::size_t>(rowCount), updateCounts->size());
+      if (bulkSupported) {
+        for (int32_t updateCount : *updateCounts) {
+          ASSERT_EQUALS(static_cast<int32_t>(sql::Statement::SUCCESS_NO_INFO), updateCount);
+        }
+      }
+
+      res.reset(stmt->executeQuery("SELECT id, val, label FROM test ORDER BY id"));
+      for (int32_t i= 0; i < rowCount; ++i)
+      {
+        ASSERT(res->next());
+        ASSERT_EQUALS(i, res->getInt(1));
+        if (withNulls && i % 3 == 0) {
+          res->getLong(2);
+          ASSERT(res->wasNull());
+          res->getString(3);
+          ASSERT(res->wasNull());
+        }
+        else {
+          ASSERT_EQUALS(static_cast<int64_t>(i)*1000000007LL, res->getLong(2));
+          ASSERT_EQUALS("row" + std::to_string(i), res->getString(3));
+        }
+      }
+      ASSERT(!res->next());
+    }
+
+    stmt->execute("DROP TABLE IF EXISTS test");
+  }
+  catch (sql::SQLException &e)
+  {
+    logErr(e.what());
+    logErr("SQLState: " + std::string(e.getSQLState()));
+    fail(e.what(), __FILE__, __LINE__);
+  }
+}
+
+void preparedstatement::longTextResult()
+{
+  logMsg("preparedstatement::longTextResult() - MySQL_PreparedStatement::executeQuery");
+
+  try
+  {
+    stmt->execute("DROP TABLE IF EXISTS test");
+    stmt->execute("CREATE TABLE test(id INT, txt LONGTEXT)");
+    stmt->execute("INSERT INTO test VALUES(1, 'short'), (2, REPEAT('a', 100000)), (3, NULL), (4, REPEAT('b', 20000)), (5, 'end')");
+
+    pstmt.reset(con->prepareStatement("SELECT id, txt FROM test ORDER BY id"));
+    res.reset(pstmt->executeQuery());
+
+    ASSERT(res->next());
+    ASSERT_EQUALS("short", res->getString(2));
+    ASSERT(res->next());
+    ASSERT_EQUALS(std::string(100000, 'a'), res->getString(2));
+    ASSERT(res->next());
+    res->getString(2);
+    ASSERT(res->wasNull());
+    ASSERT(res->next());
+    ASSERT_EQUALS(std::string(20000, 'b'), res->getString(2));
+    ASSERT(res->next());
+    ASSERT_EQUALS("end", res->getString(2));
+    ASSERT_EQUALS(5, res->getInt(1));
+    ASSERT(!res->next());
+
+    stmt->execute("DROP TABLE IF EXISTS test");
+  }
+  catch (sql::SQLException &e)
+  {
+    logErr(e.what());
+    logErr("SQLState: " + std::string(e.getSQLState()));
+    fail(e.what(), __FILE__, __LINE__);
+  }
+}
+
+void preparedstatement::pipelinedBatch()
+{
+  logMsg("preparedstatement::pipelinedBatch() - MySQL_PreparedStatement::executeBatch with useBatchMultiSend");
+
+  try
+  {
+    sql::ConnectOptionsMap opts;
+    opts["useServerPrepStmts"]= "true";
+    opts["useBatchMultiSend"]= "true";
+    opts["useBatchMultiSendNumber"]= "7";
+    opts["continueBatchOnError"]= "true";
+
+    created_objects.clear();
+    con.reset(getConnection(&opts));
+    con->setSchema(db);
+
+    stmt.reset(con->createStatement());
+    stmt->execute("DROP TABLE IF EXISTS test");
+    stmt->execute("CREATE TABLE test(id INT NOT NULL PRIMARY KEY, label VARCHAR(32))");
+
+    const int32_t rowCount= 100;
+    pstmt.reset(con->prepareStatement("INSERT INTO test(id, label) VALUES (?, ?)"));
+    for (int32_t i= 0; i < rowCount; ++i)
+    {
+      // Row 50 duplicates the key of row 49
+      pstmt->setInt(1, i == 50 ? 49 : i);
+      pstmt->setString(2, "row" + std::to_string(i));
+      pstmt->addBatch();
+    }
+    try {
+      pstmt->executeBatch();
+      FAIL("Duplicate key should cause exception");
+    }
+    catch (sql::SQLException&) {
+    }
+
+    res.reset(stmt->executeQuery("SELECT COUNT(*), MAX(id) FROM test"));
+    ASSERT(res->next());
+    ASSERT_EQUALS(rowCount - 1, res->getInt(1));
+    ASSERT_EQUALS(rowCount - 1, res->getInt(2));
+
+    pstmt.reset(con->prepareStatement("UPDATE test SET label=? WHERE id=?"));
+    for (int32_t i= 0; i < rowCount; ++i)
+    {
+      pstmt->setString(1, "updated" + std::to_string(i));
+      pstmt->setInt(2, i);
+      pstmt->addBatch();
+    }
+    std::unique_ptr<sql::Ints> updateCounts(pstmt->executeBatch());
+    ASSERT_EQUALS(static_cast<std::size_t>(rowCount), updateCounts->size());
+    for (int32_t i= 0; i < rowCount; ++i)
+    {
+      ASSERT_EQUALS(i == 50 ? 0 : 1, (*updateCounts)[i]);
+    }
+
+    stmt->addBatch("UPDATE test SET label='first' WHERE id=0");
+    stmt->addBatch("UPDATE test SET label='none' WHERE id=50");
+    stmt->addBatch("UPDATE test SET label='last' WHERE id=99");
+    updateCounts.reset(stmt->executeBatch());
+    ASSERT_EQUALS(static_cast<std::size_t>(3), updateCounts->size());
+    ASSERT_EQUALS(1, (*updateCounts)[0]);
+    ASSERT_EQUALS(0, (*updateCounts)[1]);
+    ASSERT_EQUALS(1, (*updateCounts)[2]);
+
+    res.reset(stmt->executeQuery("SELECT label FROM test WHERE id IN (0, 51, 99) ORDER BY id"));
+    ASSERT(res->next());
+    ASSERT_EQUALS("first", res->getString(1));
+    ASSERT(res->next());
+    ASSERT_EQUALS("updated51", res->getString(1));
+    ASSERT(res->next());
+    ASSERT_EQUALS("last", res->getString(1));
+
+    stmt->execute("DROP TABLE IF EXISTS test");
+  }
+  catch (sql::SQLException &e)
+  {
+    logErr(e.what());
+    logErr("SQLState: " + std::string(e.getSQLState()));
+    fail(e.what(), __FILE__, __LINE__);
+  }
+}
+
+void preparedstatement::parametersReuse()
+{
+  logMsg("preparedstatement::parametersReuse() - MySQL_PreparedStatement::set* with addBatch and clearParameters");
+
+  try
+  {
+    stmt->execute("DROP TABLE IF EXISTS test");
+    stmt->execute("CREATE TABLE test(id INT NOT NULL, label VARCHAR(32))");
+
+    pstmt.reset(con->prepareStatement("INSERT INTO test(id, label) VALUES (?, ?)"));
+    pstmt->setInt(1, 1);
+    pstmt->setString(2, "same");
+    pstmt->addBatch();
+    // Only the first parameter is changed - the second one keeps its value
+    pstmt->setInt(1, 2);
+    pstmt->addBatch();
+    pstmt->setInt(1, 3);
+    pstmt->addBatch();
+    pstmt->executeBatch();
+
+    pstmt->setInt(1, 4);
+    ASSERT_EQUALS(1, pstmt->executeUpdate());
+
+    pstmt->clearParameters();
+    pstmt->setInt(1, 5);
+    try {
+      pstmt->executeUpdate();
+      FAIL("Not set parameter should cause exception");
+    }
+    catch (sql::SQLException& e) {
+      ASSERT_EQUALS("07004", e.getSQLState());
+    }
+
+    res.reset(stmt->executeQuery("SELECT id, label FROM test ORDER BY id"));
+    for (int32_t i= 1; i < 5; ++i)
+    {
+      ASSERT(res->next());
+      ASSERT_EQUALS(i, res->getInt(1));
+      ASSERT_EQUALS("same", res->getString(2));
+    }
+    ASSERT(!res->next());
+
+    stmt->execute("DROP TABLE IF EXISTS test");
+  }
+  catch (sql::SQLException &e)
+  {
+    logErr(e.what());
+    logErr("SQLState: " + std::string(e.getSQLState()));
+    fail(e.what(), __FILE__, __LINE__);
+  }
+}
+
+void preparedstatement::arrayBatch()
+{
+  logMsg("preparedstatement::arrayBatch() - MySQL_PreparedStatement::set*Array and executeBatch");
+
+  const std::size_t rowCount= 1000;
+  std::vector<int32_t> ids(rowCount);
+  std::vector<int64_t> bigs(rowCount);
+  std::vector<double> doubles(rowCount);
+  std::unique_ptr<bool[]> nulls(new bool[rowCount]);
+  std::vector<std::string> labels(rowCount);
+  std::vector<const char*> labelPtrs(rowCount);
+  std::vector<std::size_t> labelLengths(rowCount);
+
+  for (std::size_t i= 0; i < rowCount; ++i)
+  {
+    ids[i]= static_cast<int32_t>(i);
+    bigs[i]= static_cast<int64_t>(i)*1000000007LL;
+    doubles[i]= i/4.0;
+    nulls[i]= (i % 5 == 0);
+    labels[i]= "label" + std::to_string(i);
+    labelPtrs[i]= (i % 7 == 0) ? nullptr : labels[i].c_str();
+    labelLengths[i]= labels[i].length();
+  }
+
+  try
+  {
+    for (int32_t bulk= 0; bulk < 2; ++bulk)
+    {
+      logMsg(bulk ? "... with bulk" : "... without bulk");
+      sql::ConnectOptionsMap opts;
+      opts["useServerPrepStmts"]= "true";
+      opts["useBulkStmts"]= bulk ? "true" : "false";
+
+      created_objects.clear();
+      con.reset(getConnection(&opts));
+      con->setSchema(db);
+
+      stmt.reset(con->createStatement());
+      stmt->execute("DROP TABLE IF EXISTS test");
+      stmt->execute("CREATE TABLE test(id INT NOT NULL, big BIGINT, dbl DOUBLE, label VARCHAR(32))");
+
+      pstmt.reset(con->prepareStatement("INSERT INTO test(id, big, dbl, label) VALUES (?, ?, ?, ?)"));
+      pstmt->setIntArray(1, ids.data(), rowCount, nullptr);
+      pstmt->setInt64Array(2, bigs.data(), rowCount, nulls.get());
+      try {
+        pstmt->executeBatch();
+        FAIL("Not set arrays should cause exception");
+      }
+      catch (sql::SQLException& e) {
+        ASSERT_EQUALS("07004", e.getSQLState());
+      }
+
+      // The same statement is executed again with shorter arrays, which replace previous ones
+      const std::size_t batchSize[]= { rowCount, rowCount/10 };
+      for (std::size_t pass= 0; pass < 2; ++pass)
+      {
+        const std::size_t count= batchSize[pass];
+        const std::size_t offset= rowCount - count;
+
+        stmt->execute("DELETE FROM test");
+        if (pass > 0) {
+          pstmt->setIntArray(1, ids.data() + offset, count, nullptr);
+          pstmt->setInt64Array(2, bigs.data() + offset, count, nulls.get() + offset);
+        }
+        pstmt->setDoubleArray(3, doubles.data() + offset, count, nullptr);
+        pstmt->setStringArray(4, labelPtrs.data() + offset, labelLengths.data() + offset, count);
+        std::unique_ptr<sql::Ints> updateCounts(pstmt->executeBatch());
+        ASSERT_EQUALS(count, updateCounts->size());
+
+        res.reset(stmt->executeQuery("SELECT id, big, dbl, label FROM test ORDER BY id"));
+        for (std::size_t i= offset; i < rowCount; ++i)
+        {
+          ASSERT(res->next());
+          ASSERT_EQUALS(ids[i], res->getInt(1));
+          if (nulls[i]) {
+            res->getLong(2);
+            ASSERT(res->wasNull());
+          }
+          else {
+            ASSERT_EQUALS(bigs[i], res->getLong(2));
+          }
+          ASSERT_EQUALS(doubles[i], static_cast<double>(res->getDouble(3)));
+          if (labelPtrs[i] == nullptr) {
+            res->getString(4);
+            ASSERT(res->wasNull());
+          }
+          else {
+            ASSERT_EQUALS(labels[i], res->getString(4));
+          }
+        }
+        ASSERT(!res->next());
+      }
+    }
+
+    try {
+      pstmt->setIntArray(1, ids.data(), rowCount, nullptr);
+      pstmt->setInt64Array(2, bigs.data(), rowCount - 1, nullptr);
+      FAIL("Arrays of different length should cause exception");
+    }
+    catch (sql::SQLException&) {
+    }
+
+    stmt->execute("DROP TABLE IF EXISTS test");
+  }
+  catch (sql::SQLException &e)
+  {
+    logErr(e.what());
+    logErr("SQLState: " + std::string(e.getSQLState()));
+    fail(e.what(), __FILE__, __LINE__);
+  }
+}
+
+
+void preparedstatement::maxPacketBatch()
+{
+  logMsg("preparedstatement::maxPacketBatch() - MySQL_PreparedStatement::executeBatch exceeding max_allowed_packet");
+
+  try
+  {
+    res.reset(stmt->executeQuery("SELECT @@max_allowed_packet"));
+    ASSERT(res->next());
+    const int64_t maxAllowedPacket= res->getLong(1);
+
+    if (maxAllowedPacket > 64*1024*1024) {
+      SKIP("max_allowed_packet is too big for the test");
+    }
+    // Each row takes a quarter of the packet, all rows together - 2.5 packets
+    const std::size_t rowCount= 10;
+    const sql::SQLString value(std::string(static_cast<std::size_t>(maxAllowedPacket/4), 'a'));
+
+    for (int32_t bulk= 0; bulk < 2; ++bulk)
+    {
+      logMsg(bulk ? "... with bulk" : "... without bulk");
+      sql::ConnectOptionsMap opts;
+      opts["useServerPrepStmts"]= "true";
+      opts["useBulkStmts"]= bulk ? "true" : "false";
+
+      created_objects.clear();
+      con.reset(getConnection(&opts));
+      con->setSchema(db);
+
+      stmt.reset(con->createStatement());
+      stmt->execute("DROP TABLE IF EXISTS test");
+      stmt->execute("CREATE TABLE test(id INT NOT NULL, val LONGTEXT)");
+
+      pstmt.reset(con->prepareStatement("INSERT INTO test(id, val) VALUES (?, ?)"));
+      for (std::size_t i= 0; i < rowCount; ++i)
+      {
+        pstmt->setInt(1, static_cast<int32_t>(i));
+        pstmt->setString(2, value);
+        pstmt->addBatch();
+      }
+      std::unique_ptr<sql::Ints> updateCounts(pstmt->executeBatch());
+
+      ASSERT_EQUALS(rowCount, updateCounts->size());
+      for (std::size_t i= 0; i < rowCount; ++i)
+      {
+        ASSERT((*updateCounts)[i] == 1 || (*updateCounts)[i] == sql::Statement::SUCCESS_NO_INFO);
+      }
+
+      res.reset(stmt->executeQuery("SELECT COUNT(*), SUM(LENGTH(val)) FROM test"));
+      ASSERT(res->next());
+      ASSERT_EQUALS(static_cast<int64_t>(rowCount), res->getLong(1));
+      ASSERT_EQUALS(static_cast<int64_t>(rowCount*value.length()), res->getLong(2));
+    }
+    stmt->execute("DROP TABLE IF EXISTS test");
+  }
+  catch (sql::SQLException &e)
+  {
+    logErr(e.what());
+    logErr("SQLState: " + std::string(e.getSQLState()));
+    fail(e.what(), __FILE__, __LINE__);
+  }
+}
+
+
+void preparedstatement::escapedStrings()
+{
+  logMsg("preparedstatement::escapedStrings() - MySQL_PreparedStatement::setString with characters to escape");
+
+  // Special characters at different positions relatively to 16 bytes blocks
+  std::vector<std::string> values;
+  const char specials[]= { '\'', '\\', '"', '\0' };
+
+  for (std::size_t length= 0; length < 40; ++length)
+  {
+    std::string value(length, 'x');
+    for (std::size_t i= 0; i < length; ++i)
+    {
+      if ((i*7 + length) % 5 == 0) {
+        value[i]= specials[(i + length) % sizeof(specials)];
+      }
+    }
+    values.push_back(value);
+  }
+  // Each character alone at the start, around the end of the first 16 bytes block, and at the end of the data
+  for (char special : specials)
+  {
+    const std::size_t positions[]= { 0, 15, 16, 17, 31, 39 };
+    for (std::size_t pos : positions)
+    {
+      std::string value(40, 'x');
+      value[pos]= special;
+      values.push_back(value);
+    }
+    values.push_back(std::string(19, 'x').append(1, special));
+  }
+  values.push_back(std::string(1000, '\''));
+  values.push_back(std::string(1000, '\\'));
+
+  try
+  {
+    sql::ConnectOptionsMap opts;
+    // Strings are escaped only in text protocol, i.e. in rewritten batch
+    opts["rewriteBatchedStatements"]= "true";
+    opts["useBulkStmts"]= "false";
+
+    created_objects.clear();
+    con.reset(getConnection(&opts));
+    con->setSchema(db);
+
+    stmt.reset(con->createStatement());
+    stmt->execute("DROP TABLE IF EXISTS test");
+    stmt->execute("CREATE TABLE test(id INT NOT NULL PRIMARY KEY, val VARBINARY(1000))");
+
+    for (int32_t noBackslashEscapes= 0; noBackslashEscapes < 2; ++noBackslashEscapes)
+    {
+      logMsg(noBackslashEscapes ? "... with NO_BACKSLASH_ESCAPES" : "... without NO_BACKSLASH_ESCAPES");
+      stmt->execute("TRUNCATE TABLE test");
+      stmt->execute(noBackslashEscapes ? "SET SESSION sql_mode=CONCAT(@@sql_mode, ',NO_BACKSLASH_ESCAPES')"
+        : "SET SESSION sql_mode=REPLACE(@@sql_mode, 'NO_BACKSLASH_ESCAPES', '')");
+
+      pstmt.reset(con->prepareStatement("INSERT INTO test(id, val) VALUES (?, ?)"));
+      for (std::size_t i= 0; i < values.size(); ++i)
+      {
+        pstmt->setInt(1, static_cast<int32_t>(i));
+        pstmt->setString(2, sql::SQLString(values[i].data(), values[i].length()));
+        pstmt->addBatch();
+      }
+      pstmt->executeBatch();
+
+      res.reset(stmt->executeQuery("SELECT val FROM test ORDER BY id"));
+      for (const auto& value : values)
+      {
+        ASSERT(res->next());
+        sql::SQLString fetched(res->getString(1));
+        ASSERT_EQUALS(value.length(), fetched.length());
+        ASSERT(value.compare(0, value.length(), fetched.c_str(), fetched.length()) == 0);
+      }
+      ASSERT(!res->next());
+    }
+    stmt->execute("DROP TABLE IF EXISTS test");
+  }
+  catch (sql::SQLException &e)
+  {
+    logErr(e.what());
+    logErr("SQLState: " + std::string(e.getSQLState()));
+    fail(e.what(), __FILE__, __LINE__);
+  }
+}
+
+
+void preparedstatement::statementCache()
+{
+  logMsg("preparedstatement::statementCache() - server prepared statements cache with cachePrepStmts");
+
+  try
+  {
+    sql::ConnectOptionsMap opts;
+    opts["useServerPrepStmts"]= "true";
+    opts["cachePrepStmts"]= "true";
+    opts["prepStmtCacheSize"]= "2";
+    opts["prepStmtCacheSqlLimit"]= "64";
+
+    created_objects.clear();
+    con.reset(getConnection(&opts));
+    con->setSchema(db);
+
+    const sql::SQLString query[]= { "SELECT 1", "SELECT 2", "SELECT 3" };
+
+    // miss, hit
+    for (int32_t i= 0; i < 2; ++i)
+    {
+      pstmt.reset(con->prepareStatement(query[0]));
+      res.reset(pstmt->executeQuery());
+      ASSERT(res->next());
+      ASSERT_EQUALS(1, res->getInt(1));
+      pstmt->close();
+    }
+    ASSERT_EQUALS(sql::SQLString("1"), con->getClientOption("prepStmtCacheHits"));
+    ASSERT_EQUALS(sql::SQLString("1"), con->getClientOption("prepStmtCacheMisses"));
+
+    // Statement in use can't be shared - second one is a miss
+    pstmt.reset(con->prepareStatement(query[0]));
+    std::unique_ptr<sql::PreparedStatement> pstmt2(con->prepareStatement(query[0]));
+    res.reset(pstmt->executeQuery());
+    std::unique_ptr<sql::ResultSet> res2(pstmt2->executeQuery());
+    ASSERT(res->next());
+    ASSERT(res2->next());
+    ASSERT_EQUALS(1, res->getInt(1));
+    ASSERT_EQUALS(1, res2->getInt(1));
+    res2.reset();
+    pstmt2->close();
+    pstmt->close();
+    ASSERT_EQUALS(sql::SQLString("2"), con->getClientOption("prepStmtCacheHits"));
+    ASSERT_EQUALS(sql::SQLString("2"), con->getClientOption("prepStmtCacheMisses"));
+
+    // Query 0 is evicted as least recently used
+    for (int32_t i= 1; i < 3; ++i)
+    {
+      pstmt.reset(con->prepareStatement(query[i]));
+      res.reset(pstmt->executeQuery());
+      ASSERT(res->next());
+      ASSERT_EQUALS(i + 1, res->getInt(1));
+      pstmt->close();
+    }
+    ASSERT_EQUALS(sql::SQLString("1"), con->getClientOption("prepStmtCacheEvictions"));
+    ASSERT_EQUALS(sql::SQLString("2"), con->getClientOption("prepStmtCacheEntries"));
+
+    pstmt.reset(con->prepareStatement(query[0]));
+    pstmt->close();
+    ASSERT_EQUALS(sql::SQLString("2"), con->getClientOption("prepStmtCacheHits"));
+    ASSERT_EQUALS(sql::SQLString("2"), con->getClientOption("prepStmtCacheEvictions"));
+
+    // Query longer than prepStmtCacheSqlLimit is not cached
+    const sql::SQLString longQuery("SELECT 1 FROM DUAL WHERE 1=1 AND 2=2 AND 3=3 AND 4=4 AND 5=5 AND 6=6");
+    for (int32_t i= 0; i < 2; ++i)
+    {
+      pstmt.reset(con->prepareStatement(longQuery));
+      res.reset(pstmt->executeQuery());
+      ASSERT(res->next());
+      pstmt->close();
+    }
+    ASSERT_EQUALS(sql::SQLString("2"), con->getClientOption("prepStmtCacheHits"));
+    ASSERT_EQUALS(sql::SQLString("2"), con->getClientOption("prepStmtCacheEntries"));
+
+    // Many distinct statements don't accumulate in the cache
+    for (int32_t i= 0; i < 100; ++i)
+    {
+      pstmt.reset(con->prepareStatement("SELECT " + std::to_string(i) + " + ?"));
+      pstmt->close();
+    }
+    ASSERT_EQUALS(sql::SQLString("2"), con->getClientOption("prepStmtCacheEntries"));
+  }
+  catch (sql::SQLException &e)
+  {
+    logErr(e.what());
+    logErr("SQLState: " + std::string(e.getSQLState()));
+    fail(e.what(), __FILE__, __LINE__);
+  }
+}
+
+/* Statement type has to be recognized after leading comments, and escape sequences have to be replaced */
+void preparedstatement::queryClassification()
+{
+  logMsg("preparedstatement::queryClassification() - leading comments, escape sequences and call escape syntax");
+
+  try
+  {
+    sql::ConnectOptionsMap opts;
+    opts["useServerPrepStmts"]= "true";
+    opts["cachePrepStmts"]= "true";
+
+    created_objects.clear();
+    con.reset(getConnection(&opts));
+    con->setSchema(db);
+
+    const sql::SQLString query[]= { "/* leading */ SELECT ?, ?", "# leading\n-- leading\n  select ?, ?",
+      "SELECT ?, {fn CONCAT(?, '{')}" };
+
+    for (int32_t i= 0; i < 3; ++i)
+    {
+      pstmt.reset(con->prepareStatement(query[i]));
+      pstmt->setInt(1, i);
+      pstmt->setString(2, "a");
+      res.reset(pstmt->executeQuery());
+      ASSERT(res->next());
+      ASSERT_EQUALS(i, res->getInt(1));
+      ASSERT_EQUALS(i < 2 ? "a" : "a{", res->getString(2));
+      pstmt->close();
+    }
+    // All of them have been prepared on the server
+    ASSERT_EQUALS(sql::SQLString("3"), con->getClientOption("prepStmtCacheMisses"));
+
+    std::string sp_code("CREATE PROCEDURE p(IN a INT, IN b INT) BEGIN SELECT a + b; END;");
+    if (!createSP(sp_code))
+    {
+      logMsg("... skipping:");
+      return;
+    }
+
+    const sql::SQLString callQuery[]= { "{call p(?, ?)}", " /* leading */ { CALL `p`(?, ?) } ", "call " + db + ".p(?, ?) /* trailing */" };
+
+    for (int32_t i= 0; i < 3; ++i)
+    {
+      cstmt.reset(con->prepareCall(callQuery[i]));
+      cstmt->setInt(1, i);
+      cstmt->setInt(2, 40);
+      res.reset(cstmt->executeQuery());
+      ASSERT(res->next());
+      ASSERT_EQUALS(i + 40, res->getInt(1));
+      res->close();
+      while (cstmt->getMoreResults())
+      {}
+      cstmt->close();
+    }
+
+    try
+    {
+      cstmt.reset(con->prepareCall("SELECT p(?, ?)"));
+      FAIL("Invalid callable syntax has been accepted");
+    }
+    catch (sql::SQLSyntaxErrorException&)
+    {
+    }
+  }
+  catch (sql::SQLException &e)
+  {
+    logErr(e.what());
+    logErr("SQLState: " + std::string(e.getSQLState()));
+    fail(e.what(), __FILE__, __LINE__);
+  }
+}
+
+
+void preparedstatement::parsedQueryCache()
+{
+  logMsg("preparedstatement::parsedQueryCache() - process-wide cache of parsed queries");
+
+  try
+  {
+    sql::ConnectOptionsMap opts;
+    // Rewritten batches take parsed query from the cache
+    opts["rewriteBatchedStatements"]= "true";
+    opts["useBulkStmts"]= "false";
+
+    created_objects.clear();
+    con.reset(getConnection(&opts));
+    con->setSchema(db);
+
+    stmt.reset(con->createStatement());
+    stmt->execute("DROP TABLE IF EXISTS test");
+    stmt->execute("CREATE TABLE test(id INT NOT NULL PRIMARY KEY, val VARCHAR(32))");
+
+    // Query unique for the process, so that other tests do not affect counters
+    const sql::SQLString query("INSERT INTO test(id, val) /* parsedQueryCache */ VALUES(?, ?)");
+    const int64_t missesBefore= std::stoll(static_cast<std::string>(con->getClientOption("clientPrepareCacheMisses")));
+    const int64_t hitsBefore= std::stoll(static_cast<std::string>(con->getClientOption("clientPrepareCacheHits")));
+
+    for (int32_t connection= 0; connection < 3; ++connection)
+    {
+      std::unique_ptr<sql::Connection> con2(getConnection(&opts));
+      con2->setSchema(db);
+      pstmt.reset(con2->prepareStatement(query));
+
+      for (int32_t i= 0; i < 3; ++i)
+      {
+        pstmt->setInt(1, connection*3 + i);
+        pstmt->setString(2, "value");
+        pstmt->addBatch();
+      }
+      std::unique_ptr<sql::Ints> updateCounts(pstmt->executeBatch());
+      ASSERT_EQUALS(3, static_cast<int32_t>(updateCounts->size()));
+      pstmt->close();
+      con2->close();
+    }
+
+    // Parsed once by the first connection, taken from the cache by others
+    ASSERT_EQUALS(missesBefore + 1, std::stoll(static_cast<std::string>(con->getClientOption("clientPrepareCacheMisses"))));
+    ASSERT_EQUALS(hitsBefore + 2, std::stoll(static_cast<std::string>(con->getClientOption("clientPrepareCacheHits"))));
+
+    res.reset(stmt->executeQuery("SELECT COUNT(*) FROM test"));
+    ASSERT(res->next());
+    ASSERT_EQUALS(9, res->getInt(1));
+  }
+  catch (sql::SQLException &e)
+  {
+    logErr(e.what());
+    logErr("SQLState: " + std::string(e.getSQLState()));
+    fail(e.what(), __FILE__, __LINE__);
+  }
+}
+
+
+void preparedstatement::numericTextBatch()
+{
+  logMsg("preparedstatement::numericTextBatch() - numeric values in text protocol batch");
+
+  const int64_t longValue[]= { 0, -1, 9, 10, -10, INT64_MAX, INT64_MIN };
+  const uint64_t ulongValue[]= { 0, 1, 9, 10, 99, 100, UINT64_MAX };
+  const int32_t intValue[]= { 0, -1, 7, -100, 1000, INT32_MAX, INT32_MIN };
+  const double doubleValue[]= { 0.0, -1.5, 0.1, 1.0/3, -1e15, 1e300, 1e-300 };
+  const std::size_t rowCount= sizeof(longValue)/sizeof(longValue[0]);
+
+  try
+  {
+    sql::ConnectOptionsMap opts;
+    // Batch is sent as text multi-values INSERT
+    opts["rewriteBatchedStatements"]= "true";
+    opts["useBulkStmts"]= "false";
+
+    created_objects.clear();
+    con.reset(getConnection(&opts));
+    con->setSchema(db);
+
+    stmt.reset(con->createStatement());
+    stmt->execute("DROP TABLE IF EXISTS test");
+    stmt->execute("CREATE TABLE test(id INT NOT NULL PRIMARY KEY, l BIGINT, ul BIGINT UNSIGNED, i INT, d DOUBLE)");
+
+    pstmt.reset(con->prepareStatement("INSERT INTO test(id, l, ul, i, d) VALUES(?, ?, ?, ?, ?)"));
+    for (std::size_t row= 0; row < rowCount; ++row)
+    {
+      pstmt->setInt(1, static_cast<int32_t>(row));
+      pstmt->setInt64(2, longValue[row]);
+      pstmt->setUInt64(3, ulongValue[row]);
+      pstmt->setInt(4, intValue[row]);
+      pstmt->setDouble(5, doubleValue[row]);
+      pstmt->addBatch();
+    }
+    std::unique_ptr<sql::Ints> updateCounts(pstmt->executeBatch());
+    ASSERT_EQUALS(rowCount, updateCounts->size());
+
+    res.reset(stmt->executeQuery("SELECT l, ul, i, d FROM test ORDER BY id"));
+    for (std::size_t row= 0; row < rowCount; ++row)
+    {
+      ASSERT(res->next());
+      ASSERT_EQUALS(longValue[row], res->getInt64(1));
+      ASSERT_EQUALS(ulongValue[row], res->getUInt64(2));
+      ASSERT_EQUALS(intValue[row], res->getInt(3));
+      ASSERT(doubleValue[row] == res->getDouble(4));
+    }
+    ASSERT(!res->next());
+  }
+  catch (sql::SQLException &e)
+  {
+    logErr(e.what());
+    logErr("SQLState: " + std::string(e.getSQLState()));
+    fail(e.what(), __FILE__, __LINE__);
+  }
+}
+
+
+void preparedstatement::queryTimeout()
+{
+  logMsg("preparedstatement::queryTimeout() - PreparedStatement::setQueryTimeout");
+
+  try
+  {
+    sql::ConnectOptionsMap opts;
+    opts["useServerPrepStmts"]= "true";
+    opts["useBulkStmts"]= "false";
+    opts["useBatchMultiSend"]= "false";
+
+    created_objects.clear();
+    con.reset(getConnection(&opts));
+    con->setSchema(db);
+
+    pstmt.reset(con->prepareStatement("SELECT SLEEP(?)"));
+    pstmt->setQueryTimeout(1);
+    pstmt->setInt(1, 5);
+
+    // Killed SLEEP returns 1 instead of an error
+    time_t start= time(NULL);
+    res.reset(pstmt->executeQuery());
+    ASSERT(time(NULL) - start < 4);
+    ASSERT(res->next());
+    ASSERT_EQUALS(1, res->getInt(1));
+    res.reset();
+
+    pstmt.reset(con->prepareStatement("DO SLEEP(?)"));
+    pstmt->setQueryTimeout(1);
+    for (int32_t i= 0; i < 5; ++i)
+    {
+      pstmt->setInt(1, 1);
+      pstmt->addBatch();
+    }
+
+    start= time(NULL);
+    try
+    {
+      pstmt->executeBatch();
+      FAIL("Batch has not been stopped by the query timeout");
+    }
+    catch (sql::SQLException &)
+    {
+    }
+    ASSERT(time(NULL) - start < 4);
+
+    // Connection stays usable, and timeout does not affect next queries
+    pstmt->setQueryTimeout(0);
+    pstmt->setInt(1, 0);
+    pstmt->execute();
+    stmt.reset(con->createStatement());
+    res.reset(stmt->executeQuery("SELECT 1"));
+    ASSERT(res->next());
+  }
+  catch (sql::SQLException &e)
+  {
+    logErr(e.what());
+    logErr("SQLState: " + std::string(e.getSQLState()));
+    fail(e.what(), __FILE__, __LINE__);
+  }
+}
+
+void preparedstatement::doubleBatchRoundTrip()
+{
+  logMsg("preparedstatement::doubleBatchRoundTrip() - exact double and float values in batches");
+
+  const double doubleValue[]= { 0.1, 1.0/3, 1e-300, 123456789.123456789, DBL_MAX, -DBL_MIN, 2.0/3 };
+  const float floatValue[]= { 0.1f, 1.0f/3, 1e-30f, 123456.789f, FLT_MAX, -FLT_MIN, 2.0f/3 };
+  const std::size_t rowCount= sizeof(doubleValue)/sizeof(doubleValue[0]);
+  /* Binary protocol batch, and text batch rewritten to multi-values INSERT */
+  const char* rewriteBatched[]= { "false", "true" };
+
+  try
+  {
+    for (std::size_t mode= 0; mode < sizeof(rewriteBatched)/sizeof(rewriteBatched[0]); ++mode)
+    {
+      sql::ConnectOptionsMap opts;
+      opts["rewriteBatchedStatements"]= rewriteBatched[mode];
+      opts["useBulkStmts"]= "false";
+      opts["useBatchMultiSend"]= "true";
+
+      created_objects.clear();
+      con.reset(getConnection(&opts));
+      con->setSchema(db);
+
+      stmt.reset(con->createStatement());
+      stmt->execute("DROP TABLE IF EXISTS test");
+      stmt->execute("CREATE TABLE test(id INT NOT NULL PRIMARY KEY, d DOUBLE, f FLOAT)");
+
+      pstmt.reset(con->prepareStatement("INSERT INTO test(id, d, f) VALUES(?, ?, ?)"));
+      for (std::size_t row= 0; row < rowCount; ++row)
+      {
+        pstmt->setInt(1, static_cast<int32_t>(row));
+        pstmt->setDouble(2, doubleValue[row]);
+        pstmt->setFloat(3, floatValue[row]);
+        pstmt->addBatch();
+      }
+      std::unique_ptr<sql::Ints> updateCounts(pstmt->executeBatch());
+      ASSERT_EQUALS(rowCount, updateCounts->size());
+
+      /* FLOAT is widened to DOUBLE, since its own text form is not exact */
+      res.reset(stmt->executeQuery("SELECT d, f + 0e0 FROM test ORDER BY id"));
+      for (std::size_t row= 0; row < rowCount; ++row)
+      {
+        ASSERT(res->next());
+        ASSERT(doubleValue[row] == res->getDouble(1));
+        ASSERT(floatValue[row] == static_cast<float>(res->getDouble(2)));
+      }
+      ASSERT(!res->next());
+      stmt->execute("DROP TABLE IF EXISTS test");
+    }
+  }
+  catch (sql::SQLException &e)
+  {
+    logErr(e.what());
+    logErr("SQLState: " + std::string(e.getSQLState()));
+    fail(e.what(), __FILE__, __LINE__);
+  }
+}
+
+void preparedstatement::scalarParametersUpdate()
+{
+  logMsg("preparedstatement::scalarParametersUpdate() - scalar parameters set again between executions");
+
+  try
+  {
+    stmt->execute("DROP TABLE IF EXISTS test");
+    stmt->execute("CREATE TABLE test(id INT NOT NULL, l BIGINT, d DOUBLE)");
+
+    pstmt.reset(con->prepareStatement("INSERT INTO test(id, l, d) VALUES (?, ?, ?)"));
+    for (int32_t i= 1; i < 4; ++i)
+    {
+      pstmt->setInt(1, i);
+      pstmt->setLong(2, i*10);
+      pstmt->setDouble(3, i + 0.5);
+      ASSERT_EQUALS(1, pstmt->executeUpdate());
+    }
+    // Other type for the same parameters
+    pstmt->setLong(1, 4);
+    pstmt->setInt(2, 40);
+    pstmt->setFloat(3, 4.5f);
+    ASSERT_EQUALS(1, pstmt->executeUpdate());
+
+    // Rows already in the batch must not change, when parameters are set for the next row
+    for (int32_t i= 5; i < 8; ++i)
+    {
+      pstmt->setInt(1, i);
+      pstmt->setLong(2, i*10);
+      pstmt->setDouble(3, i + 0.5);
+      pstmt->addBatch();
+    }
+    pstmt->executeBatch();
+    pstmt->clearBatch();
+
+    pstmt->setInt(1, 8);
+    pstmt->setLong(2, 80);
+    pstmt->setDouble(3, 8.5);
+    ASSERT_EQUALS(1, pstmt->executeUpdate());
+
+    res.reset(stmt->executeQuery("SELECT id, l, d FROM test ORDER BY id"));
+    for (int32_t i= 1; i < 9; ++i)
+    {
+      ASSERT(res->next());
+      ASSERT_EQUALS(i, res->getInt(1));
+      ASSERT_EQUALS(static_cast<int64_t>(i*10), res->getInt64(2));
+      ASSERT_EQUALS_EPSILON(i + 0.5, res->getDouble(3), 0.000001);
+    }
+    ASSERT(!res->next());
+
+    stmt->execute("DROP TABLE IF EXISTS test");
+  }
+  catch (sql::SQLException &e)
+  {
+    logErr(e.what());
+    logErr("SQLState: " + std::string(e.getSQLState()));
+    fail(e.what(), __FILE__, __LINE__);
+  }
+}
+
+void preparedstatement::stringParametersBatch()
+{
+  logMsg("preparedstatement::stringParametersBatch() - short and long strings in batch rows");
+
+  try
+  {
+    const int32_t rowCount= 60;
+    std::vector<std::string> values;
+
+    for (int32_t i= 0; i < 2*rowCount; ++i)
+    {
+      values.push_back(std::string(i, static_cast<char>('a' + i % 26)));
+    }
+
+    stmt->execute("DROP TABLE IF EXISTS test");
+    stmt->execute("CREATE TABLE test(id INT NOT NULL PRIMARY KEY, s VARCHAR(200))");
+
+    pstmt.reset(con->prepareStatement("INSERT INTO test(id, s) VALUES (?, ?)"));
+    for (int32_t i= 0; i < rowCount; ++i)
+    {
+      pstmt->setInt(1, i);
+      if (i % 7 == 3)
+      {
+        pstmt->setNull(2, sql::DataType::VARCHAR);
+      }
+      else
+      {
+        pstmt->setString(2, values[i]);
+      }
+      pstmt->addBatch();
+    }
+    // Rows of arrays follow rows added with addBatch()
+    std::vector<int32_t> ids;
+    std::vector<const char*> strings;
+    std::vector<std::size_t> lengths;
+
+    for (int32_t i= rowCount; i < 2*rowCount; ++i)
+    {
+      ids.push_back(i);
+      strings.push_back(i % 7 == 3 ? nullptr : values[i].c_str());
+      lengths.push_back(values[i].length());
+    }
+    pstmt->setIntArray(1, ids.data(), ids.size(), nullptr);
+    pstmt->setStringArray(2, strings.data(), lengths.data(), strings.size());
+    pstmt->executeBatch();
+    pstmt->clearBatch();
+
+    res.reset(stmt->executeQuery("SELECT id, s FROM test ORDER BY id"));
+    for (int32_t i= 0; i < 2*rowCount; ++i)
+    {
+      ASSERT(res->next());
+      ASSERT_EQUALS(i, res->getInt(1));
+      if (i % 7 == 3)
+      {
+        res->getString(2);
+        ASSERT(res->wasNull());
+      }
+      else
+      {
+        ASSERT_EQUALS(values[i], std::string(res->getString(2).c_str()));
+      }
+    }
+    ASSERT(!res->next());
+
+    stmt->execute("DROP TABLE IF EXISTS test");
+  }
+  catch (sql::SQLException &e)
+  {
+    logErr(e.what());
+    logErr("SQLState: " + std::string(e.getSQLState()));
+    fail(e.what(), __FILE__, __LINE__);
+  }
+}
+
 } /* namespace preparedstatement */
 } /* namespace testsuite */
@@ -68,6 +68,21 @@ public:
     TEST_CASE(getWarnings);
     TEST_CASE(blob);
     TEST_CASE(executeQuery);
+    TEST_CASE(bulkBatch);
+    TEST_CASE(longTextResult);
+    TEST_CASE(pipelinedBatch);
+    TEST_CASE(parametersReuse);
+    TEST_CASE(arrayBatch);
+    TEST_CASE(maxPacketBatch);
+    TEST_CASE(escapedStrings);
+    TEST_CASE(statementCache);
+    TEST_CASE(queryClassification);
+    TEST_CASE(parsedQueryCache);
+    TEST_CASE(numericTextBatch);
+    TEST_CASE(queryTimeout);
+    TEST_CASE(doubleBatchRoundTrip);
+    TEST_CASE(scalarParametersUpdate);
+    TEST_CASE(stringParametersBatch);
   }
 
   /**
@@ -142,6 +157,80 @@ public:
    */
   void executeQuery();
 
+  /**
+   * Batch executed via bulk protocol has to insert all rows, including NULLs
+   */
+  void bulkBatch();
+
+  /**
+   * Values longer than initial result buffer have to be fetched completely
+   */
+  void longTextResult();
+
+  /**
+   * Batch executed with useBatchMultiSend has to report update count and error for each parameter set
+   */
+  void pipelinedBatch();
+
+  /**
+   * Parameter values have to stay set after addBatch and execution, until they are changed or cleared
+   */
+  void parametersReuse();
+
+  /**
+   * Batch of parameters values set with array setters, executed with and without bulk protocol
+   */
+  void arrayBatch();
+
+  /**
+   * Batch, which total size exceeds max_allowed_packet, has to be sent in several packets
+   */
+  void maxPacketBatch();
+
+  /**
+   * Strings with characters requiring escaping, sent inlined into text queries, in both NO_BACKSLASH_ESCAPES modes
+   */
+  void escapedStrings();
+
+  /**
+   * Server prepared statements cache - reuse of statements, LRU eviction and cache statistics
+   */
+  void statementCache();
+
+  /**
+   * Queries with leading comments and escape sequences have to be recognized as preparable, and call escape syntax parsed
+   */
+  void queryClassification();
+
+  /**
+   * Batches of the same query, executed by different connections, have to parse the query only once
+   */
+  void parsedQueryCache();
+
+  /**
+   * Numeric parameters values, including limits of their types, inlined into text queries of the batch
+   */
+  void numericTextBatch();
+
+  /**
+   * Query timeout of single execution and of the batch, enforced by the client side timer
+   */
+  void queryTimeout();
+
+  /**
+   * Doubles and floats sent in binary and in text protocol batches are read back unchanged
+   */
+  void doubleBatchRoundTrip();
+
+  /**
+   * Scalar parameters set repeatedly between executions and batch rows, with changes of the parameter type
+   */
+  void scalarParametersUpdate();
+
+  /**
+   * Short and long string parameters and NULLs in batch rows, with rows set with array setters
+   */
+  void stringParametersBatch();
 
 };
 
@@ -1303,5 +1303,402 @@ void resultset::JSON_support()
 }
 
 
+void resultset::fetchColumns()
+{
+  logMsg("resultset::fetchColumns - MySQL_ResultSet::fetchColumns");
+
+  stmt.reset(con->createStatement());
+  stmt->execute("DROP TABLE IF EXISTS test");
+  stmt->execute("CREATE TABLE test(id INT NOT NULL, big BIGINT UNSIGNED, val DOUBLE, txt VARCHAR(32), dt DATE)");
+
+  pstmt.reset(con->prepareStatement("INSERT INTO test(id, big, val, txt, dt) VALUES(?,?,?,?,?)"));
+  for (int32_t i= 1; i <= 20; ++i) {
+    pstmt->setInt(1, i);
+    if (i % 4 == 0) {
+      pstmt->setNull(2, sql::Types::BIGINT);
+      pstmt->setNull(3, sql::Types::DOUBLE);
+      pstmt->setNull(4, sql::Types::VARCHAR);
+      pstmt->setNull(5, sql::Types::DATE);
+    }
+    else {
+      pstmt->setUInt64(2, UL64(18446744073709551615));
+      pstmt->setDouble(3, i + 0.5);
+      pstmt->setString(4, "row" + std::to_string(i));
+      pstmt->setString(5, "2020-01-" + std::string(i < 10 ? "0" : "") + std::to_string(i));
+    }
+    pstmt->executeUpdate();
+  }
+
+  for (int32_t binary= 0; binary < 2; ++binary) {
+    logMsg(binary ? "... PS" : "... Statement");
+    if (binary) {
+      pstmt.reset(con->prepareStatement("SELECT id, big, val, txt, dt FROM test ORDER BY id"));
+      res.reset(pstmt->executeQuery());
+    }
+    else {
+      res.reset(stmt->executeQuery("SELECT id, big, val, txt, dt FROM test ORDER BY id"));
+    }
+
+    sql::ColumnBatch batch;
+    int32_t id= 0;
+    std::size_t fetched;
+
+    while ((fetched= res->fetchColumns(batch, 7)) > 0) {
+      ASSERT(fetched <= 7);
+      ASSERT_EQUALS(5, static_cast<int32_t>(batch.columns.size()));
+      ASSERT_EQUALS(sql::ColumnBatch::INT64, batch.columns[0].kind);
+      ASSERT_EQUALS(sql::ColumnBatch::DOUBLE, batch.columns[2].kind);
+      ASSERT_EQUALS(sql::ColumnBatch::STRING, batch.columns[3].kind);
+
+      for (std::size_t row= 0; row < batch.rows; ++row) {
+        ++id;
+        ASSERT_EQUALS(static_cast<int64_t>(id), batch.columns[0].longs[row]);
+        ASSERT(!batch.columns[0].isNull(row));
+
+        if (id % 4 == 0) {
+          for (std::size_t col= 1; col < batch.columns.size(); ++col) {
+            ASSERT(batch.columns[col].isNull(row));
+          }
+          continue;
+        }
+        std::size_t len;
+        const char* str;
+
+        ASSERT_EQUALS(UL64(18446744073709551615), static_cast<uint64_t>(batch.columns[1].longs[row]));
+        ASSERT_EQUALS(id + 0.5, batch.columns[2].doubles[row]);
+        str= batch.columns[3].getString(row, len);
+        ASSERT_EQUALS("row" + std::to_string(id), std::string(str, len));
+        str= batch.columns[4].getString(row, len);
+        ASSERT_EQUALS(10, static_cast<int32_t>(len));
+      }
+    }
+    ASSERT_EQUALS(20, id);
+  }
+
+  stmt->execute("DROP TABLE IF EXISTS test");
+}
+
+
+void resultset::getStringView()
+{
+  logMsg("resultset::getStringView - MySQL_ResultSet::getStringView");
+
+  stmt.reset(con->createStatement());
+  stmt->execute("DROP TABLE IF EXISTS test");
+  stmt->execute("CREATE TABLE test(id INT, txt VARCHAR(32), val DOUBLE)");
+  stmt->execute("INSERT INTO test(id, txt, val) VALUES(1, 'abc', 1.5), (2, NULL, NULL)");
+
+  for (int32_t binary= 0; binary < 2; ++binary) {
+    logMsg(binary ? "... PS" : "... Statement");
+    if (binary) {
+      pstmt.reset(con->prepareStatement("SELECT id, txt, val FROM test ORDER BY id"));
+      res.reset(pstmt->executeQuery());
+    }
+    else {
+      res.reset(stmt->executeQuery("SELECT id, txt, val FROM test ORDER BY id"));
+    }
+    std::size_t len;
+    const char* str;
+    sql::SQLString buffer("txt:");
+
+    ASSERT(res->next());
+    str= res->getStringView(2, len);
+    ASSERT(str != nullptr);
+    ASSERT_EQUALS("abc", std::string(str, len));
+    str= res->getStringView("id", len);
+    ASSERT_EQUALS("1", std::string(str, len));
+    ASSERT_EQUALS(res->getString(3), sql::SQLString(res->getStringView(3, len), len));
+
+    ASSERT_EQUALS(3, static_cast<int32_t>(res->getString(2, buffer)));
+    ASSERT_EQUALS("txt:abc", buffer);
+
+    ASSERT(res->next());
+    ASSERT(res->getStringView(2, len) == nullptr);
+    ASSERT_EQUALS(0, static_cast<int32_t>(len));
+    ASSERT(res->getStringView(3, len) == nullptr);
+    ASSERT_EQUALS(0, static_cast<int32_t>(res->getString("txt", buffer)));
+    ASSERT(res->wasNull());
+    ASSERT_EQUALS("txt:abc", buffer);
+  }
+
+  stmt->execute("DROP TABLE IF EXISTS test");
+}
+
+void resultset::getStringTemporal()
+{
+  logMsg("resultset::getStringTemporal - MySQL_ResultSet::getString");
+
+  stmt.reset(con->createStatement());
+  stmt->execute("DROP TABLE IF EXISTS test");
+  stmt->execute("CREATE TABLE test(id INT, dt DATETIME, d DATE, t TIME)");
+  stmt->execute("INSERT INTO test VALUES(1, '2020-01-02 03:04:05', '2020-01-02', '-838:59:59'), (2, '0000-00-00 00:00:00', '1999-12-31', '10:11:12')");
+
+  res.reset(stmt->executeQuery("SELECT dt, d, t FROM test ORDER BY id"));
+
+  ASSERT(res->next());
+  ASSERT_EQUALS("2020-01-02 03:04:05", res->getString(1));
+  ASSERT_EQUALS("2020-01-02", res->getString(2));
+  ASSERT_EQUALS("-838:59:59", res->getString(3));
+
+  ASSERT(res->next());
+  ASSERT_EQUALS("1999-12-31", res->getString(2));
+  ASSERT_EQUALS("10:11:12", res->getString(3));
+
+  stmt->execute("DROP TABLE IF EXISTS test");
+}
+
+
+void resultset::findColumn()
+{
+  logMsg("resultset::findColumn - MySQL_ResultSet::findColumn");
+
+  stmt.reset(con->createStatement());
+  stmt->execute("DROP TABLE IF EXISTS test");
+  stmt->execute("CREATE TABLE test(id INT, txt VARCHAR(32))");
+  stmt->execute("INSERT INTO test(id, txt) VALUES(1, 'abc')");
+
+  for (int32_t binary= 0; binary < 2; ++binary) {
+    logMsg(binary ? "... PS" : "... Statement");
+    // Repeated execution of the same PS has to give the same results, since the index is shared
+    for (int32_t i= 0; i < 1 + binary; ++i) {
+      if (binary) {
+        pstmt.reset(con->prepareStatement("SELECT txt AS Id, id AS num FROM test t"));
+        res.reset(pstmt->executeQuery());
+      }
+      else {
+        res.reset(stmt->executeQuery("SELECT txt AS Id, id AS num FROM test t"));
+      }
+      ASSERT(res->next());
+      // Alias wins over the original name
+      ASSERT_EQUALS(1, res->findColumn("id"));
+      ASSERT_EQUALS(1, res->findColumn("ID"));
+      ASSERT_EQUALS(1, res->findColumn("T.iD"));
+      ASSERT_EQUALS(2, res->findColumn("Num"));
+      ASSERT_EQUALS(2, res->findColumn("t.NUM"));
+      ASSERT_EQUALS(1, res->findColumn("TXT"));
+      ASSERT_EQUALS(1, res->findColumn("test.txt"));
+      ASSERT_EQUALS("abc", res->getString("iD"));
+      ASSERT_EQUALS(1, res->getInt("NUM"));
+
+      try {
+        res->findColumn("nosuchcolumn");
+        FAIL("Exception was expected for the unknown column");
+      }
+      catch (sql::SQLException&) {
+      }
+    }
+  }
+
+  stmt->execute("DROP TABLE IF EXISTS test");
+}
+
+void resultset::streamingReadAhead()
+{
+  logMsg("resultset::streamingReadAhead - MySQL_ResultSet::next with fetch size");
+
+  const int32_t rowCount= 100;
+  sql::SQLString insert("INSERT INTO test(id, txt, dt) VALUES");
+  for (int32_t i= 0; i < rowCount; ++i) {
+    insert.append(i > 0 ? "," : "").append("(" + std::to_string(i) + ",");
+    insert.append(i % 5 == 0 ? sql::SQLString("NULL") : "'row" + std::to_string(i) + "'");
+    insert.append(", '2020-01-02 03:04:05')");
+  }
+
+  for (int32_t readAhead= 0; readAhead < 2; ++readAhead) {
+    sql::ConnectOptionsMap opts;
+    opts["useReadAhead"]= readAhead ? "true" : "false";
+
+    created_objects.clear();
+    con.reset(getConnection(&opts));
+    con->setSchema(db);
+
+    stmt.reset(con->createStatement());
+    stmt->execute("DROP TABLE IF EXISTS test");
+    stmt->execute("CREATE TABLE test(id INT, txt VARCHAR(32), dt DATETIME)");
+    stmt->execute(insert);
+
+    for (int32_t binary= 0; binary < 2; ++binary) {
+      logMsg(std::string(readAhead ? "... read-ahead" : "... no read-ahead") + (binary ? ", PS" : ", Statement"));
+      if (binary) {
+        pstmt.reset(con->prepareStatement("SELECT id, txt, dt FROM test ORDER BY id"));
+        pstmt->setFetchSize(7);
+        res.reset(pstmt->executeQuery());
+      }
+      else {
+        stmt->setFetchSize(7);
+        res.reset(stmt->executeQuery("SELECT id, txt, dt FROM test ORDER BY id"));
+      }
+
+      for (int32_t i= 0; i < rowCount; ++i) {
+        ASSERT(res->next());
+        // isLast() reads rows following the current one, that must stay readable
+        if (i % 10 == 3 || i == rowCount - 1) {
+          ASSERT(res->isLast() == (i == rowCount - 1));
+        }
+        ASSERT_EQUALS(i, res->getInt(1));
+        if (i % 5 == 0) {
+          res->getString(2);
+          ASSERT(res->wasNull());
+        }
+        else {
+          ASSERT_EQUALS("row" + std::to_string(i), res->getString("txt"));
+        }
+        ASSERT_EQUALS("2020-01-02 03:04:05", res->getString(3));
+      }
+      ASSERT(!res->next());
+      res->close();
+
+      // Closing in the middle of the result, and using the connection while the result is being streamed
+      res.reset(binary ? pstmt->executeQuery() : stmt->executeQuery("SELECT id, txt, dt FROM test ORDER BY id"));
+      ASSERT(res->next());
+      res->close();
+
+      res.reset(binary ? pstmt->executeQuery() : stmt->executeQuery("SELECT id, txt, dt FROM test ORDER BY id"));
+      ASSERT(res->next());
+      ASSERT(res->next());
+      ASSERT_EQUALS(1, res->getInt(1));
+      std::unique_ptr<sql::Statement> stmt2(con->createStatement());
+      std::unique_ptr<sql::ResultSet> res2(stmt2->executeQuery("SELECT 42"));
+      ASSERT(res2->next());
+      ASSERT_EQUALS(42, res2->getInt(1));
+      for (int32_t i= 2; i < rowCount; ++i) {
+        ASSERT(res->next());
+        ASSERT_EQUALS(i, res->getInt(1));
+      }
+      ASSERT(!res->next());
+      stmt->setFetchSize(0);
+    }
+    stmt->execute("DROP TABLE IF EXISTS test");
+  }
+}
+
+void resultset::scrollableMemoryLimit()
+{
+  logMsg("resultset::scrollableMemoryLimit - MySQL_ResultSet scrolling with resultSetMemoryLimit");
+
+  const int32_t rowCount= 2000;
+  sql::ConnectOptionsMap opts;
+  opts["resultSetMemoryLimit"]= "1";
+
+  created_objects.clear();
+  con.reset(getConnection(&opts));
+  con->setSchema(db);
+
+  stmt.reset(con->createStatement());
+  stmt->execute("DROP TABLE IF EXISTS test");
+  stmt->execute("CREATE TABLE test(id INT, txt VARCHAR(64), dt DATETIME)");
+
+  sql::SQLString insert("INSERT INTO test(id, txt, dt) VALUES");
+  for (int32_t i= 0; i < rowCount; ++i) {
+    insert.append(i > 0 ? "," : "").append("(" + std::to_string(i) + ",");
+    insert.append(i % 7 == 0 ? sql::SQLString("NULL") : "'row" + std::to_string(i) + "'");
+    insert.append(", '2020-01-02 03:04:05')");
+  }
+  stmt->execute(insert);
+
+  for (int32_t binary= 0; binary < 2; ++binary) {
+    logMsg(binary ? "... PS" : "... Statement");
+    if (binary) {
+      pstmt.reset(con->prepareStatement("SELECT id, txt, dt FROM test ORDER BY id", sql::ResultSet::TYPE_SCROLL_INSENSITIVE,
+        sql::ResultSet::CONCUR_READ_ONLY));
+      res.reset(pstmt->executeQuery());
+    }
+    else {
+      std::unique_ptr<sql::Statement> scrollStmt(con->createStatement(sql::ResultSet::TYPE_SCROLL_INSENSITIVE,
+        sql::ResultSet::CONCUR_READ_ONLY));
+      res.reset(scrollStmt->executeQuery("SELECT id, txt, dt FROM test ORDER BY id"));
+    }
+
+    for (int32_t i= 0; i < rowCount; ++i) {
+      ASSERT(res->next());
+      ASSERT_EQUALS(i, res->getInt(1));
+    }
+    ASSERT(!res->next());
+    ASSERT_EQUALS(rowCount, static_cast<int32_t>(res->rowsCount()));
+
+    ASSERT(res->last());
+    ASSERT_EQUALS(rowCount - 1, res->getInt(1));
+    ASSERT_EQUALS("row" + std::to_string(rowCount - 1), res->getString(2));
+    ASSERT_EQUALS("2020-01-02 03:04:05", res->getString(3));
+
+    ASSERT(res->previous());
+    ASSERT_EQUALS(rowCount - 2, res->getInt(1));
+
+    // Row 1995 has NULL
+    ASSERT(res->absolute(1996));
+    ASSERT_EQUALS(1995, res->getInt(1));
+    res->getString(2);
+    ASSERT(res->wasNull());
+
+    ASSERT(res->relative(-1994));
+    ASSERT_EQUALS(1, res->getInt(1));
+    ASSERT_EQUALS("row1", res->getString(2));
+
+    ASSERT(res->first());
+    ASSERT_EQUALS(0, res->getInt(1));
+
+    ASSERT(res->absolute(-1));
+    ASSERT_EQUALS(rowCount - 1, res->getInt(1));
+    res->close();
+  }
+
+  stmt->execute("DROP TABLE IF EXISTS test");
+}
+
+
+void resultset::numericGetters()
+{
+  logMsg("resultset::numericGetters - MySQL_ResultSet::getInt/getLong/getDouble");
+
+  stmt.reset(con->createStatement());
+  stmt->execute("DROP TABLE IF EXISTS test");
+  stmt->execute("CREATE TABLE test(ti TINYINT, uti TINYINT UNSIGNED, si SMALLINT, mi MEDIUMINT, i INT, ui INT UNSIGNED,"
+    "bi BIGINT, ubi BIGINT UNSIGNED, f FLOAT, d DOUBLE, dc DECIMAL(10,3), vc VARCHAR(32))");
+  stmt->execute("INSERT INTO test VALUES(-128, 255, -32768, -8388608, -2147483648, 4294967295, -9223372036854775807,"
+    "18446744073709551615, 1.5, -2.25, -12345.678, '42')");
+
+  for (int32_t binary= 0; binary < 2; ++binary) {
+    logMsg(binary ? "... PS" : "... Statement");
+    if (binary) {
+      pstmt.reset(con->prepareStatement("SELECT * FROM test"));
+      res.reset(pstmt->executeQuery());
+    }
+    else {
+      res.reset(stmt->executeQuery("SELECT * FROM test"));
+    }
+    ASSERT(res->next());
+
+    ASSERT_EQUALS(-128, res->getInt(1));
+    ASSERT_EQUALS(static_cast<int64_t>(-128), res->getLong(1));
+    ASSERT_EQUALS(255, res->getInt(2));
+    ASSERT_EQUALS(-32768, res->getInt(3));
+    ASSERT_EQUALS(static_cast<long double>(-32768), res->getDouble(3));
+    ASSERT_EQUALS(-8388608, res->getInt(4));
+    ASSERT_EQUALS(INT32_MIN, res->getInt(5));
+    ASSERT_EQUALS(static_cast<int64_t>(INT32_MIN), res->getLong(5));
+    ASSERT_EQUALS(static_cast<int64_t>(UINT32_MAX), res->getLong(6));
+    ASSERT_EQUALS(static_cast<long double>(UINT32_MAX), res->getDouble(6));
+    try {
+      res->getInt(6);
+      FAIL("Out of range value should cause exception");
+    }
+    catch (sql::SQLException&) {
+    }
+    ASSERT_EQUALS(-INT64_MAX, res->getLong(7));
+    ASSERT_EQUALS(static_cast<long double>(-INT64_MAX), res->getDouble(7));
+    ASSERT_EQUALS(UINT64_MAX, res->getUInt64(8));
+    ASSERT_EQUALS(static_cast<long double>(UINT64_MAX), res->getDouble(8));
+    ASSERT_EQUALS(1.5L, res->getDouble(9));
+    ASSERT_EQUALS(-2.25L, res->getDouble(10));
+    ASSERT_EQUALS(static_cast<int64_t>(-2), res->getLong(10));
+    ASSERT(std::abs(res->getDouble(11) + 12345.678L) < 0.0001L);
+    ASSERT_EQUALS(42, res->getInt(12));
+    ASSERT_EQUALS(static_cast<long double>(42), res->getDouble(12));
+    res->close();
+  }
+
+  stmt->execute("DROP TABLE IF EXISTS test");
+}
+
 } /* namespace resultset */
 } /* namespace testsuite */
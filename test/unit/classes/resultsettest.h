@@ -63,6 +63,13 @@ public:
     TEST_CASE(getResultSetType);
     TEST_CASE(getTypesMinorIssues);
     TEST_CASE(JSON_support);
+    TEST_CASE(fetchColumns);
+    TEST_CASE(getStringView);
+    TEST_CASE(getStringTemporal);
+    TEST_CASE(findColumn);
+    TEST_CASE(streamingReadAhead);
+    TEST_CASE(scrollableMemoryLimit);
+    TEST_CASE(numericGetters);
 
 #ifdef INCLUDE_NOT_IMPLEMENTED_METHODS
     TEST_CASE(notImplemented);
@@ -123,6 +130,42 @@ public:
    */
   void JSON_support();
 
+  /**
+   * Test for resultset::fetchColumns()
+   *
+   * Columnar fetch of the rows blocks, text and binary protocol
+   */
+  void fetchColumns();
+
+  /**
+   * Test for resultset::getStringView() and resultset::getString() appending to the buffer
+   */
+  void getStringView();
+
+  /**
+   * Test for resultset::getString() on temporal columns with text protocol
+   */
+  void getStringTemporal();
+
+  /**
+   * Test for resultset::findColumn() with aliases, original names and table prefixes in different case
+   */
+  void findColumn();
+
+  /**
+   * Test for streaming result set(fetch size > 0) with and without useReadAhead
+   */
+  void streamingReadAhead();
+
+  /**
+   * Test for scrollable result set with resultSetMemoryLimit - rows exceeding the limit are stored in temporary file
+   */
+  void scrollableMemoryLimit();
+
+  /**
+   * Test for getInt/getLong/getDouble on columns of different numeric and string types, signed and unsigned
+   */
+  void numericGetters();
 
 };
 